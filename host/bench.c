@@ -0,0 +1,153 @@
+/**
+ * @file bench.c
+ * @brief Host micro-benchmark for the protocol/decoder/commands core
+ *
+ * Feeds representative main/extra/optional frames through
+ * protocol_process_received_data() and calls the set_*() command builders,
+ * reporting time and heap allocations per operation.
+ *
+ * Usage: hp_bench [iterations]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "protocol.h"
+#include "commands.h"
+#include "modbus_params.h"
+#include "esp_log.h"
+#include "host_components.h"
+#include "hp_frames.h"
+
+#define BENCH_DEFAULT_ITERATIONS 200000
+#define BENCH_VARIANTS 64
+
+// Heap calls made by the code under test (linked with --wrap=malloc,...)
+static unsigned long bench_allocs = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    bench_allocs++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    bench_allocs++;
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    bench_allocs++;
+    return __real_realloc(ptr, size);
+}
+
+typedef struct {
+    uint8_t data[PROTOCOL_MAX_DATA_SIZE];
+    size_t len;
+} bench_frame_t;
+
+static bench_frame_t main_frames[BENCH_VARIANTS];
+static bench_frame_t main_frames_flipped[2];
+static bench_frame_t extra_frames[BENCH_VARIANTS];
+static bench_frame_t opt_frames[BENCH_VARIANTS];
+
+static int64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void bench_report(const char *name, unsigned long iterations, int64_t elapsed_ns,
+                         unsigned long allocs, uint32_t publishes) {
+    printf("%-26s %10lu %12.1f %10.3f %12.3f\n", name, iterations,
+           (double)elapsed_ns / (double)iterations,
+           (double)allocs / (double)iterations,
+           (double)publishes / (double)iterations);
+}
+
+static void bench_frames(const char *name, const bench_frame_t *frames, size_t count, unsigned long iterations) {
+    // Warm up the previous-frame cache with the last frame of the set
+    protocol_process_received_data(frames[count - 1].data, frames[count - 1].len);
+
+    uint32_t publishes = host_component_stats.mqtt_publish;
+    unsigned long allocs = bench_allocs;
+    int64_t start = bench_now_ns();
+    for (unsigned long i = 0; i < iterations; i++) {
+        const bench_frame_t *frame = &frames[i % count];
+        if (protocol_process_received_data(frame->data, frame->len) != ESP_OK) {
+            fprintf(stderr, "%s: frame %lu rejected\n", name, i);
+            exit(1);
+        }
+    }
+    int64_t elapsed = bench_now_ns() - start;
+    bench_report(name, iterations, elapsed, bench_allocs - allocs, host_component_stats.mqtt_publish - publishes);
+}
+
+static void bench_commands(unsigned long iterations) {
+    unsigned long allocs = bench_allocs;
+    int64_t start = bench_now_ns();
+    for (unsigned long i = 0; i < iterations; i++) {
+        int8_t temperature = (int8_t)(20 + (i & 15));
+        switch (i % 8) {
+            case 0: set_heatpump_state(i & 1); break;
+            case 1: set_z1_heat_request_temperature(temperature); break;
+            case 2: set_DHW_temp((int8_t)(40 + (i & 7))); break;
+            case 3: set_operation_mode((uint8_t)(i % 7)); break;
+            case 4: set_quiet_mode((uint8_t)(i % 4)); break;
+            case 5: set_floor_heat_delta((int8_t)(3 + (i & 3))); break;
+            case 6: set_z1_water_temp((float)temperature + 0.5f); break;
+            case 7: set_pool_temp((float)temperature); break;
+        }
+        // Nobody drains the queue on the host
+        xQueueReset(g_protocol_ctx.command_queue);
+    }
+    int64_t elapsed = bench_now_ns() - start;
+    bench_report("set_*() command builders", iterations, elapsed, bench_allocs - allocs, 0);
+}
+
+int main(int argc, char **argv) {
+    unsigned long iterations = BENCH_DEFAULT_ITERATIONS;
+    if (argc > 1) {
+        iterations = strtoul(argv[1], NULL, 10);
+        if (iterations == 0) {
+            fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (protocol_init() != ESP_OK) {
+        fprintf(stderr, "protocol_init failed\n");
+        return 1;
+    }
+
+    for (uint32_t v = 0; v < BENCH_VARIANTS; v++) {
+        main_frames[v].len = hp_frame_main(main_frames[v].data, v);
+        extra_frames[v].len = hp_frame_extra(extra_frames[v].data, v);
+        opt_frames[v].len = hp_frame_opt(opt_frames[v].data, v);
+    }
+    // Worst case: every payload byte differs from the previous frame
+    for (size_t f = 0; f < 2; f++) {
+        main_frames_flipped[f] = main_frames[0];
+        for (size_t i = 4; i < main_frames_flipped[f].len - 1; i++) {
+            main_frames_flipped[f].data[i] = (uint8_t)(main_frames_flipped[f].data[i] + f);
+        }
+        hp_frame_seal(main_frames_flipped[f].data, main_frames_flipped[f].len);
+    }
+
+    // Publish path enabled, like a connected unit
+    host_mqtt_connected = true;
+    mb_holding_registers[MB_HOLDING_SET_MQTT_PUBLISH - MB_REG_HOLDING_START] = 1;
+
+    printf("%-26s %10s %12s %10s %12s\n", "case", "iterations", "ns/op", "allocs/op", "publish/op");
+    bench_frames("main frame, all changed", main_frames_flipped, 2, iterations);
+    bench_frames("main frame, typical", main_frames, BENCH_VARIANTS, iterations);
+    bench_frames("main frame, unchanged", main_frames, 1, iterations);
+    bench_frames("extra frame, typical", extra_frames, BENCH_VARIANTS, iterations);
+    bench_frames("opt frame, typical", opt_frames, BENCH_VARIANTS, iterations);
+    bench_commands(iterations);
+    return 0;
+}
@@ -0,0 +1,122 @@
+/**
+ * @file hp_frames.c
+ * @brief Representative heat pump response frames for host tools
+ *
+ * Values decode to a running heat pump in heating mode: water 30/35 °C,
+ * outside 5 °C, compressor 45 Hz. Variants move the sensor bytes that change
+ * between consecutive polls on a real unit.
+ */
+
+#include <string.h>
+#include "hp_frames.h"
+#include "protocol.h"
+
+void hp_frame_seal(uint8_t *buf, size_t size) {
+    uint8_t sum = 0;
+    for (size_t i = 0; i < size - 1; i++) {
+        sum += buf[i];
+    }
+    buf[size - 1] = (uint8_t)(0 - sum);
+}
+
+size_t hp_frame_main(uint8_t *buf, uint32_t variant) {
+    const size_t size = PROTOCOL_MAIN_DATA_SIZE;
+
+    memset(buf, 0, size);
+    buf[0] = PROTOCOL_PKT_READ;
+    buf[1] = (uint8_t)(size - PROTOCOL_FRAME_OVERHEAD);
+    buf[2] = 0x01;
+    buf[3] = PROTOCOL_DATA_MAIN;
+
+    // Temperatures and deltas are stored as value + 128
+    memset(&buf[38], 128, 8);       // Zone requests, DHW target, shifts
+    memset(&buf[59], 128, 42);      // Buffer/solar/bivalent settings, curves, deltas
+    memset(&buf[139], 128, 24);     // Sensor temperatures
+    // Everything else that is "value + 1"
+    memset(&buf[101], 1, 17);
+    memset(&buf[163], 1, 36);
+
+    buf[4] = 0x56;                  // Heat pump on, force DHW off
+    buf[5] = 0x55;                  // Schedules and holiday off
+    buf[6] = 0x52;                  // Zone 1, heat mode
+    buf[7] = 0x49;                  // Quiet/powerful off
+    buf[9] = 0x55;                  // Heaters off
+    buf[20] = 0x56;                 // Liquid type, optional PCB
+    buf[22] = 0x11;                 // Zone sensor settings
+    buf[23] = 0x55;                 // External controls off
+    buf[24] = 0x56;                 // DHW installed
+    buf[26] = 0x55;
+    buf[28] = 0x55;
+    buf[42] = 128 + 48;             // DHW target 48 °C
+    buf[111] = 0x55;                // 3-way valve room, no defrost
+    buf[112] = 0x55;
+    buf[113] = 0x00;                // No error
+    buf[116] = 0x55;
+    buf[117] = 0x55;
+    buf[118] = 0x12;                // Inlet/outlet fractions
+    buf[199] = 3;                   // Unit answers the extra (power) block
+
+    // Model code
+    static const uint8_t model[10] = {0xE2, 0xCF, 0x0B, 0x13, 0x33, 0x32, 0xD1, 0x0C, 0x16, 0x33};
+    memcpy(&buf[129], model, sizeof(model));
+
+    // Sensor readings that drift between polls
+    uint32_t v = variant;
+    buf[118] = (uint8_t)(0x12 + ((v >> 1) & 0x09));
+    buf[141] = (uint8_t)(128 + 46 + ((v >> 4) & 1));     // DHW temperature
+    buf[142] = (uint8_t)(128 + 5 - ((v >> 5) & 1));      // Outside
+    buf[143] = (uint8_t)(128 + 30 + ((v >> 2) & 1));     // Inlet
+    buf[144] = (uint8_t)(128 + 35 + ((v >> 3) & 1));     // Outlet
+    buf[158] = (uint8_t)(128 + 2 - ((v >> 5) & 1));      // Outside pipe
+    buf[166] = (uint8_t)(1 + 45 + (v & 3));              // Compressor Hz
+    buf[169] = (uint8_t)(1 + ((v * 37) & 0xFF));         // Flow fraction
+    buf[170] = 15;                                       // Flow l/min
+    buf[171] = (uint8_t)(1 + 80 + (v & 1));              // Pump speed / 50
+    buf[172] = (uint8_t)(1 + 60 + (v & 1));              // Pump duty
+    buf[179] = (uint8_t)(1 + (v >> 6));                  // Operations counter
+    buf[182] = (uint8_t)(1 + (v >> 7));                  // Operations hours
+    buf[193] = (uint8_t)(1 + 6 + ((v >> 1) & 1));        // Heat consumption / 200 W
+    buf[194] = (uint8_t)(1 + 22 + ((v >> 1) & 3));       // Heat production / 200 W
+
+    hp_frame_seal(buf, size);
+    return size;
+}
+
+size_t hp_frame_extra(uint8_t *buf, uint32_t variant) {
+    const size_t size = PROTOCOL_EXTRA_DATA_SIZE;
+
+    memset(buf, 0, size);
+    buf[0] = PROTOCOL_PKT_READ;
+    buf[1] = (uint8_t)(size - PROTOCOL_FRAME_OVERHEAD);
+    buf[2] = 0x01;
+    buf[3] = PROTOCOL_DATA_EXTRA;
+
+    // Power in watts + 1, little endian
+    uint16_t consumption = (uint16_t)(1 + 1300 + (variant & 0x3F));
+    uint16_t production = (uint16_t)(1 + 4500 + ((variant * 7) & 0xFF));
+    buf[14] = (uint8_t)consumption;
+    buf[15] = (uint8_t)(consumption >> 8);
+    buf[16] = 1;
+    buf[18] = 1;
+    buf[20] = (uint8_t)production;
+    buf[21] = (uint8_t)(production >> 8);
+    buf[22] = 1;
+    buf[24] = 1;
+
+    hp_frame_seal(buf, size);
+    return size;
+}
+
+size_t hp_frame_opt(uint8_t *buf, uint32_t variant) {
+    const size_t size = PROTOCOL_OPT_DATA_SIZE;
+
+    memset(buf, 0, size);
+    buf[0] = PROTOCOL_PKT_READ;
+    buf[1] = (uint8_t)(size - PROTOCOL_FRAME_OVERHEAD);
+    buf[2] = 0x01;
+    buf[3] = PROTOCOL_DATA_OPT;
+    buf[4] = (variant & 0x10) ? 0x80 : 0x00;   // Zone 1 water pump
+
+    hp_frame_seal(buf, size);
+    return size;
+}
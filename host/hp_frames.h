@@ -0,0 +1,44 @@
+/**
+ * @file hp_frames.h
+ * @brief Representative heat pump response frames for host tools
+ */
+
+#ifndef HP_FRAMES_H
+#define HP_FRAMES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Build a 203-byte main data frame
+ * Variants differ in a handful of sensor bytes, like consecutive real frames
+ * @param buf Output buffer, at least PROTOCOL_MAIN_DATA_SIZE bytes
+ * @param variant Sensor reading set
+ * @return Frame size
+ */
+size_t hp_frame_main(uint8_t *buf, uint32_t variant);
+
+/**
+ * @brief Build a 110-byte extra data frame
+ */
+size_t hp_frame_extra(uint8_t *buf, uint32_t variant);
+
+/**
+ * @brief Build a 20-byte optional PCB data frame
+ */
+size_t hp_frame_opt(uint8_t *buf, uint32_t variant);
+
+/**
+ * @brief Set the last byte so that all bytes of the frame sum to zero
+ */
+void hp_frame_seal(uint8_t *buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HP_FRAMES_H
@@ -0,0 +1,360 @@
+/**
+ * @file hp_loadtest.c
+ * @brief End-to-end load test: firmware protocol core against the simulator
+ *
+ * Runs the real protocol task over a PTY pair served by the virtual heat
+ * pump, then measures
+ *  - polling throughput: main blocks decoded per second and line usage,
+ *  - write-to-readback latency: from set_*() until the Modbus input
+ *    registers show the new value (the write reply or a later poll).
+ * Each write round sends two commands (zone 1 heat request and DHW target)
+ * that the protocol task merges into one frame. The optional PCB is enabled
+ * so extra and opt blocks are polled too; each opt round switches the
+ * compressor off and straight back on, which must reach the unit as two
+ * frames since both commands set the same bit.
+ *
+ * Usage: hp_loadtest [-b baud] [-d reply_delay_ms] [-n noise%] [-t truncate%]
+ *                    [-c crc_error%] [-s silence%] [-S seed]
+ *                    [-p poll_seconds] [-w write_rounds] [-O opt_rounds]
+ *                    [-o capture] [-v]
+ *
+ * -o saves the frame capture ring at the end, in the /capture format, for
+ * hp_replay.
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "protocol.h"
+#include "commands.h"
+#include "modbus_params.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "driver/uart.h"
+#include "frame_capture.h"
+#include "hp_sim.h"
+
+#define LOADTEST_READBACK_TIMEOUT_MS    (PROTOCOL_READ_TIMEOUT_MS * 4 + 1000)
+#define LOADTEST_STARTUP_TIMEOUT_MS     10000
+#define LOADTEST_OPT_BYTE_6             6
+#define LOADTEST_OPT_COMPRESSOR_BIT     0x40
+
+static hp_sim_t loadtest_sim;
+static int loadtest_sim_fd = -1;
+static volatile bool loadtest_stop = false;
+
+static void *loadtest_sim_thread(void *arg) {
+    (void)arg;
+    if (hp_sim_serve(&loadtest_sim, loadtest_sim_fd, &loadtest_stop) != 0) {
+        fprintf(stderr, "simulator: serve failed\n");
+    }
+    return NULL;
+}
+
+static int16_t loadtest_input(uint16_t reg) {
+    int16_t value = 0;
+    modbus_params_read_inputs(&value, reg, 1);
+    return value;
+}
+
+static void loadtest_sleep_ms(uint32_t ms) {
+    struct timespec ts = { .tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000 };
+    nanosleep(&ts, NULL);
+}
+
+/**
+ * @brief Wait until both registers hold the expected values
+ * @return Elapsed microseconds, -1 on timeout
+ */
+static int64_t loadtest_wait_readback(int64_t start_us, uint16_t reg_a, int16_t value_a,
+                                      uint16_t reg_b, int16_t value_b) {
+    while (esp_timer_get_time() - start_us < (int64_t)LOADTEST_READBACK_TIMEOUT_MS * 1000) {
+        if (loadtest_input(reg_a) == value_a && loadtest_input(reg_b) == value_b) {
+            return esp_timer_get_time() - start_us;
+        }
+        loadtest_sleep_ms(1);
+    }
+    return -1;
+}
+
+/**
+ * @brief Wait until the simulator's optional PCB state shows the compressor bit
+ * @return Elapsed microseconds, -1 on timeout
+ */
+static int64_t loadtest_wait_opt(int64_t start_us, bool compressor) {
+    while (esp_timer_get_time() - start_us < (int64_t)LOADTEST_READBACK_TIMEOUT_MS * 1000) {
+        uint8_t byte6 = __atomic_load_n(&loadtest_sim.opt_state[LOADTEST_OPT_BYTE_6], __ATOMIC_RELAXED);
+        if (((byte6 & LOADTEST_OPT_COMPRESSOR_BIT) != 0) == compressor) {
+            return esp_timer_get_time() - start_us;
+        }
+        loadtest_sleep_ms(1);
+    }
+    return -1;
+}
+
+static int loadtest_compare(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a;
+    int64_t y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void loadtest_usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-b baud] [-d reply_delay_ms] [-n noise%%] [-t truncate%%]\n"
+            "          [-c crc_error%%] [-s silence%%] [-S seed]\n"
+            "          [-p poll_seconds] [-w write_rounds] [-O opt_rounds]\n"
+            "          [-o capture] [-v]\n"
+            "  -b  simulated line rate, 0 = unpaced (default 9600)\n"
+            "  -v  show protocol warnings and errors (bad frames, timeouts)\n", name);
+}
+
+static int loadtest_save_capture(const char *path) {
+    frame_capture_snapshot_t *snapshot;
+    frame_capture_file_header_t header;
+    if (frame_capture_snapshot_take(&snapshot, &header) != ESP_OK) {
+        return -1;
+    }
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        frame_capture_snapshot_free(snapshot);
+        return -1;
+    }
+    fwrite(&header, sizeof(header), 1, f);
+    frame_capture_record_t record;
+    const uint8_t *data;
+    while (frame_capture_snapshot_next(snapshot, &record, &data)) {
+        fwrite(&record, sizeof(record), 1, f);
+        fwrite(data, 1, record.len, f);
+    }
+    frame_capture_snapshot_free(snapshot);
+    printf("capture: %u records (%u dropped) saved to %s\n", header.count, header.dropped, path);
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+static void loadtest_polling(uint32_t seconds) {
+    protocol_stats_t before, after;
+    hp_sim_stats_t sim_before = loadtest_sim.stats;
+    protocol_get_stats(&before);
+    int64_t start = esp_timer_get_time();
+
+    loadtest_sleep_ms(seconds * 1000);
+
+    protocol_get_stats(&after);
+    hp_sim_stats_t sim_after = loadtest_sim.stats;
+    double elapsed = (double)(esp_timer_get_time() - start) / 1e6;
+    uint64_t bytes = (sim_after.rx_bytes - sim_before.rx_bytes) + (sim_after.tx_bytes - sim_before.tx_bytes);
+
+    printf("polling, %u s:\n", seconds);
+    printf("  polls sent        %10.1f /s\n", (after.poll_count - before.poll_count) / elapsed);
+    printf("  main blocks       %10.1f /s\n", (sim_after.main - sim_before.main) / elapsed);
+    printf("  extra blocks      %10.1f /s\n", (sim_after.extra - sim_before.extra) / elapsed);
+    printf("  opt blocks        %10.1f /s\n", (sim_after.opt - sim_before.opt) / elapsed);
+    printf("  unchanged frames  %10u\n", after.frames_unchanged - before.frames_unchanged);
+    printf("  rx errors         %10u (timeout %u, incomplete %u, checksum %u)\n",
+           (after.rx_timeouts + after.rx_incomplete + after.rx_bad_size + after.rx_bad_header + after.rx_bad_checksum) -
+               (before.rx_timeouts + before.rx_incomplete + before.rx_bad_size + before.rx_bad_header + before.rx_bad_checksum),
+           after.rx_timeouts - before.rx_timeouts, after.rx_incomplete - before.rx_incomplete,
+           after.rx_bad_checksum - before.rx_bad_checksum);
+    const metrics_hist_t *main_rt = &after.response_time[PROTOCOL_BLOCK_MAIN];
+    if (main_rt->count > 0) {
+        printf("  main response     %10.2f ms avg (all polls since start)\n",
+               (double)main_rt->sum_us / main_rt->count / 1000.0);
+    }
+    if (loadtest_sim.options.baud > 0) {
+        // Half duplex: requests and replies share the line
+        printf("  line usage        %10.1f %%\n",
+               100.0 * (double)bytes * 11 / loadtest_sim.options.baud / elapsed);
+    }
+}
+
+static void loadtest_writes(uint32_t rounds) {
+    int64_t *latency = calloc(rounds, sizeof(*latency));
+    uint32_t done = 0;
+    uint32_t timeouts = 0;
+    protocol_stats_t before, after;
+    protocol_get_stats(&before);
+
+    for (uint32_t i = 0; i < rounds; i++) {
+        // Always differ from the current value so the readback is unambiguous
+        int8_t z1 = (int8_t)(20 + (i % 10));
+        int8_t dhw = (int8_t)(45 + (i % 8));
+        if (loadtest_input(MB_INPUT_Z1_HEAT_REQUEST_TEMP) == z1) {
+            z1++;
+        }
+        if (loadtest_input(MB_INPUT_DHW_TARGET_TEMP) == dhw) {
+            dhw++;
+        }
+
+        int64_t start = esp_timer_get_time();
+        set_z1_heat_request_temperature(z1);
+        set_DHW_temp(dhw);
+        int64_t us = loadtest_wait_readback(start, MB_INPUT_Z1_HEAT_REQUEST_TEMP, z1,
+                                            MB_INPUT_DHW_TARGET_TEMP, dhw);
+        if (us < 0) {
+            timeouts++;
+        } else {
+            latency[done++] = us;
+        }
+        // Let a poll or two interleave, like sporadic Modbus/MQTT writes
+        loadtest_sleep_ms((uint32_t)(i * 37) % 200);
+    }
+    protocol_get_stats(&after);
+
+    printf("writes, %u rounds of 2 commands:\n", rounds);
+    printf("  frames sent       %10u (merged %u)\n", after.write_count - before.write_count,
+           after.write_merged - before.write_merged);
+    if (after.write_count > before.write_count) {
+        printf("  queue to UART     %10.1f ms avg, %.1f ms max\n",
+               (double)(after.write_latency_total_us - before.write_latency_total_us) /
+                   (after.write_count - before.write_count) / 1000.0,
+               (double)after.write_latency_max_us / 1000.0);
+    }
+    if (done > 0) {
+        int64_t total = 0;
+        qsort(latency, done, sizeof(*latency), loadtest_compare);
+        for (uint32_t i = 0; i < done; i++) {
+            total += latency[i];
+        }
+        printf("  write to readback %10.1f ms avg, p50 %.1f, p95 %.1f, max %.1f\n",
+               (double)total / done / 1000.0,
+               (double)latency[done / 2] / 1000.0,
+               (double)latency[(done * 95) / 100 < done ? (done * 95) / 100 : done - 1] / 1000.0,
+               (double)latency[done - 1] / 1000.0);
+    }
+    printf("  readback timeouts %10u\n", timeouts);
+    free(latency);
+}
+
+static void loadtest_opt_writes(uint32_t rounds) {
+    uint32_t timeouts = 0;
+    int64_t total_us = 0;
+    int64_t max_us = 0;
+    uint32_t done = 0;
+    protocol_stats_t before, after;
+    hp_sim_stats_t sim_before = loadtest_sim.stats;
+    protocol_get_stats(&before);
+
+    for (uint32_t i = 0; i < rounds; i++) {
+        // The second command restores the template bit the first one cleared
+        int64_t start = esp_timer_get_time();
+        set_compressor_state(false);
+        set_compressor_state(true);
+        int64_t off_us = loadtest_wait_opt(start, false);
+        int64_t on_us = off_us < 0 ? -1 : loadtest_wait_opt(start, true);
+        if (on_us < 0) {
+            timeouts++;
+        } else {
+            done++;
+            total_us += on_us;
+            if (on_us > max_us) {
+                max_us = on_us;
+            }
+        }
+        loadtest_sleep_ms((uint32_t)(i * 37) % 200);
+    }
+    protocol_get_stats(&after);
+    hp_sim_stats_t sim_after = loadtest_sim.stats;
+
+    printf("opt writes, %u rounds of off/on:\n", rounds);
+    printf("  frames sent       %10u (merged %u, expected %u)\n", after.write_count - before.write_count,
+           after.write_merged - before.write_merged, rounds * 2);
+    printf("  unit state writes %10u\n", sim_after.opt_writes - sim_before.opt_writes);
+    if (done > 0) {
+        printf("  write to unit     %10.1f ms avg, %.1f ms max\n",
+               (double)total_us / done / 1000.0, (double)max_us / 1000.0);
+    }
+    printf("  unit timeouts     %10u\n", timeouts);
+}
+
+int main(int argc, char **argv) {
+    hp_sim_options_t options = hp_sim_defaults;
+    uint32_t poll_seconds = 10;
+    uint32_t write_rounds = 50;
+    uint32_t opt_rounds = 20;
+    const char *capture_path = NULL;
+    int opt;
+
+    host_log_level = ESP_LOG_NONE;
+    while ((opt = getopt(argc, argv, "b:d:n:t:c:s:S:p:w:O:o:vh")) != -1) {
+        switch (opt) {
+            case 'b': options.baud = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'd': options.reply_delay_ms = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'n': options.noise_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 't': options.truncate_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'c': options.crc_error_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 's': options.silence_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'S': options.seed = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'p': poll_seconds = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'w': write_rounds = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'O': opt_rounds = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'o': capture_path = optarg; break;
+            case 'v': host_log_level = ESP_LOG_WARN; break;
+            default:
+                loadtest_usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    char slave_path[64];
+    if (hp_sim_open_pty(&loadtest_sim_fd, slave_path, sizeof(slave_path)) != 0) {
+        perror("pty");
+        return 1;
+    }
+    int gateway_fd = open(slave_path, O_RDWR | O_NOCTTY);
+    if (gateway_fd < 0 || hp_sim_tty_raw(gateway_fd, options.baud) != 0) {
+        perror(slave_path);
+        return 1;
+    }
+
+    hp_sim_init(&loadtest_sim, &options);
+    pthread_t sim_thread;
+    pthread_create(&sim_thread, NULL, loadtest_sim_thread, NULL);
+
+    // Poll the optional PCB block alongside main and extra
+    mb_holding_registers[MB_HOLDING_OPT_PCB_AVAILABLE - MB_REG_HOLDING_START] = 1;
+    if (protocol_init() != ESP_OK || host_uart_attach(PROTOCOL_UART_NUM, gateway_fd) != ESP_OK ||
+        protocol_start() != ESP_OK) {
+        fprintf(stderr, "protocol start failed\n");
+        return 1;
+    }
+
+    printf("simulator on %s, %u baud%s, faults: noise %u%%, truncate %u%%, crc %u%%, silence %u%%\n",
+           slave_path, options.baud, options.baud == 0 ? " (unpaced)" : "",
+           options.noise_pct, options.truncate_pct, options.crc_error_pct, options.silence_pct);
+
+    // The first decoded main block carries the simulator's DHW target
+    int64_t start = esp_timer_get_time();
+    while (loadtest_input(MB_INPUT_DHW_TARGET_TEMP) == 0) {
+        if (esp_timer_get_time() - start > (int64_t)LOADTEST_STARTUP_TIMEOUT_MS * 1000) {
+            fprintf(stderr, "no main block decoded within %d ms\n", LOADTEST_STARTUP_TIMEOUT_MS);
+            return 1;
+        }
+        loadtest_sleep_ms(1);
+    }
+    printf("first main block after %.1f ms\n", (double)(esp_timer_get_time() - start) / 1000.0);
+
+    if (poll_seconds > 0) {
+        loadtest_polling(poll_seconds);
+    }
+    if (write_rounds > 0) {
+        loadtest_writes(write_rounds);
+    }
+    if (opt_rounds > 0) {
+        loadtest_opt_writes(opt_rounds);
+    }
+
+    if (capture_path != NULL && loadtest_save_capture(capture_path) != 0) {
+        perror(capture_path);
+    }
+
+    loadtest_stop = true;
+    pthread_join(sim_thread, NULL);
+    printf("simulator: ");
+    fflush(stdout);
+    hp_sim_print_stats(stdout, &loadtest_sim.stats);
+    return 0;
+}
@@ -0,0 +1,174 @@
+/**
+ * @file hp_replay.c
+ * @brief Replay a frame capture (GET /capture) through the host protocol core
+ *
+ * Lists the capture, then feeds every complete RX frame through
+ * protocol_process_received_data() in capture order and reports the time
+ * per frame type. Use -n to repeat the whole capture for stable numbers.
+ *
+ * Usage: hp_replay [-l] [-n passes] capture.hpfc
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "protocol.h"
+#include "frame_capture.h"
+#include "esp_log.h"
+
+typedef struct {
+    frame_capture_record_t record;
+    uint8_t data[PROTOCOL_MAX_DATA_SIZE];
+} replay_frame_t;
+
+typedef struct {
+    const char *name;
+    uint32_t frames;
+    uint32_t rejected;
+    int64_t ns;
+} replay_class_t;
+
+static int64_t replay_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static replay_frame_t *replay_load(const char *path, frame_capture_file_header_t *header) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return NULL;
+    }
+    if (fread(header, sizeof(*header), 1, f) != 1 || header->magic != FRAME_CAPTURE_MAGIC ||
+        header->version != FRAME_CAPTURE_VERSION || header->record_header_size != sizeof(frame_capture_record_t)) {
+        fprintf(stderr, "%s: not a version %d frame capture\n", path, FRAME_CAPTURE_VERSION);
+        fclose(f);
+        return NULL;
+    }
+
+    replay_frame_t *frames = calloc(header->count ? header->count : 1, sizeof(*frames));
+    if (frames == NULL) {
+        fclose(f);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < header->count; i++) {
+        if (fread(&frames[i].record, sizeof(frames[i].record), 1, f) != 1 ||
+            frames[i].record.len > sizeof(frames[i].data) ||
+            fread(frames[i].data, 1, frames[i].record.len, f) != frames[i].record.len) {
+            fprintf(stderr, "%s: truncated at record %u of %u\n", path, i, header->count);
+            header->count = i;
+            break;
+        }
+    }
+    fclose(f);
+    return frames;
+}
+
+static void replay_list(const replay_frame_t *frames, uint32_t count) {
+    int64_t t0 = count > 0 ? frames[0].record.time_us : 0;
+    for (uint32_t i = 0; i < count; i++) {
+        const frame_capture_record_t *r = &frames[i].record;
+        printf("%10.3f ms  %s %3u bytes%s ", (double)(r->time_us - t0) / 1000.0,
+               r->direction == FRAME_CAPTURE_TX ? "TX" : "RX", r->len,
+               (r->flags & FRAME_CAPTURE_FLAG_INCOMPLETE) ? " (incomplete)" : "");
+        for (uint32_t b = 0; b < r->len && b < 8; b++) {
+            printf(" %02X", frames[i].data[b]);
+        }
+        printf(r->len > 8 ? " ...\n" : "\n");
+    }
+}
+
+static replay_class_t *replay_class_of(replay_class_t *classes, const replay_frame_t *frame) {
+    if (frame->record.len == PROTOCOL_MAIN_DATA_SIZE) {
+        return &classes[0];
+    }
+    if (frame->record.len == PROTOCOL_EXTRA_DATA_SIZE) {
+        return &classes[1];
+    }
+    if (frame->record.len == PROTOCOL_OPT_DATA_SIZE) {
+        return &classes[2];
+    }
+    return &classes[3];
+}
+
+int main(int argc, char **argv) {
+    bool list = false;
+    unsigned long passes = 1;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "ln:h")) != -1) {
+        switch (opt) {
+            case 'l': list = true; break;
+            case 'n': passes = strtoul(optarg, NULL, 10); break;
+            default:
+                fprintf(stderr, "usage: %s [-l] [-n passes] capture.hpfc\n", argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (optind >= argc || passes == 0) {
+        fprintf(stderr, "usage: %s [-l] [-n passes] capture.hpfc\n", argv[0]);
+        return 2;
+    }
+
+    frame_capture_file_header_t header;
+    replay_frame_t *frames = replay_load(argv[optind], &header);
+    if (frames == NULL) {
+        return 1;
+    }
+
+    uint32_t tx = 0, rx = 0, incomplete = 0;
+    for (uint32_t i = 0; i < header.count; i++) {
+        if (frames[i].record.direction == FRAME_CAPTURE_TX) {
+            tx++;
+        } else if (frames[i].record.flags & FRAME_CAPTURE_FLAG_INCOMPLETE) {
+            incomplete++;
+        } else {
+            rx++;
+        }
+    }
+    printf("%u records (%u older dropped on the device): %u TX, %u RX, %u incomplete RX\n",
+           header.count, header.dropped, tx, rx, incomplete);
+    if (header.count > 1) {
+        printf("span %.1f s\n", (double)(frames[header.count - 1].record.time_us - frames[0].record.time_us) / 1e6);
+    }
+    if (list) {
+        replay_list(frames, header.count);
+    }
+
+    if (protocol_init() != ESP_OK) {
+        fprintf(stderr, "protocol_init failed\n");
+        return 1;
+    }
+    replay_class_t classes[] = {
+        {"main"}, {"extra"}, {"opt"}, {"other"},
+    };
+    for (unsigned long pass = 0; pass < passes; pass++) {
+        for (uint32_t i = 0; i < header.count; i++) {
+            const replay_frame_t *frame = &frames[i];
+            if (frame->record.direction != FRAME_CAPTURE_RX || (frame->record.flags & FRAME_CAPTURE_FLAG_INCOMPLETE)) {
+                continue;
+            }
+            replay_class_t *c = replay_class_of(classes, frame);
+            int64_t start = replay_now_ns();
+            esp_err_t ret = protocol_process_received_data(frame->data, frame->record.len);
+            c->ns += replay_now_ns() - start;
+            c->frames++;
+            if (ret != ESP_OK) {
+                c->rejected++;
+            }
+        }
+    }
+
+    printf("%-8s %10s %10s %12s\n", "frame", "replayed", "rejected", "ns/frame");
+    for (size_t i = 0; i < sizeof(classes) / sizeof(classes[0]); i++) {
+        if (classes[i].frames > 0) {
+            printf("%-8s %10u %10u %12.1f\n", classes[i].name, classes[i].frames, classes[i].rejected,
+                   (double)classes[i].ns / classes[i].frames);
+        }
+    }
+    free(frames);
+    return 0;
+}
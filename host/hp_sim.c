@@ -0,0 +1,408 @@
+/**
+ * @file hp_sim.c
+ * @brief Virtual heat pump: answers the gateway's serial protocol on a tty
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "hp_sim.h"
+#include "hp_frames.h"
+
+#define HP_SIM_BITS_PER_BYTE    11      // Start + 8 data + even parity + stop
+#define HP_SIM_CHUNK            16      // Bytes written per paced chunk
+#define HP_SIM_IDLE_RESET_MS    100     // Partial request dropped after this gap
+#define HP_SIM_ACTION_POLLS     3       // Main blocks a forced defrost/sterilization lasts
+#define HP_SIM_NOISE_MAX        8
+
+// Main block write: byte 8 carries one-shot actions instead of a setting
+#define HP_SIM_OFFSET_ACTIONS   8
+#define HP_SIM_ACTION_RESET     0x01
+#define HP_SIM_ACTION_DEFROST   0x02
+#define HP_SIM_ACTION_STERIL    0x04
+#define HP_SIM_OFFSET_DEFROST   111
+#define HP_SIM_OFFSET_STERIL    117
+#define HP_SIM_STATE_BITS       0x0C    // Bits read as "bit 5 and 6" by the decoder
+#define HP_SIM_STATE_ON         0x08
+
+const hp_sim_options_t hp_sim_defaults = {
+    .baud = PROTOCOL_BAUD_RATE,
+    .drift = true,
+    .seed = 1,
+};
+
+static uint32_t hp_sim_random(hp_sim_t *sim) {
+    uint32_t x = sim->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->rng = x;
+    return x;
+}
+
+static bool hp_sim_chance(hp_sim_t *sim, uint32_t pct) {
+    return pct > 0 && hp_sim_random(sim) % 100 < pct;
+}
+
+static void hp_sim_sleep_us(uint64_t us) {
+    struct timespec ts = { .tv_sec = (time_t)(us / 1000000), .tv_nsec = (long)(us % 1000000) * 1000 };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+static uint64_t hp_sim_airtime_us(const hp_sim_t *sim, size_t bytes) {
+    if (sim->options.baud == 0) {
+        return 0;
+    }
+    return (uint64_t)bytes * HP_SIM_BITS_PER_BYTE * 1000000 / sim->options.baud;
+}
+
+static void hp_sim_reset_state(hp_sim_t *sim) {
+    hp_frame_main(sim->settings, 0);
+    memset(sim->written, 0, sizeof(sim->written));
+    memcpy(sim->opt_state, optional_pcb_query, sizeof(sim->opt_state));
+    sim->defrost_polls = 0;
+    sim->sterilization_polls = 0;
+}
+
+void hp_sim_init(hp_sim_t *sim, const hp_sim_options_t *options) {
+    memset(sim, 0, sizeof(*sim));
+    sim->options = options != NULL ? *options : hp_sim_defaults;
+    sim->rng = sim->options.seed != 0 ? sim->options.seed : 1;
+    hp_sim_reset_state(sim);
+}
+
+/**
+ * @brief Bit groups a write byte replaces as a whole, NULL for plain values
+ *
+ * Switches are written as a 2-bit group with 1 = off and 2 = on and all other
+ * groups zero, so only the non-zero groups of a write change the setting.
+ */
+static const uint8_t *hp_sim_write_groups(size_t offset) {
+    static const uint8_t pairs[] = {0x03, 0x0C, 0x30, 0xC0, 0};
+    static const uint8_t operation[] = {0x3F, 0xC0, 0};         // Mode, zones
+    static const uint8_t quiet[] = {0x07, 0x38, 0xC0, 0};       // Powerful, quiet, schedule
+
+    switch (offset) {
+        case 4: case 5: case 20: case 23: case 24: case 25: case 26:
+            return pairs;
+        case 6:
+            return operation;
+        case 7:
+            return quiet;
+        default:
+            return NULL;
+    }
+}
+
+static void hp_sim_apply_write(hp_sim_t *sim, const uint8_t *request) {
+    for (size_t i = PROTOCOL_WRITE_DATA_START; i < PROTOCOL_WRITE_SIZE; i++) {
+        uint8_t value = request[i];
+        if (value == 0) {
+            continue;
+        }
+
+        if (i == HP_SIM_OFFSET_ACTIONS) {
+            if (value & HP_SIM_ACTION_RESET) {
+                hp_sim_reset_state(sim);
+            }
+            if (value & HP_SIM_ACTION_DEFROST) {
+                sim->defrost_polls = HP_SIM_ACTION_POLLS;
+            }
+            if (value & HP_SIM_ACTION_STERIL) {
+                sim->sterilization_polls = HP_SIM_ACTION_POLLS;
+            }
+            continue;
+        }
+
+        const uint8_t *groups = hp_sim_write_groups(i);
+        uint8_t current = sim->settings[i];
+        if (groups == NULL) {
+            current = value;
+        } else {
+            for (; *groups != 0; groups++) {
+                if (value & *groups) {
+                    current = (uint8_t)((current & ~*groups) | (value & *groups));
+                }
+            }
+        }
+        sim->settings[i] = current;
+        sim->written[i] = true;
+    }
+}
+
+static size_t hp_sim_main_block(hp_sim_t *sim, uint8_t *reply) {
+    size_t size = hp_frame_main(reply, sim->options.drift ? sim->variant++ : 0);
+    for (size_t i = 0; i < size; i++) {
+        if (sim->written[i]) {
+            reply[i] = sim->settings[i];
+        }
+    }
+    if (sim->defrost_polls > 0) {
+        sim->defrost_polls--;
+        reply[HP_SIM_OFFSET_DEFROST] = (uint8_t)((reply[HP_SIM_OFFSET_DEFROST] & ~HP_SIM_STATE_BITS) | HP_SIM_STATE_ON);
+    }
+    if (sim->sterilization_polls > 0) {
+        sim->sterilization_polls--;
+        reply[HP_SIM_OFFSET_STERIL] = (uint8_t)((reply[HP_SIM_OFFSET_STERIL] & ~HP_SIM_STATE_BITS) | HP_SIM_STATE_ON);
+    }
+    hp_frame_seal(reply, size);
+    return size;
+}
+
+static size_t hp_sim_handshake_block(uint8_t *reply) {
+    const size_t size = PROTOCOL_HANDSHAKE_DATA_SIZE;
+    memset(reply, 0, size);
+    reply[0] = PROTOCOL_PKT_INIT;
+    reply[1] = (uint8_t)(size - PROTOCOL_FRAME_OVERHEAD);
+    reply[2] = 0x01;
+    reply[3] = PROTOCOL_PKT_HANDSHAKE;
+    hp_frame_seal(reply, size);
+    return size;
+}
+
+size_t hp_sim_handle(hp_sim_t *sim, const uint8_t *request, size_t size, uint8_t *reply) {
+    if (size < PROTOCOL_FRAME_OVERHEAD + 1 || request[1] + PROTOCOL_FRAME_OVERHEAD != size ||
+        !protocol_validate_checksum(request, size)) {
+        sim->stats.bad_requests++;
+        return 0;
+    }
+    sim->stats.requests++;
+
+    uint8_t type = request[0];
+    uint8_t block = request[3];
+    if (type == PROTOCOL_PKT_INIT) {
+        sim->stats.init++;
+        return hp_sim_handshake_block(reply);
+    }
+    if (type == PROTOCOL_PKT_READ && block == PROTOCOL_DATA_MAIN) {
+        sim->stats.main++;
+        return hp_sim_main_block(sim, reply);
+    }
+    if (type == PROTOCOL_PKT_READ && block == PROTOCOL_DATA_EXTRA) {
+        sim->stats.extra++;
+        return hp_frame_extra(reply, sim->options.drift ? sim->variant : 0);
+    }
+    if (type == PROTOCOL_PKT_WRITE && block == PROTOCOL_DATA_MAIN && size == PROTOCOL_WRITE_SIZE + 1) {
+        sim->stats.writes++;
+        hp_sim_apply_write(sim, request);
+        return hp_sim_main_block(sim, reply);
+    }
+    if (type == PROTOCOL_PKT_WRITE && block == PROTOCOL_DATA_OPT && size == PROTOCOL_OPT_WRITE_SIZE + 1) {
+        // The optional PCB query is a write of the full optional state
+        if (memcmp(request, sim->opt_state, sizeof(sim->opt_state)) != 0) {
+            sim->stats.opt_writes++;
+            memcpy(sim->opt_state, request, sizeof(sim->opt_state));
+        }
+        sim->stats.opt++;
+        return hp_frame_opt(reply, sim->options.drift ? sim->variant : 0);
+    }
+
+    sim->stats.requests--;
+    sim->stats.bad_requests++;
+    return 0;
+}
+
+static int hp_sim_write_all(int fd, const uint8_t *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Send a reply with the configured faults, paced to the line rate
+ */
+static int hp_sim_send(hp_sim_t *sim, int fd, const uint8_t *reply, size_t size) {
+    uint8_t line[HP_SIM_NOISE_MAX + PROTOCOL_MAX_DATA_SIZE];
+    size_t len = 0;
+
+    if (hp_sim_chance(sim, sim->options.silence_pct)) {
+        sim->stats.silent++;
+        return 0;
+    }
+    if (hp_sim_chance(sim, sim->options.noise_pct)) {
+        sim->stats.noise++;
+        size_t noise = 1 + hp_sim_random(sim) % HP_SIM_NOISE_MAX;
+        for (size_t i = 0; i < noise; i++) {
+            line[len++] = (uint8_t)hp_sim_random(sim);
+        }
+    }
+    memcpy(&line[len], reply, size);
+    if (hp_sim_chance(sim, sim->options.crc_error_pct) && size > 5) {
+        // Keep header and length intact so the frame is assembled and rejected
+        sim->stats.crc_errors++;
+        size_t at = 4 + hp_sim_random(sim) % (size - 5);
+        line[len + at] ^= (uint8_t)(1 + hp_sim_random(sim) % 255);
+    }
+    if (hp_sim_chance(sim, sim->options.truncate_pct) && size > 1) {
+        sim->stats.truncated++;
+        size = 1 + hp_sim_random(sim) % (size - 1);
+    }
+    len += size;
+
+    for (size_t sent = 0; sent < len; sent += HP_SIM_CHUNK) {
+        size_t chunk = len - sent < HP_SIM_CHUNK ? len - sent : HP_SIM_CHUNK;
+        hp_sim_sleep_us(hp_sim_airtime_us(sim, chunk));
+        if (hp_sim_write_all(fd, &line[sent], chunk) != 0) {
+            return -1;
+        }
+    }
+    sim->stats.tx_bytes += len;
+    return 0;
+}
+
+/**
+ * @brief Append received bytes to the request, answering each one completed
+ */
+static int hp_sim_feed(hp_sim_t *sim, int fd, const uint8_t *data, size_t size) {
+    uint8_t reply[PROTOCOL_MAX_DATA_SIZE];
+
+    for (size_t i = 0; i < size; i++) {
+        // Resync: requests start with a known packet type
+        if (sim->request_len == 0 && data[i] != PROTOCOL_PKT_READ &&
+            data[i] != PROTOCOL_PKT_INIT && data[i] != PROTOCOL_PKT_WRITE) {
+            sim->stats.bad_requests++;
+            continue;
+        }
+        sim->request[sim->request_len++] = data[i];
+        if (sim->request_len < 2 ||
+            sim->request_len < (size_t)sim->request[1] + PROTOCOL_FRAME_OVERHEAD) {
+            continue;
+        }
+
+        size_t request_len = sim->request_len;
+        sim->request_len = 0;
+        // The last byte only now finished arriving on a real line
+        hp_sim_sleep_us(hp_sim_airtime_us(sim, request_len) + (uint64_t)sim->options.reply_delay_ms * 1000);
+        size_t reply_len = hp_sim_handle(sim, sim->request, request_len, reply);
+        if (reply_len > 0 && hp_sim_send(sim, fd, reply, reply_len) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int hp_sim_serve(hp_sim_t *sim, int fd, volatile bool *stop) {
+    uint8_t buf[PROTOCOL_MAX_DATA_SIZE];
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+    while (stop == NULL || !*stop) {
+        int ready = poll(&pfd, 1, HP_SIM_IDLE_RESET_MS);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (ready == 0) {
+            // A unit drops a request that stalls mid-frame
+            if (sim->request_len > 0) {
+                sim->stats.bad_requests++;
+                sim->request_len = 0;
+            }
+            continue;
+        }
+
+        ssize_t n = read(fd, buf, sizeof(buf));
+        if (n < 0 && (errno == EINTR || errno == EAGAIN)) {
+            continue;
+        }
+        if (n < 0 && errno == EIO) {
+            // PTY slave not open (yet)
+            hp_sim_sleep_us(HP_SIM_IDLE_RESET_MS * 1000);
+            continue;
+        }
+        if (n <= 0) {
+            return n == 0 ? 0 : -1;
+        }
+        sim->stats.rx_bytes += (uint64_t)n;
+        if (hp_sim_feed(sim, fd, buf, (size_t)n) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static speed_t hp_sim_speed(uint32_t baud) {
+    switch (baud) {
+        case 9600:   return B9600;
+        case 19200:  return B19200;
+        case 38400:  return B38400;
+        case 57600:  return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        default:     return B0;
+    }
+}
+
+int hp_sim_tty_raw(int fd, uint32_t baud) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    speed_t speed = hp_sim_speed(baud);
+    if (speed != B0) {
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+    }
+    return tcsetattr(fd, TCSANOW, &tio);
+}
+
+int hp_sim_open_pty(int *master_fd, char *slave_path, size_t path_size) {
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        return -1;
+    }
+    if (grantpt(fd) != 0 || unlockpt(fd) != 0 || ptsname_r(fd, slave_path, path_size) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    // Raw mode is a property of the slave side
+    int slave = open(slave_path, O_RDWR | O_NOCTTY);
+    if (slave < 0) {
+        close(fd);
+        return -1;
+    }
+    int ret = hp_sim_tty_raw(slave, 0);
+    close(slave);
+    if (ret != 0) {
+        close(fd);
+        return -1;
+    }
+    *master_fd = fd;
+    return 0;
+}
+
+void hp_sim_print_stats(FILE *out, const hp_sim_stats_t *stats) {
+    fprintf(out,
+            "requests %u (bad %u): init %u, main %u, extra %u, opt %u, writes %u, opt writes %u\n"
+            "faults: noise %u, truncated %u, crc %u, silent %u\n"
+            "bytes: rx %llu, tx %llu\n",
+            stats->requests, stats->bad_requests, stats->init, stats->main, stats->extra,
+            stats->opt, stats->writes, stats->opt_writes, stats->noise, stats->truncated,
+            stats->crc_errors, stats->silent,
+            (unsigned long long)stats->rx_bytes, (unsigned long long)stats->tx_bytes);
+}
@@ -0,0 +1,122 @@
+/**
+ * @file hp_sim.h
+ * @brief Virtual heat pump: answers the gateway's serial protocol on a tty
+ *
+ * Answers the 0x31 initial query with a 0x10 handshake block, 0x71 queries
+ * with main/extra blocks and 0xF1 writes with the updated main or optional
+ * PCB block. Main block writes change the simulated settings the same way
+ * the commands from commands.c change a real unit, so they read back on the
+ * next main block. Replies can be paced to a baud rate and corrupted with
+ * line noise, truncation, bad checksums or silence.
+ */
+
+#ifndef HP_SIM_H
+#define HP_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fault probabilities are per reply, in percent
+typedef struct {
+    uint32_t baud;              // Line rate for pacing (8E1 = 11 bits/byte), 0 = unpaced
+    uint32_t reply_delay_ms;    // Unit think time between request and reply
+    uint32_t noise_pct;         // Random bytes sent before the reply
+    uint32_t truncate_pct;      // Reply cut short
+    uint32_t crc_error_pct;     // One payload byte corrupted
+    uint32_t silence_pct;       // No reply at all
+    bool drift;                 // Move the sensor bytes between main blocks
+    uint32_t seed;
+} hp_sim_options_t;
+
+typedef struct {
+    uint32_t requests;          // Complete requests with a valid checksum
+    uint32_t bad_requests;      // Requests with a bad checksum or unknown type
+    uint32_t init;
+    uint32_t main;
+    uint32_t extra;
+    uint32_t opt;
+    uint32_t writes;            // Main block writes
+    uint32_t opt_writes;        // Optional PCB writes
+    uint32_t noise;
+    uint32_t truncated;
+    uint32_t crc_errors;
+    uint32_t silent;
+    uint64_t tx_bytes;
+    uint64_t rx_bytes;
+} hp_sim_stats_t;
+
+// 9600 baud pacing, drifting sensors, no faults
+extern const hp_sim_options_t hp_sim_defaults;
+
+typedef struct {
+    hp_sim_options_t options;
+    hp_sim_stats_t stats;
+    uint8_t settings[PROTOCOL_MAIN_DATA_SIZE];  // Written main block bytes
+    bool written[PROTOCOL_MAIN_DATA_SIZE];      // Offsets that override the base frame
+    uint8_t opt_state[PROTOCOL_OPT_WRITE_SIZE]; // Last optional PCB write
+    uint32_t defrost_polls;     // Main blocks left with defrost running
+    uint32_t sterilization_polls;
+    uint32_t variant;
+    uint32_t rng;
+    uint8_t request[PROTOCOL_MAX_DATA_SIZE];
+    size_t request_len;
+} hp_sim_t;
+
+/**
+ * @brief Reset the simulated unit to its power-on state
+ * @param sim Simulator
+ * @param options Pacing and fault injection, NULL for defaults
+ */
+void hp_sim_init(hp_sim_t *sim, const hp_sim_options_t *options);
+
+/**
+ * @brief Answer one complete request
+ * @param sim Simulator
+ * @param request Request including its checksum
+ * @param size Request size
+ * @param reply Output reply, at least PROTOCOL_MAX_DATA_SIZE bytes
+ * @return Reply size, 0 if the unit does not answer
+ */
+size_t hp_sim_handle(hp_sim_t *sim, const uint8_t *request, size_t size, uint8_t *reply);
+
+/**
+ * @brief Serve requests from a tty until it closes or *stop is set
+ * @param sim Simulator
+ * @param fd Tty (PTY master) connected to the gateway
+ * @param stop Polled between reads, may be NULL
+ * @return 0 when stopped, -1 on a read/write error
+ */
+int hp_sim_serve(hp_sim_t *sim, int fd, volatile bool *stop);
+
+/**
+ * @brief Open a raw PTY pair for the simulator
+ * @param master_fd Output master side, served by hp_sim_serve()
+ * @param slave_path Output slave device path for the gateway
+ * @param path_size Size of slave_path
+ * @return 0 on success, -1 on error
+ */
+int hp_sim_open_pty(int *master_fd, char *slave_path, size_t path_size);
+
+/**
+ * @brief Put an open tty in raw mode at the given rate
+ * @return 0 on success, -1 on error
+ */
+int hp_sim_tty_raw(int fd, uint32_t baud);
+
+/**
+ * @brief Print the simulator counters
+ */
+void hp_sim_print_stats(FILE *out, const hp_sim_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HP_SIM_H
@@ -0,0 +1,87 @@
+/**
+ * @file hp_sim_main.c
+ * @brief Standalone virtual heat pump on a pseudo-terminal
+ *
+ * Prints the PTY slave path to connect the gateway (or any serial tool) to
+ * and serves requests until interrupted, then prints its counters.
+ *
+ * Usage: hp_sim [-b baud] [-d reply_delay_ms] [-n noise%] [-t truncate%]
+ *               [-c crc_error%] [-s silence%] [-S seed] [-f] [-l link]
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "hp_sim.h"
+
+static volatile bool sim_stop = false;
+
+static void sim_on_signal(int signo) {
+    (void)signo;
+    sim_stop = true;
+}
+
+static void sim_usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [-b baud] [-d reply_delay_ms] [-n noise%%] [-t truncate%%]\n"
+            "          [-c crc_error%%] [-s silence%%] [-S seed] [-f] [-l link]\n"
+            "  -b  line rate used for pacing, 0 = unpaced (default 9600)\n"
+            "  -f  fixed sensor values (no drift between main blocks)\n"
+            "  -l  also expose the PTY as a symlink at this path\n", name);
+}
+
+int main(int argc, char **argv) {
+    hp_sim_options_t options = hp_sim_defaults;
+    const char *link_path = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:d:n:t:c:s:S:fl:h")) != -1) {
+        switch (opt) {
+            case 'b': options.baud = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'd': options.reply_delay_ms = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'n': options.noise_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 't': options.truncate_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'c': options.crc_error_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 's': options.silence_pct = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'S': options.seed = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'f': options.drift = false; break;
+            case 'l': link_path = optarg; break;
+            default:
+                sim_usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    int fd;
+    char slave_path[64];
+    if (hp_sim_open_pty(&fd, slave_path, sizeof(slave_path)) != 0) {
+        perror("hp_sim: pty");
+        return 1;
+    }
+    if (link_path != NULL) {
+        unlink(link_path);
+        if (symlink(slave_path, link_path) != 0) {
+            perror("hp_sim: symlink");
+            return 1;
+        }
+    }
+
+    struct sigaction sa = { .sa_handler = sim_on_signal };
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    hp_sim_t sim;
+    hp_sim_init(&sim, &options);
+    printf("%s\n", slave_path);
+    fflush(stdout);
+
+    int ret = hp_sim_serve(&sim, fd, &sim_stop);
+    hp_sim_print_stats(stderr, &sim.stats);
+    if (link_path != NULL) {
+        unlink(link_path);
+    }
+    close(fd);
+    return ret == 0 ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file uart.h
+ * @brief Host stand-in for the ESP-IDF UART driver
+ *
+ * Transmitted bytes are kept in a per-port TX buffer and received bytes are
+ * injected with host_uart_inject(), which also posts a UART_DATA event.
+ * host_uart_attach() connects a port to a tty (e.g. the heat pump simulator)
+ * instead.
+ */
+
+#ifndef HOST_DRIVER_UART_H
+#define HOST_DRIVER_UART_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "hal/uart_types.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UART_PIN_NO_CHANGE (-1)
+
+typedef struct {
+    int baud_rate;
+    uart_word_length_t data_bits;
+    uart_parity_t parity;
+    uart_stop_bits_t stop_bits;
+    uart_hw_flowcontrol_t flow_ctrl;
+    uint8_t rx_flow_ctrl_thresh;
+    uart_sclk_t source_clk;
+} uart_config_t;
+
+typedef enum {
+    UART_DATA,
+    UART_BREAK,
+    UART_BUFFER_FULL,
+    UART_FIFO_OVF,
+    UART_FRAME_ERR,
+    UART_PARITY_ERR,
+    UART_DATA_BREAK,
+    UART_PATTERN_DET,
+    UART_EVENT_MAX,
+} uart_event_type_t;
+
+typedef struct {
+    uart_event_type_t type;
+    size_t size;
+    bool timeout_flag;
+} uart_event_t;
+
+esp_err_t uart_driver_install(uart_port_t port, int rx_buffer_size, int tx_buffer_size,
+                              int queue_size, QueueHandle_t *uart_queue, int intr_alloc_flags);
+esp_err_t uart_driver_delete(uart_port_t port);
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t *config);
+esp_err_t uart_set_pin(uart_port_t port, int tx, int rx, int rts, int cts);
+int uart_write_bytes(uart_port_t port, const void *src, size_t size);
+int uart_read_bytes(uart_port_t port, void *buf, uint32_t length, TickType_t ticks_to_wait);
+esp_err_t uart_flush_input(uart_port_t port);
+esp_err_t uart_get_buffered_data_len(uart_port_t port, size_t *size);
+
+/**
+ * @brief Queue bytes as if received on the port and post a UART_DATA event
+ * @return Number of bytes accepted
+ */
+size_t host_uart_inject(uart_port_t port, const uint8_t *data, size_t size);
+
+/**
+ * @brief Take the bytes written to the port since the last call
+ * @return Number of bytes copied
+ */
+size_t host_uart_take_tx(uart_port_t port, uint8_t *buf, size_t size);
+
+/**
+ * @brief Connect an installed port to an open tty
+ * Writes go to fd; a reader thread injects everything read from fd
+ * @param port Installed port
+ * @param fd Open descriptor, owned by the caller and kept open
+ * @return ESP_OK on success
+ */
+esp_err_t host_uart_attach(uart_port_t port, int fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_DRIVER_UART_H
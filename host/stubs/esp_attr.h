@@ -0,0 +1,12 @@
+/**
+ * @file esp_attr.h
+ * @brief Host stand-in for the ESP-IDF section attributes
+ */
+
+#ifndef HOST_ESP_ATTR_H
+#define HOST_ESP_ATTR_H
+
+// Host RAM is cleared at start, like RTC memory after a power loss
+#define RTC_NOINIT_ATTR
+
+#endif // HOST_ESP_ATTR_H
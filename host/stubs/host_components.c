@@ -0,0 +1,120 @@
+/**
+ * @file host_components.c
+ * @brief Host stand-ins for the firmware modules outside the protocol core
+ *
+ * MQTT, the Modbus slave, NVS and the HTTP server are not part of the host
+ * build; these replacements keep the core linkable and count what it asks
+ * of them.
+ */
+
+#include <pthread.h>
+#include <string.h>
+#include "host_components.h"
+#include "modbus_slave.h"
+#include "nvs_hp.h"
+#include "mqtt_pub.h"
+#include "http_server.h"
+#include "hpc.h"
+
+host_component_stats_t host_component_stats = {0};
+bool host_mqtt_connected = false;
+
+modbus_serial_config_t base_serial_cfg = {
+    .baudrate = 9600,
+    .parity = UART_PARITY_DISABLE,
+    .stop_bits = UART_STOP_BITS_1,
+    .data_bits = UART_DATA_8_BITS,
+};
+
+// Guards the live register areas, as the Modbus slave's lock does on target
+static pthread_mutex_t host_modbus_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void modbus_slave_lock(void) {
+    pthread_mutex_lock(&host_modbus_lock);
+}
+
+void modbus_slave_unlock(void) {
+    pthread_mutex_unlock(&host_modbus_lock);
+}
+
+esp_err_t modbus_slave_get_serial_config(modbus_serial_config_t *cfg_out) {
+    if (cfg_out == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    *cfg_out = base_serial_cfg;
+    return ESP_OK;
+}
+
+bool mqtt_client_is_connected(void) {
+    return host_mqtt_connected;
+}
+
+esp_err_t mqtt_client_publish_data(void) {
+    host_component_stats.mqtt_publish++;
+    return host_mqtt_connected ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+void hpc_boot_mark(hpc_boot_stage_t stage) {
+    (void)stage;
+}
+
+void http_server_notify_inputs(void) {
+    host_component_stats.http_notify++;
+}
+
+esp_err_t modbus_nvs_save_config(const modbus_serial_config_t *cfg) {
+    (void)cfg;
+    host_component_stats.nvs_save++;
+    return ESP_OK;
+}
+
+esp_err_t modbus_nvs_save_opt_pcb(uint8_t value) {
+    (void)value;
+    host_component_stats.nvs_save++;
+    return ESP_OK;
+}
+
+esp_err_t modbus_nvs_save_mqtt_publish(uint8_t value) {
+    (void)value;
+    host_component_stats.nvs_save++;
+    return ESP_OK;
+}
+
+esp_err_t modbus_nvs_save_mqtt_payload_mode(uint8_t value) {
+    (void)value;
+    host_component_stats.nvs_save++;
+    return ESP_OK;
+}
+
+esp_err_t modbus_nvs_save_remap(const uint16_t *sources, size_t count) {
+    (void)sources;
+    (void)count;
+    host_component_stats.nvs_save++;
+    return ESP_OK;
+}
+
+esp_err_t modbus_nvs_load_warm_cache(void *cache, size_t size) {
+    (void)cache;
+    (void)size;
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t modbus_nvs_save_warm_cache(const void *cache, size_t size) {
+    (void)cache;
+    (void)size;
+    host_component_stats.nvs_save++;
+    return ESP_OK;
+}
+
+esp_err_t modbus_nvs_load_poll_limits(uint16_t *min_sec, uint16_t *max_sec) {
+    (void)min_sec;
+    (void)max_sec;
+    return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t modbus_nvs_save_poll_limits(uint16_t min_sec, uint16_t max_sec) {
+    (void)min_sec;
+    (void)max_sec;
+    host_component_stats.nvs_save++;
+    return ESP_OK;
+}
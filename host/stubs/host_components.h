@@ -0,0 +1,32 @@
+/**
+ * @file host_components.h
+ * @brief Host stand-ins for MQTT, Modbus slave and NVS
+ */
+
+#ifndef HOST_COMPONENTS_H
+#define HOST_COMPONENTS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Calls the protocol core made into the stand-ins
+typedef struct {
+    uint32_t mqtt_publish;
+    uint32_t nvs_save;
+    uint32_t http_notify;
+} host_component_stats_t;
+
+extern host_component_stats_t host_component_stats;
+
+// Value returned by mqtt_client_is_connected()
+extern bool host_mqtt_connected;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_COMPONENTS_H
@@ -0,0 +1,497 @@
+/**
+ * @file host_port.c
+ * @brief Host implementations of the ESP-IDF / FreeRTOS stand-ins
+ *
+ * Queues are mutex/condition-variable ring buffers with real timeouts and
+ * tasks run as POSIX threads, so the protocol task can run against a tty
+ * attached with host_uart_attach().
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "driver/uart.h"
+
+esp_log_level_t host_log_level = ESP_LOG_WARN;
+
+void host_log_write(esp_log_level_t level, const char *tag, const char *format, ...) {
+    static const char letters[] = "NEWIDV";
+    va_list args;
+    fprintf(stderr, "%c (%lld) %s: ", letters[level], (long long)(esp_timer_get_time() / 1000), tag);
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+const char *esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK:                    return "ESP_OK";
+        case ESP_FAIL:                  return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:            return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:       return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:     return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:      return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:         return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED:     return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:           return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE:  return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_INVALID_CRC:       return "ESP_ERR_INVALID_CRC";
+        default:                        return "UNKNOWN ERROR";
+    }
+}
+
+int64_t esp_timer_get_time(void) {
+    static int64_t start_us = -1;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    int64_t now_us = (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    if (start_us < 0) {
+        start_us = now_us;
+    }
+    return now_us - start_us;
+}
+
+// Queues
+
+struct host_queue {
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t *items;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+};
+
+/**
+ * @brief Absolute CLOCK_MONOTONIC deadline ticks from now
+ */
+static struct timespec host_deadline(TickType_t ticks) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ticks * (1000000000ULL / configTICK_RATE_HZ) + (uint64_t)ts.tv_nsec;
+    ts.tv_sec += (time_t)(ns / 1000000000ULL);
+    ts.tv_nsec = (long)(ns % 1000000000ULL);
+    return ts;
+}
+
+/**
+ * @brief Wait with the queue locked until it has items (or room) or the ticks expire
+ * @return true if the condition holds
+ */
+static bool host_queue_wait(QueueHandle_t queue, bool want_items, TickType_t ticks) {
+    struct timespec deadline = host_deadline(ticks == portMAX_DELAY ? 0 : ticks);
+    while (want_items ? queue->count == 0 : queue->count >= queue->length) {
+        if (ticks == 0) {
+            return false;
+        }
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(&queue->changed, &queue->lock);
+        } else if (pthread_cond_timedwait(&queue->changed, &queue->lock, &deadline) == ETIMEDOUT) {
+            return want_items ? queue->count > 0 : queue->count < queue->length;
+        }
+    }
+    return true;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+    QueueHandle_t queue = calloc(1, sizeof(*queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    queue->items = calloc(length, item_size);
+    if (queue->items == NULL) {
+        free(queue);
+        return NULL;
+    }
+    queue->length = length;
+    queue->item_size = item_size;
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&queue->changed, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&queue->lock, NULL);
+    return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+    if (queue != NULL) {
+        pthread_cond_destroy(&queue->changed);
+        pthread_mutex_destroy(&queue->lock);
+        free(queue->items);
+        free(queue);
+    }
+}
+
+static uint8_t *host_queue_slot(QueueHandle_t queue, UBaseType_t index) {
+    return queue->items + ((queue->head + index) % queue->length) * queue->item_size;
+}
+
+static BaseType_t host_queue_put(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait, bool front) {
+    if (queue == NULL) {
+        return errQUEUE_FULL;
+    }
+    pthread_mutex_lock(&queue->lock);
+    if (!host_queue_wait(queue, false, ticks_to_wait)) {
+        pthread_mutex_unlock(&queue->lock);
+        return errQUEUE_FULL;
+    }
+    if (front) {
+        queue->head = (queue->head + queue->length - 1) % queue->length;
+        memcpy(host_queue_slot(queue, 0), item, queue->item_size);
+    } else {
+        memcpy(host_queue_slot(queue, queue->count), item, queue->item_size);
+    }
+    queue->count++;
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait) {
+    return host_queue_put(queue, item, ticks_to_wait, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t ticks_to_wait) {
+    return host_queue_put(queue, item, ticks_to_wait, true);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item) {
+    if (queue == NULL) {
+        return pdFALSE;
+    }
+    pthread_mutex_lock(&queue->lock);
+    queue->head = 0;
+    queue->count = 1;
+    memcpy(host_queue_slot(queue, 0), item, queue->item_size);
+    pthread_cond_broadcast(&queue->changed);
+    pthread_mutex_unlock(&queue->lock);
+    return pdTRUE;
+}
+
+static BaseType_t host_queue_get(QueueHandle_t queue, void *item, TickType_t ticks_to_wait, bool remove) {
+    if (queue == NULL) {
+        return errQUEUE_EMPTY;
+    }
+    pthread_mutex_lock(&queue->lock);
+    if (!host_queue_wait(queue, true, ticks_to_wait)) {
+        pthread_mutex_unlock(&queue->lock);
+        return errQUEUE_EMPTY;
+    }
+    memcpy(item, host_queue_slot(queue, 0), queue->item_size);
+    if (remove) {
+        queue->head = (queue->head + 1) % queue->length;
+        queue->count--;
+        pthread_cond_broadcast(&queue->changed);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return pdTRUE;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t ticks_to_wait) {
+    return host_queue_get(queue, item, ticks_to_wait, false);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks_to_wait) {
+    return host_queue_get(queue, item, ticks_to_wait, true);
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+    if (queue != NULL) {
+        pthread_mutex_lock(&queue->lock);
+        queue->head = 0;
+        queue->count = 0;
+        pthread_cond_broadcast(&queue->changed);
+        pthread_mutex_unlock(&queue->lock);
+    }
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+    if (queue == NULL) {
+        return 0;
+    }
+    pthread_mutex_lock(&queue->lock);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->lock);
+    return count;
+}
+
+// Tasks
+
+typedef struct {
+    TaskFunction_t task;
+    void *parameters;
+} host_task_t;
+
+static void *host_task_entry(void *arg) {
+    host_task_t start = *(host_task_t *)arg;
+    free(arg);
+    start.task(start.parameters);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char *name, uint32_t stack_depth,
+                       void *parameters, UBaseType_t priority, TaskHandle_t *created_task) {
+    (void)name; (void)stack_depth; (void)priority;
+    host_task_t *start = malloc(sizeof(*start));
+    if (start == NULL) {
+        return pdFAIL;
+    }
+    start->task = task;
+    start->parameters = parameters;
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, host_task_entry, start) != 0) {
+        free(start);
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+    if (created_task != NULL) {
+        *created_task = (TaskHandle_t)thread;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    // Only self-deletion is used by the firmware
+    if (task == NULL) {
+        pthread_exit(NULL);
+    }
+}
+
+void vTaskDelay(TickType_t ticks) {
+    struct timespec ts = {
+        .tv_sec = ticks / configTICK_RATE_HZ,
+        .tv_nsec = (long)(ticks % configTICK_RATE_HZ) * (1000000000L / configTICK_RATE_HZ),
+    };
+    nanosleep(&ts, NULL);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(esp_timer_get_time() / (1000 * portTICK_PERIOD_MS));
+}
+
+// UART
+
+#define HOST_UART_BUF_SIZE 1024
+
+typedef struct {
+    bool installed;
+    QueueHandle_t event_queue;
+    pthread_mutex_t lock;
+    uint8_t rx[HOST_UART_BUF_SIZE];
+    size_t rx_len;
+    uint8_t tx[HOST_UART_BUF_SIZE];
+    size_t tx_len;
+    int fd;                     // Attached tty, -1 when TX is captured
+} host_uart_t;
+
+static host_uart_t host_uarts[UART_NUM_MAX];
+
+static host_uart_t *host_uart_get(uart_port_t port) {
+    return (port >= 0 && port < UART_NUM_MAX && host_uarts[port].installed) ? &host_uarts[port] : NULL;
+}
+
+esp_err_t uart_driver_install(uart_port_t port, int rx_buffer_size, int tx_buffer_size,
+                              int queue_size, QueueHandle_t *uart_queue, int intr_alloc_flags) {
+    (void)rx_buffer_size; (void)tx_buffer_size; (void)intr_alloc_flags;
+    if (port < 0 || port >= UART_NUM_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    host_uart_t *uart = &host_uarts[port];
+    memset(uart, 0, sizeof(*uart));
+    uart->fd = -1;
+    if (uart_queue != NULL && queue_size > 0) {
+        uart->event_queue = xQueueCreate((UBaseType_t)queue_size, sizeof(uart_event_t));
+        if (uart->event_queue == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        *uart_queue = uart->event_queue;
+    }
+    pthread_mutex_init(&uart->lock, NULL);
+    uart->installed = true;
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_delete(uart_port_t port) {
+    host_uart_t *uart = host_uart_get(port);
+    if (uart == NULL || uart->fd >= 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    vQueueDelete(uart->event_queue);
+    pthread_mutex_destroy(&uart->lock);
+    memset(uart, 0, sizeof(*uart));
+    return ESP_OK;
+}
+
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t *config) {
+    (void)port;
+    return config != NULL ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t uart_set_pin(uart_port_t port, int tx, int rx, int rts, int cts) {
+    (void)port; (void)tx; (void)rx; (void)rts; (void)cts;
+    return ESP_OK;
+}
+
+int uart_write_bytes(uart_port_t port, const void *src, size_t size) {
+    host_uart_t *uart = host_uart_get(port);
+    if (uart == NULL || src == NULL) {
+        return -1;
+    }
+    if (uart->fd >= 0) {
+        const uint8_t *p = src;
+        size_t left = size;
+        while (left > 0) {
+            ssize_t n = write(uart->fd, p, left);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            p += n;
+            left -= (size_t)n;
+        }
+        return (int)size;
+    }
+    pthread_mutex_lock(&uart->lock);
+    size_t room = sizeof(uart->tx) - uart->tx_len;
+    size_t n = size < room ? size : room;
+    memcpy(uart->tx + uart->tx_len, src, n);
+    uart->tx_len += n;
+    pthread_mutex_unlock(&uart->lock);
+    return (int)size;
+}
+
+int uart_read_bytes(uart_port_t port, void *buf, uint32_t length, TickType_t ticks_to_wait) {
+    (void)ticks_to_wait;
+    host_uart_t *uart = host_uart_get(port);
+    if (uart == NULL || buf == NULL) {
+        return -1;
+    }
+    pthread_mutex_lock(&uart->lock);
+    size_t n = length < uart->rx_len ? length : uart->rx_len;
+    memcpy(buf, uart->rx, n);
+    memmove(uart->rx, uart->rx + n, uart->rx_len - n);
+    uart->rx_len -= n;
+    pthread_mutex_unlock(&uart->lock);
+    return (int)n;
+}
+
+esp_err_t uart_flush_input(uart_port_t port) {
+    host_uart_t *uart = host_uart_get(port);
+    if (uart == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    pthread_mutex_lock(&uart->lock);
+    uart->rx_len = 0;
+    pthread_mutex_unlock(&uart->lock);
+    return ESP_OK;
+}
+
+esp_err_t uart_get_buffered_data_len(uart_port_t port, size_t *size) {
+    host_uart_t *uart = host_uart_get(port);
+    if (uart == NULL || size == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&uart->lock);
+    *size = uart->rx_len;
+    pthread_mutex_unlock(&uart->lock);
+    return ESP_OK;
+}
+
+size_t host_uart_inject(uart_port_t port, const uint8_t *data, size_t size) {
+    host_uart_t *uart = host_uart_get(port);
+    if (uart == NULL || data == NULL) {
+        return 0;
+    }
+    pthread_mutex_lock(&uart->lock);
+    size_t room = sizeof(uart->rx) - uart->rx_len;
+    size_t n = size < room ? size : room;
+    memcpy(uart->rx + uart->rx_len, data, n);
+    uart->rx_len += n;
+    pthread_mutex_unlock(&uart->lock);
+
+    if (uart->event_queue != NULL) {
+        if (n > 0) {
+            uart_event_t event = { .type = UART_DATA, .size = n, .timeout_flag = false };
+            xQueueSend(uart->event_queue, &event, 0);
+        }
+        if (n < size) {
+            uart_event_t event = { .type = UART_BUFFER_FULL, .size = 0, .timeout_flag = false };
+            xQueueSend(uart->event_queue, &event, 0);
+        }
+    }
+    return n;
+}
+
+size_t host_uart_take_tx(uart_port_t port, uint8_t *buf, size_t size) {
+    host_uart_t *uart = host_uart_get(port);
+    if (uart == NULL || buf == NULL) {
+        return 0;
+    }
+    pthread_mutex_lock(&uart->lock);
+    size_t n = size < uart->tx_len ? size : uart->tx_len;
+    memcpy(buf, uart->tx, n);
+    memmove(uart->tx, uart->tx + n, uart->tx_len - n);
+    uart->tx_len -= n;
+    pthread_mutex_unlock(&uart->lock);
+    return n;
+}
+
+/**
+ * @brief Reader thread of an attached tty: everything read is injected as RX
+ */
+static void *host_uart_reader(void *arg) {
+    uart_port_t port = (uart_port_t)(intptr_t)arg;
+    uint8_t buf[128];
+
+    while (1) {
+        ssize_t n = read(host_uarts[port].fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        host_uart_inject(port, buf, (size_t)n);
+    }
+    return NULL;
+}
+
+esp_err_t host_uart_attach(uart_port_t port, int fd) {
+    host_uart_t *uart = host_uart_get(port);
+    if (uart == NULL || fd < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (uart->fd >= 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    uart->fd = fd;
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, host_uart_reader, (void *)(intptr_t)port) != 0) {
+        uart->fd = -1;
+        return ESP_ERR_NO_MEM;
+    }
+    pthread_detach(thread);
+    return ESP_OK;
+}
@@ -242,12 +242,12 @@ static void adc_task(void *pvParameters) {
                 // For AIN channel, store raw ADC value
                 if (i == 1 || i == 2) { // NTC1 (GPIO34) or NTC2 (GPIO35)
                     int16_t temp_x100 = adc_ntc_to_temperature(filtered);
-                    mb_input_registers[reg_index] = temp_x100;
+                    modbus_params_set_input(reg_index, temp_x100);
                     
                     ESP_LOGD(TAG, "ADC CH%d (GPIO%d, NTC): raw=%d, filtered=%d, temp=%.2f°C", 
                              i, adc_channels[i].gpio, raw, filtered, temp_x100 / 100.0f);
                 } else { // AIN (GPIO32)
-                    mb_input_registers[reg_index] = (int16_t)filtered;
+                    modbus_params_set_input(reg_index, (int16_t)filtered);
                     
                     ESP_LOGD(TAG, "ADC CH%d (GPIO%d, AIN): raw=%d, filtered=%d", 
                              i, adc_channels[i].gpio, raw, filtered);
@@ -375,18 +375,20 @@ esp_err_t set_external_compressor_control(bool state) {
  * @return ESP_OK on success
  */
 esp_err_t set_byte_6(uint8_t val, uint8_t base, uint8_t bit) {
-    protocol_cmd_t cmd;
+    protocol_cmd_t cmd = {0};
     cmd.len = PROTOCOL_OPT_WRITE_SIZE;
     memcpy(cmd.data, optional_pcb_query, PROTOCOL_OPT_WRITE_SIZE);
     cmd.data[OPT_OFFSET_BYTE_6] = (cmd.data[OPT_OFFSET_BYTE_6] & ~(base << bit)) | (val << bit);
+    cmd.opt_mask[OPT_OFFSET_BYTE_6] = (uint8_t)(base << bit);
     return protocol_send_command(&cmd);
 }
 
 esp_err_t set_byte_9(uint8_t val) {
-    protocol_cmd_t cmd;
+    protocol_cmd_t cmd = {0};
     cmd.len = PROTOCOL_OPT_WRITE_SIZE;
     memcpy(cmd.data, optional_pcb_query, PROTOCOL_OPT_WRITE_SIZE);
     cmd.data[OPT_OFFSET_BYTE_9] = val;
+    cmd.opt_mask[OPT_OFFSET_BYTE_9] = 0xFF;
     return protocol_send_command(&cmd);
 }
 
@@ -423,19 +425,21 @@ esp_err_t set_external_thermostat_2_state(uint8_t mode) {
 }
 
 esp_err_t set_demand_control(uint8_t mode) {
-    protocol_cmd_t cmd;
+    protocol_cmd_t cmd = {0};
     cmd.len = PROTOCOL_OPT_WRITE_SIZE;
     memcpy(cmd.data, optional_pcb_query, PROTOCOL_OPT_WRITE_SIZE);
     cmd.data[OPT_OFFSET_DEMAND_CONTROL] = mode;
+    cmd.opt_mask[OPT_OFFSET_DEMAND_CONTROL] = 0xFF;
     return protocol_send_command(&cmd);
 }
 
 esp_err_t set_xxx_temp(float temperature, uint8_t byte) {
     uint8_t value = temp2hex(temperature);
-    protocol_cmd_t cmd;
+    protocol_cmd_t cmd = {0};
     cmd.len = PROTOCOL_OPT_WRITE_SIZE;
     memcpy(cmd.data, optional_pcb_query, PROTOCOL_OPT_WRITE_SIZE);
     cmd.data[byte] = value;
+    cmd.opt_mask[byte] = 0xFF;
     return protocol_send_command(&cmd);
 }
 
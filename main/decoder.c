@@ -279,261 +279,361 @@ static int16_t getOpMode(uint8_t input) {
     }
 }
 
+// Main frame field transforms (one per get*() helper above)
+typedef enum {
+    FIELD_MINUS128 = 0,
+    FIELD_MINUS1,
+    FIELD_MINUS1_DIV5,
+    FIELD_MINUS1_TIMES10,
+    FIELD_MINUS1_TIMES50,
+    FIELD_MINUS1_DIV50,
+    FIELD_POWER,
+    FIELD_VALVE_PID,
+    FIELD_BIT1,
+    FIELD_BIT1AND2,
+    FIELD_BIT3AND4,
+    FIELD_BIT5AND6,
+    FIELD_BIT7AND8,
+    FIELD_BIT3AND4AND5,
+    FIELD_RIGHT3BITS,
+    FIELD_FIRST_BYTE,
+    FIELD_SECOND_BYTE,
+    FIELD_OPMODE,
+    FIELD_UINT16,           // Little endian word at offset, offset+1
+} main_field_kind_t;
+
+// Main frame field descriptor: data[offset] -> kind -> reg
+typedef struct {
+    uint8_t offset;
+    uint8_t kind;
+    uint16_t reg;
+} main_field_t;
+
+/*
+ * Main frame field list: F(offset, kind, reg) decodes data[offset] into reg.
+ * The remap window is gathered from these registers on commit, see
+ * modbus_params_commit_inputs(). Fields that need more than one byte-wise
+ * transform (inlet/outlet fraction, pump flow, error code, model) are decoded
+ * explicitly in decode_main_data().
+ */
+#define MAIN_FIELDS(F) \
+    /* Temperatures */ \
+    F(OFFS_MAIN_TARGET_TEMP,            FIELD_MINUS128,       MB_INPUT_MAIN_TARGET_TEMP) \
+    F(OFFS_DHW_TEMP,                    FIELD_MINUS128,       MB_INPUT_DHW_TEMP) \
+    F(OFFS_DHW_TARGET_TEMP,             FIELD_MINUS128,       MB_INPUT_DHW_TARGET_TEMP) \
+    F(OFFS_OUTSIDE_TEMP,                FIELD_MINUS128,       MB_INPUT_OUTSIDE_TEMP) \
+    F(OFFS_ROOM_THERMOSTAT_TEMP,        FIELD_MINUS128,       MB_INPUT_ROOM_THERMOSTAT_TEMP) \
+    F(OFFS_BUFFER_TEMP,                 FIELD_MINUS128,       MB_INPUT_BUFFER_TEMP) \
+    F(OFFS_SOLAR_TEMP,                  FIELD_MINUS128,       MB_INPUT_SOLAR_TEMP) \
+    F(OFFS_POOL_TEMP,                   FIELD_MINUS128,       MB_INPUT_POOL_TEMP) \
+    /* Power values */ \
+    F(OFFS_HEAT_POWER_PRODUCTION,       FIELD_POWER,          MB_INPUT_HEAT_POWER_PRODUCTION) \
+    F(OFFS_HEAT_POWER_CONSUMPTION,      FIELD_POWER,          MB_INPUT_HEAT_POWER_CONSUMPTION) \
+    F(OFFS_COOL_POWER_PRODUCTION,       FIELD_POWER,          MB_INPUT_COOL_POWER_PRODUCTION) \
+    F(OFFS_COOL_POWER_CONSUMPTION,      FIELD_POWER,          MB_INPUT_COOL_POWER_CONSUMPTION) \
+    F(OFFS_DHW_POWER_PRODUCTION,        FIELD_POWER,          MB_INPUT_DHW_POWER_PRODUCTION) \
+    F(OFFS_DHW_POWER_CONSUMPTION,       FIELD_POWER,          MB_INPUT_DHW_POWER_CONSUMPTION) \
+    /* Operation states */ \
+    F(OFFS_HEATPUMP_STATE,              FIELD_BIT7AND8,       MB_INPUT_STATUS) \
+    F(OFFS_HEATPUMP_STATE,              FIELD_BIT7AND8,       MB_INPUT_HEATPUMP_STATE) \
+    F(OFFS_FORCE_DHW_STATE,             FIELD_BIT1AND2,       MB_INPUT_FORCE_DHW_STATE) \
+    F(OFFS_OPERATING_MODE_STATE,        FIELD_OPMODE,         MB_INPUT_OPERATING_MODE_STATE) \
+    F(OFFS_QUIET_MODE_SCHEDULE,         FIELD_BIT1AND2,       MB_INPUT_QUIET_MODE_SCHEDULE) \
+    F(OFFS_POWERFUL_MODE_TIME,          FIELD_RIGHT3BITS,     MB_INPUT_POWERFUL_MODE_TIME) \
+    F(OFFS_QUIET_MODE_LEVEL,            FIELD_BIT3AND4AND5,   MB_INPUT_QUIET_MODE_LEVEL) \
+    F(OFFS_HOLIDAY_MODE_STATE,          FIELD_BIT3AND4,       MB_INPUT_HOLIDAY_MODE_STATE) \
+    F(OFFS_THREE_WAY_VALVE_STATE,       FIELD_BIT7AND8,       MB_INPUT_THREE_WAY_VALVE_STATE) \
+    F(OFFS_DEFROSTING_STATE,            FIELD_BIT5AND6,       MB_INPUT_DEFROSTING_STATE) \
+    F(OFFS_ZONES_STATE,                 FIELD_BIT1AND2,       MB_INPUT_ZONES_STATE) \
+    F(OFFS_MAIN_SCHEDULE_STATE,         FIELD_BIT1AND2,       MB_INPUT_MAIN_SCHEDULE_STATE) \
+    /* Technical parameters */ \
+    F(OFFS_COMPRESSOR_FREQ,             FIELD_MINUS1,         MB_INPUT_COMPRESSOR_FREQ) \
+    F(OFFS_OPERATIONS_HOURS,            FIELD_UINT16,         MB_INPUT_OPERATIONS_HOURS) \
+    F(OFFS_OPERATIONS_COUNTER,          FIELD_UINT16,         MB_INPUT_OPERATIONS_COUNTER) \
+    F(OFFS_FAN1_MOTOR_SPEED,            FIELD_MINUS1_TIMES10, MB_INPUT_FAN1_MOTOR_SPEED) \
+    F(OFFS_FAN2_MOTOR_SPEED,            FIELD_MINUS1_TIMES10, MB_INPUT_FAN2_MOTOR_SPEED) \
+    F(OFFS_HIGH_PRESSURE,               FIELD_MINUS1_DIV5,    MB_INPUT_HIGH_PRESSURE) \
+    F(OFFS_PUMP_SPEED,                  FIELD_MINUS1_TIMES50, MB_INPUT_PUMP_SPEED) \
+    F(OFFS_LOW_PRESSURE,                FIELD_MINUS1_TIMES50, MB_INPUT_LOW_PRESSURE) \
+    F(OFFS_COMPRESSOR_CURRENT,          FIELD_MINUS1_DIV5,    MB_INPUT_COMPRESSOR_CURRENT) \
+    F(OFFS_PUMP_DUTY,                   FIELD_MINUS1,         MB_INPUT_PUMP_DUTY) \
+    F(OFFS_MAX_PUMP_DUTY,               FIELD_MINUS1,         MB_INPUT_MAX_PUMP_DUTY) \
+    /* Additional temperatures */ \
+    F(OFFS_MAIN_HEX_OUTLET_TEMP,        FIELD_MINUS128,       MB_INPUT_MAIN_HEX_OUTLET_TEMP) \
+    F(OFFS_DISCHARGE_TEMP,              FIELD_MINUS128,       MB_INPUT_DISCHARGE_TEMP) \
+    F(OFFS_INSIDE_PIPE_TEMP,            FIELD_MINUS128,       MB_INPUT_INSIDE_PIPE_TEMP) \
+    F(OFFS_DEFROST_TEMP,                FIELD_MINUS128,       MB_INPUT_DEFROST_TEMP) \
+    F(OFFS_EVA_OUTLET_TEMP,             FIELD_MINUS128,       MB_INPUT_EVA_OUTLET_TEMP) \
+    F(OFFS_BYPASS_OUTLET_TEMP,          FIELD_MINUS128,       MB_INPUT_BYPASS_OUTLET_TEMP) \
+    F(OFFS_IPM_TEMP,                    FIELD_MINUS128,       MB_INPUT_IPM_TEMP) \
+    F(OFFS_OUTSIDE_PIPE_TEMP,           FIELD_MINUS128,       MB_INPUT_OUTSIDE_PIPE_TEMP) \
+    F(OFFS_Z1_TEMP,                     FIELD_MINUS128,       MB_INPUT_Z1_ROOM_TEMP) \
+    F(OFFS_Z2_TEMP,                     FIELD_MINUS128,       MB_INPUT_Z2_ROOM_TEMP) \
+    F(OFFS_Z1_WATER_TEMP,               FIELD_MINUS128,       MB_INPUT_Z1_WATER_TEMP) \
+    F(OFFS_Z2_WATER_TEMP,               FIELD_MINUS128,       MB_INPUT_Z2_WATER_TEMP) \
+    F(OFFS_Z1_WATER_TARGET_TEMP,        FIELD_MINUS128,       MB_INPUT_Z1_WATER_TARGET_TEMP) \
+    F(OFFS_Z2_WATER_TARGET_TEMP,        FIELD_MINUS128,       MB_INPUT_Z2_WATER_TARGET_TEMP) \
+    F(OFFS_SECOND_INLET_TEMP,           FIELD_MINUS128,       MB_INPUT_SECOND_INLET_TEMP) \
+    F(OFFS_ECONOMIZER_OUTLET_TEMP,      FIELD_MINUS128,       MB_INPUT_ECONOMIZER_OUTLET_TEMP) \
+    F(OFFS_SECOND_ROOM_THERMOSTAT_TEMP, FIELD_MINUS128,       MB_INPUT_SECOND_ROOM_THERMO_TEMP) \
+    /* Zone request temperatures */ \
+    F(OFFS_Z1_HEAT_REQUEST_TEMP,        FIELD_MINUS128,       MB_INPUT_Z1_HEAT_REQUEST_TEMP) \
+    F(OFFS_Z1_COOL_REQUEST_TEMP,        FIELD_MINUS128,       MB_INPUT_Z1_COOL_REQUEST_TEMP) \
+    F(OFFS_Z2_HEAT_REQUEST_TEMP,        FIELD_MINUS128,       MB_INPUT_Z2_HEAT_REQUEST_TEMP) \
+    F(OFFS_Z2_COOL_REQUEST_TEMP,        FIELD_MINUS128,       MB_INPUT_Z2_COOL_REQUEST_TEMP) \
+    /* Zone curve settings */ \
+    F(OFFS_Z1_HEAT_CURVE_TARGET_HIGH,   FIELD_MINUS128,       MB_INPUT_Z1_HEAT_CURVE_TARGET_HIGH) \
+    F(OFFS_Z1_HEAT_CURVE_TARGET_LOW,    FIELD_MINUS128,       MB_INPUT_Z1_HEAT_CURVE_TARGET_LOW) \
+    F(OFFS_Z1_HEAT_CURVE_OUTSIDE_HIGH,  FIELD_MINUS128,       MB_INPUT_Z1_HEAT_CURVE_OUTSIDE_HIGH) \
+    F(OFFS_Z1_HEAT_CURVE_OUTSIDE_LOW,   FIELD_MINUS128,       MB_INPUT_Z1_HEAT_CURVE_OUTSIDE_LOW) \
+    F(OFFS_Z1_COOL_CURVE_TARGET_HIGH,   FIELD_MINUS128,       MB_INPUT_Z1_COOL_CURVE_TARGET_HIGH) \
+    F(OFFS_Z1_COOL_CURVE_TARGET_LOW,    FIELD_MINUS128,       MB_INPUT_Z1_COOL_CURVE_TARGET_LOW) \
+    F(OFFS_Z1_COOL_CURVE_OUTSIDE_HIGH,  FIELD_MINUS128,       MB_INPUT_Z1_COOL_CURVE_OUTSIDE_HIGH) \
+    F(OFFS_Z1_COOL_CURVE_OUTSIDE_LOW,   FIELD_MINUS128,       MB_INPUT_Z1_COOL_CURVE_OUTSIDE_LOW) \
+    F(OFFS_Z2_HEAT_CURVE_TARGET_HIGH,   FIELD_MINUS128,       MB_INPUT_Z2_HEAT_CURVE_TARGET_HIGH) \
+    F(OFFS_Z2_HEAT_CURVE_TARGET_LOW,    FIELD_MINUS128,       MB_INPUT_Z2_HEAT_CURVE_TARGET_LOW) \
+    F(OFFS_Z2_HEAT_CURVE_OUTSIDE_HIGH,  FIELD_MINUS128,       MB_INPUT_Z2_HEAT_CURVE_OUTSIDE_HIGH) \
+    F(OFFS_Z2_HEAT_CURVE_OUTSIDE_LOW,   FIELD_MINUS128,       MB_INPUT_Z2_HEAT_CURVE_OUTSIDE_LOW) \
+    F(OFFS_Z2_COOL_CURVE_TARGET_HIGH,   FIELD_MINUS128,       MB_INPUT_Z2_COOL_CURVE_TARGET_HIGH) \
+    F(OFFS_Z2_COOL_CURVE_TARGET_LOW,    FIELD_MINUS128,       MB_INPUT_Z2_COOL_CURVE_TARGET_LOW) \
+    F(OFFS_Z2_COOL_CURVE_OUTSIDE_HIGH,  FIELD_MINUS128,       MB_INPUT_Z2_COOL_CURVE_OUTSIDE_HIGH) \
+    F(OFFS_Z2_COOL_CURVE_OUTSIDE_LOW,   FIELD_MINUS128,       MB_INPUT_Z2_COOL_CURVE_OUTSIDE_LOW) \
+    /* Heater states */ \
+    F(OFFS_DHW_HEATER_STATE,            FIELD_BIT5AND6,       MB_INPUT_DHW_HEATER_STATE) \
+    F(OFFS_ROOM_HEATER_STATE,           FIELD_BIT7AND8,       MB_INPUT_ROOM_HEATER_STATE) \
+    F(OFFS_INTERNAL_HEATER_STATE,       FIELD_BIT7AND8,       MB_INPUT_INTERNAL_HEATER_STATE) \
+    F(OFFS_EXTERNAL_HEATER_STATE,       FIELD_BIT5AND6,       MB_INPUT_EXTERNAL_HEATER_STATE) \
+    F(OFFS_FORCE_HEATER_STATE,          FIELD_BIT5AND6,       MB_INPUT_FORCE_HEATER_STATE) \
+    F(OFFS_STERILIZATION_STATE,         FIELD_BIT5AND6,       MB_INPUT_STERILIZATION_STATE) \
+    F(OFFS_STERILIZATION_TEMP,          FIELD_MINUS128,       MB_INPUT_STERILIZATION_TEMP) \
+    F(OFFS_STERILIZATION_MAX_TIME,      FIELD_MINUS1,         MB_INPUT_STERILIZATION_MAX_TIME) \
+    /* Deltas and shifts */ \
+    F(OFFS_DHW_HEAT_DELTA,              FIELD_MINUS128,       MB_INPUT_DHW_HEAT_DELTA) \
+    F(OFFS_HEAT_DELTA,                  FIELD_MINUS128,       MB_INPUT_HEAT_DELTA) \
+    F(OFFS_COOL_DELTA,                  FIELD_MINUS128,       MB_INPUT_COOL_DELTA) \
+    F(OFFS_DHW_HOLIDAY_SHIFT_TEMP,      FIELD_MINUS128,       MB_INPUT_DHW_HOLIDAY_SHIFT_TEMP) \
+    F(OFFS_ROOM_HOLIDAY_SHIFT_TEMP,     FIELD_MINUS128,       MB_INPUT_ROOM_HOLIDAY_SHIFT_TEMP) \
+    F(OFFS_BUFFER_TANK_DELTA,           FIELD_MINUS128,       MB_INPUT_BUFFER_TANK_DELTA) \
+    /* Mode settings */ \
+    F(OFFS_HEATING_MODE,                FIELD_BIT7AND8,       MB_INPUT_HEATING_MODE) \
+    F(OFFS_HEATING_OFF_OUTDOOR_TEMP,    FIELD_MINUS128,       MB_INPUT_HEATING_OFF_OUTDOOR_TEMP) \
+    F(OFFS_HEATER_ON_OUTDOOR_TEMP,      FIELD_MINUS128,       MB_INPUT_HEATER_ON_OUTDOOR_TEMP) \
+    F(OFFS_HEAT_TO_COOL_TEMP,           FIELD_MINUS128,       MB_INPUT_HEAT_TO_COOL_TEMP) \
+    F(OFFS_COOL_TO_HEAT_TEMP,           FIELD_MINUS128,       MB_INPUT_COOL_TO_HEAT_TEMP) \
+    F(OFFS_COOLING_MODE,                FIELD_BIT5AND6,       MB_INPUT_COOLING_MODE) \
+    /* Solar and buffer settings */ \
+    F(OFFS_BUFFER_INSTALLED,            FIELD_BIT5AND6,       MB_INPUT_BUFFER_INSTALLED) \
+    F(OFFS_DHW_INSTALLED,               FIELD_BIT7AND8,       MB_INPUT_DHW_INSTALLED) \
+    F(OFFS_SOLAR_MODE,                  FIELD_BIT3AND4,       MB_INPUT_SOLAR_MODE) \
+    F(OFFS_SOLAR_ON_DELTA,              FIELD_MINUS128,       MB_INPUT_SOLAR_ON_DELTA) \
+    F(OFFS_SOLAR_OFF_DELTA,             FIELD_MINUS128,       MB_INPUT_SOLAR_OFF_DELTA) \
+    F(OFFS_SOLAR_FROST_PROTECTION,      FIELD_MINUS128,       MB_INPUT_SOLAR_FROST_PROTECTION) \
+    F(OFFS_SOLAR_HIGH_LIMIT,            FIELD_MINUS128,       MB_INPUT_SOLAR_HIGH_LIMIT) \
+    /* Pump and liquid settings */ \
+    F(OFFS_PUMP_FLOWRATE_MODE,          FIELD_BIT3AND4,       MB_INPUT_PUMP_FLOWRATE_MODE) \
+    F(OFFS_LIQUID_TYPE,                 FIELD_BIT1,           MB_INPUT_LIQUID_TYPE) \
+    F(OFFS_ALT_EXTERNAL_SENSOR,         FIELD_BIT3AND4,       MB_INPUT_ALT_EXTERNAL_SENSOR) \
+    F(OFFS_ANTI_FREEZE_MODE,            FIELD_BIT5AND6,       MB_INPUT_ANTI_FREEZE_MODE) \
+    F(OFFS_OPTIONAL_PCB,                FIELD_BIT7AND8,       MB_INPUT_OPTIONAL_PCB) \
+    /* Zone sensor settings */ \
+    F(OFFS_Z1_SENSOR_SETTINGS,          FIELD_SECOND_BYTE,    MB_INPUT_Z1_SENSOR_SETTINGS) \
+    F(OFFS_Z2_SENSOR_SETTINGS,          FIELD_FIRST_BYTE,     MB_INPUT_Z2_SENSOR_SETTINGS) \
+    /* External controls */ \
+    F(OFFS_EXTERNAL_PAD_HEATER,         FIELD_BIT3AND4,       MB_INPUT_EXTERNAL_PAD_HEATER) \
+    F(OFFS_WATER_PRESSURE,              FIELD_MINUS1_DIV50,   MB_INPUT_WATER_PRESSURE) \
+    F(OFFS_EXTERNAL_CONTROL,            FIELD_BIT7AND8,       MB_INPUT_EXTERNAL_CONTROL) \
+    F(OFFS_EXTERNAL_HEAT_COOL_CONTROL,  FIELD_BIT5AND6,       MB_INPUT_EXTERNAL_HEAT_COOL_CONTROL) \
+    F(OFFS_EXTERNAL_ERROR_SIGNAL,       FIELD_BIT3AND4,       MB_INPUT_EXTERNAL_ERROR_SIGNAL) \
+    F(OFFS_EXTERNAL_COMPRESSOR_CONTROL, FIELD_BIT1AND2,       MB_INPUT_EXTERNAL_COMPRESSOR_CONTROL) \
+    /* Pump states */ \
+    F(OFFS_Z2_PUMP_STATE,               FIELD_BIT1AND2,       MB_INPUT_Z2_PUMP_STATE) \
+    F(OFFS_Z1_PUMP_STATE,               FIELD_BIT3AND4,       MB_INPUT_Z1_PUMP_STATE) \
+    F(OFFS_TWOWAY_VALVE_STATE,          FIELD_BIT5AND6,       MB_INPUT_TWO_WAY_VALVE_STATE) \
+    F(OFFS_THREEWAY_VALVE_STATE2,       FIELD_BIT7AND8,       MB_INPUT_THREE_WAY_VALVE_STATE2) \
+    /* Valve PID settings */ \
+    F(OFFS_Z1_VALVE_PID,                FIELD_VALVE_PID,      MB_INPUT_Z1_VALVE_PID) \
+    F(OFFS_Z2_VALVE_PID,                FIELD_VALVE_PID,      MB_INPUT_Z2_VALVE_PID) \
+    /* Bivalent settings */ \
+    F(OFFS_BIVALENT_CONTROL,            FIELD_BIT7AND8,       MB_INPUT_BIVALENT_CONTROL) \
+    F(OFFS_BIVALENT_MODE,               FIELD_BIT5AND6,       MB_INPUT_BIVALENT_MODE) \
+    F(OFFS_BIVALENT_START_TEMP,         FIELD_MINUS128,       MB_INPUT_BIVALENT_START_TEMP) \
+    F(OFFS_BIVALENT_ADV_HEAT,           FIELD_BIT3AND4,       MB_INPUT_BIVALENT_ADVANCED_HEAT) \
+    F(OFFS_BIVALENT_ADV_DHW,            FIELD_BIT1AND2,       MB_INPUT_BIVALENT_ADVANCED_DHW) \
+    F(OFFS_BIVALENT_ADV_START_TEMP,     FIELD_MINUS128,       MB_INPUT_BIVALENT_ADVANCED_START_TEMP) \
+    F(OFFS_BIVALENT_ADV_STOP_TEMP,      FIELD_MINUS128,       MB_INPUT_BIVALENT_ADVANCED_STOP_TEMP) \
+    F(OFFS_BIVALENT_ADV_START_DELAY,    FIELD_MINUS1,         MB_INPUT_BIVALENT_ADVANCED_START_DELAY) \
+    F(OFFS_BIVALENT_ADV_STOP_DELAY,     FIELD_MINUS1,         MB_INPUT_BIVALENT_ADVANCED_STOP_DELAY) \
+    F(OFFS_BIVALENT_ADV_DHW_DELAY,      FIELD_MINUS1,         MB_INPUT_BIVALENT_ADVANCED_DHW_DELAY) \
+    /* Timing settings */ \
+    F(OFFS_HEATER_DELAY_TIME,           FIELD_MINUS1,         MB_INPUT_HEATER_DELAY_TIME) \
+    F(OFFS_HEATER_START_DELTA,          FIELD_MINUS128,       MB_INPUT_HEATER_START_DELTA) \
+    F(OFFS_HEATER_STOP_DELTA,           FIELD_MINUS128,       MB_INPUT_HEATER_STOP_DELTA) \
+    /* Operation hours */ \
+    F(OFFS_ROOM_HEATER_OPERATIONS_HOURS, FIELD_UINT16,        MB_INPUT_ROOM_HEATER_OPS_HOURS) \
+    F(OFFS_DHW_HEATER_OPERATIONS_HOURS, FIELD_UINT16,         MB_INPUT_DHW_HEATER_OPS_HOURS)
+
+#define MAIN_FIELD_ENTRY(offs, kind, reg) { (offs), (kind), (reg) },
+
+static const main_field_t main_fields[] = {
+    MAIN_FIELDS(MAIN_FIELD_ENTRY)
+};
+
+// Compile-time checks: every field lies inside the main frame and targets a valid register
+#define MAIN_FIELD_ASSERT(offs, kind, reg) \
+    _Static_assert((offs) + ((kind) == FIELD_UINT16 ? 1 : 0) < PROTOCOL_MAIN_DATA_SIZE, "field outside main frame: " #offs); \
+    _Static_assert((reg) < MB_REG_INPUT_COUNT, "register out of range: " #reg);
+MAIN_FIELDS(MAIN_FIELD_ASSERT)
+
+/*
+ * Overlapping targets: every register written by decode_main_data() becomes a
+ * case label here, so two fields writing the same register fail to compile
+ * with "duplicate case value". Never called.
+ */
+#define MAIN_FIELD_CASE(offs, kind, reg) case (reg):
+static inline __attribute__((unused)) bool main_field_targets_unique(uint16_t reg) {
+    switch (reg) {
+        MAIN_FIELDS(MAIN_FIELD_CASE)
+        // Explicitly decoded fields
+        case MB_INPUT_MAIN_INLET_TEMP:
+        case MB_INPUT_MAIN_OUTLET_TEMP:
+        case MB_INPUT_PUMP_FLOW:
+        case MB_INPUT_ERROR_TYPE:
+        case MB_INPUT_ERROR_NUMBER:
+        case MB_INPUT_HP_MODEL_0: case MB_INPUT_HP_MODEL_0 + 1: case MB_INPUT_HP_MODEL_0 + 2:
+        case MB_INPUT_HP_MODEL_0 + 3: case MB_INPUT_HP_MODEL_0 + 4:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static inline int16_t decode_main_field(const main_field_t *field) {
+    uint8_t input = g_protocol_rx.data[field->offset];
+    switch (field->kind) {
+        case FIELD_MINUS128:        return getIntMinus128(input);
+        case FIELD_MINUS1:          return getIntMinus1(input);
+        case FIELD_MINUS1_DIV5:     return getIntMinus1Div5(input);
+        case FIELD_MINUS1_TIMES10:  return getIntMinus1Times10(input);
+        case FIELD_MINUS1_TIMES50:  return getIntMinus1Times50(input);
+        case FIELD_MINUS1_DIV50:    return getIntMinus1Div50(input);
+        case FIELD_POWER:           return getPower(input);
+        case FIELD_VALVE_PID:       return getValvePID(input);
+        case FIELD_BIT1:            return getBit1(input);
+        case FIELD_BIT1AND2:        return getBit1and2(input);
+        case FIELD_BIT3AND4:        return getBit3and4(input);
+        case FIELD_BIT5AND6:        return getBit5and6(input);
+        case FIELD_BIT7AND8:        return getBit7and8(input);
+        case FIELD_BIT3AND4AND5:    return getBit3and4and5(input);
+        case FIELD_RIGHT3BITS:      return getRight3bits(input);
+        case FIELD_FIRST_BYTE:      return getFirstByte(input);
+        case FIELD_SECOND_BYTE:     return getSecondByte(input);
+        case FIELD_OPMODE:          return getOpMode(input);
+        case FIELD_UINT16:          return getUint16(field->offset);
+        default:                    return 0;
+    }
+}
+
+// True if any of count bytes starting at offset changed (NULL bitmap: everything changed)
+static inline bool decode_bytes_changed(const uint32_t *changed, size_t offset, size_t count) {
+    if (changed == NULL) {
+        return true;
+    }
+    for (size_t i = offset; i < offset + count; i++) {
+        if (PROTOCOL_FRAME_BYTE_CHANGED(changed, i)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Store a decoded value, counting registers whose value actually changed
+static inline void decode_store(uint16_t reg, int16_t value, size_t *updated) {
+    if (mb_input_registers_back[reg] != value) {
+        mb_input_registers_back[reg] = value;
+        (*updated)++;
+    }
+}
+
 /**
  * @brief Decode main heat pump data
- * Now writes directly to Modbus input registers instead of intermediate structure
+ * Writes directly to Modbus input registers
  */
 esp_err_t decode_main_data(void) {
+    return decode_main_data_changed(NULL, NULL);
+}
+
+/**
+ * @brief Decode the main data fields whose bytes changed
+ * Walks main_fields[] and writes directly to Modbus input registers
+ */
+esp_err_t decode_main_data_changed(const uint32_t *changed, size_t *updated) {
     ESP_LOGD(TAG, "Decoding main data");
+    size_t count = 0;
     
-    // Optimized direct decoding - write directly to Modbus registers
+    for (size_t i = 0; i < sizeof(main_fields) / sizeof(main_fields[0]); i++) {
+        const main_field_t *field = &main_fields[i];
+        if (!decode_bytes_changed(changed, field->offset, field->kind == FIELD_UINT16 ? 2 : 1)) {
+            continue;
+        }
+        int16_t value = decode_main_field(field);
+        decode_store(field->reg, value, &count);
+    }
     
-    // Temperatures (stored as int16_t * 100, e.g. 25.5°C = 2550)
-    // Handle special cases with fractional parts
-    int16_t main_inlet_temp = getIntMinus128(g_protocol_rx.data[OFFS_MAIN_INLET_TEMP]) * 100;
-    int fractional = (int)(g_protocol_rx.data[OFFS_MAIN_INLET_FRACTIONAL_TEMP] & 0b111);
-    if (fractional > 1 && fractional < 5) {
-        main_inlet_temp += (fractional - 1) * 25;
+    // Temperatures with fractional parts (stored as int16_t * 100, e.g. 25.5°C = 2550)
+    if (decode_bytes_changed(changed, OFFS_MAIN_INLET_TEMP, 1) || decode_bytes_changed(changed, OFFS_MAIN_INLET_FRACTIONAL_TEMP, 1)) {
+        int16_t main_inlet_temp = getIntMinus128(g_protocol_rx.data[OFFS_MAIN_INLET_TEMP]) * 100;
+        int fractional = (int)(g_protocol_rx.data[OFFS_MAIN_INLET_FRACTIONAL_TEMP] & 0b111);
+        if (fractional > 1 && fractional < 5) {
+            main_inlet_temp += (fractional - 1) * 25;
+        }
+        decode_store(MB_INPUT_MAIN_INLET_TEMP, main_inlet_temp, &count);
     }
-    mb_input_registers[MB_INPUT_MAIN_INLET_TEMP_CPY] = mb_input_registers[MB_INPUT_MAIN_INLET_TEMP] = main_inlet_temp;
     
-    int16_t main_outlet_temp = getIntMinus128(g_protocol_rx.data[OFFS_MAIN_OUTLET_TEMP]) * 100;
-    fractional = (int)((g_protocol_rx.data[OFFS_MAIN_OUTLET_FRACTIONAL_TEMP] >> 3) & 0b111);
-    if (fractional > 1 && fractional < 5) {
-        main_outlet_temp += (fractional - 1) * 25;
+    if (decode_bytes_changed(changed, OFFS_MAIN_OUTLET_TEMP, 1) || decode_bytes_changed(changed, OFFS_MAIN_OUTLET_FRACTIONAL_TEMP, 1)) {
+        int16_t main_outlet_temp = getIntMinus128(g_protocol_rx.data[OFFS_MAIN_OUTLET_TEMP]) * 100;
+        int fractional = (int)((g_protocol_rx.data[OFFS_MAIN_OUTLET_FRACTIONAL_TEMP] >> 3) & 0b111);
+        if (fractional > 1 && fractional < 5) {
+            main_outlet_temp += (fractional - 1) * 25;
+        }
+        decode_store(MB_INPUT_MAIN_OUTLET_TEMP, main_outlet_temp, &count);
     }
-    mb_input_registers[MB_INPUT_MAIN_OUTLET_TEMP_CPY] = mb_input_registers[MB_INPUT_MAIN_OUTLET_TEMP] = main_outlet_temp;
-    
-    mb_input_registers[MB_INPUT_MAIN_TARGET_TEMP_CPY] = mb_input_registers[MB_INPUT_MAIN_TARGET_TEMP] = 
-        getIntMinus128(g_protocol_rx.data[OFFS_MAIN_TARGET_TEMP]);
-    mb_input_registers[MB_INPUT_DHW_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_DHW_TEMP]);
-    mb_input_registers[MB_INPUT_DHW_TARGET_TEMP_CPY] = mb_input_registers[MB_INPUT_DHW_TARGET_TEMP] = 
-        getIntMinus128(g_protocol_rx.data[OFFS_DHW_TARGET_TEMP]);
-    mb_input_registers[MB_INPUT_OUTSIDE_TEMP_CPY] = mb_input_registers[MB_INPUT_OUTSIDE_TEMP] = 
-        getIntMinus128(g_protocol_rx.data[OFFS_OUTSIDE_TEMP]);
-    mb_input_registers[MB_INPUT_ROOM_THERMOSTAT_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_ROOM_THERMOSTAT_TEMP]);
-    mb_input_registers[MB_INPUT_BUFFER_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_BUFFER_TEMP]);
-    mb_input_registers[MB_INPUT_SOLAR_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_SOLAR_TEMP]);
-    mb_input_registers[MB_INPUT_POOL_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_POOL_TEMP]);
-    
-    // Power values
-    mb_input_registers[MB_INPUT_HEAT_POWER_PRODUCTION] = getPower(g_protocol_rx.data[OFFS_HEAT_POWER_PRODUCTION]);
-    mb_input_registers[MB_INPUT_HEAT_POWER_CONSUMPTION_CPY] = mb_input_registers[MB_INPUT_HEAT_POWER_CONSUMPTION] = 
-        getPower(g_protocol_rx.data[OFFS_HEAT_POWER_CONSUMPTION]);
-    mb_input_registers[MB_INPUT_COOL_POWER_PRODUCTION] = getPower(g_protocol_rx.data[OFFS_COOL_POWER_PRODUCTION]);
-    mb_input_registers[MB_INPUT_COOL_POWER_CONSUMPTION_CPY] = mb_input_registers[MB_INPUT_COOL_POWER_CONSUMPTION] = 
-        getPower(g_protocol_rx.data[OFFS_COOL_POWER_CONSUMPTION]);
-    mb_input_registers[MB_INPUT_DHW_POWER_PRODUCTION] = getPower(g_protocol_rx.data[OFFS_DHW_POWER_PRODUCTION]);
-    mb_input_registers[MB_INPUT_DHW_POWER_CONSUMPTION_CPY] = mb_input_registers[MB_INPUT_DHW_POWER_CONSUMPTION] = 
-        getPower(g_protocol_rx.data[OFFS_DHW_POWER_CONSUMPTION]);
-    
-    // Operation states
-    mb_input_registers[MB_INPUT_STATUS] = getBit7and8(g_protocol_rx.data[OFFS_HEATPUMP_STATE]);
-    mb_input_registers[MB_INPUT_HEATPUMP_STATE_CPY] = mb_input_registers[MB_INPUT_HEATPUMP_STATE] = 
-        getBit7and8(g_protocol_rx.data[OFFS_HEATPUMP_STATE]);
-    mb_input_registers[MB_INPUT_FORCE_DHW_STATE_CPY] = mb_input_registers[MB_INPUT_FORCE_DHW_STATE] = 
-        getBit1and2(g_protocol_rx.data[OFFS_FORCE_DHW_STATE]);
-    mb_input_registers[MB_INPUT_OPERATING_MODE_STATE_CPY] = mb_input_registers[MB_INPUT_OPERATING_MODE_STATE] = 
-        getOpMode(g_protocol_rx.data[OFFS_OPERATING_MODE_STATE]);
-    mb_input_registers[MB_INPUT_QUIET_MODE_SCHEDULE] = getBit1and2(g_protocol_rx.data[OFFS_QUIET_MODE_SCHEDULE]);
-    mb_input_registers[MB_INPUT_POWERFUL_MODE_TIME] = getRight3bits(g_protocol_rx.data[OFFS_POWERFUL_MODE_TIME]);
-    mb_input_registers[MB_INPUT_QUIET_MODE_LEVEL] = getBit3and4and5(g_protocol_rx.data[OFFS_QUIET_MODE_LEVEL]);
-    mb_input_registers[MB_INPUT_HOLIDAY_MODE_STATE] = getBit3and4(g_protocol_rx.data[OFFS_HOLIDAY_MODE_STATE]);
-    mb_input_registers[MB_INPUT_THREE_WAY_VALVE_STATE_CPY] = mb_input_registers[MB_INPUT_THREE_WAY_VALVE_STATE] = 
-        getBit7and8(g_protocol_rx.data[OFFS_THREE_WAY_VALVE_STATE]);
-    mb_input_registers[MB_INPUT_DEFROSTING_STATE_CPY] = mb_input_registers[MB_INPUT_DEFROSTING_STATE] = 
-        getBit5and6(g_protocol_rx.data[OFFS_DEFROSTING_STATE]);
-    mb_input_registers[MB_INPUT_ZONES_STATE] = getBit1and2(g_protocol_rx.data[OFFS_ZONES_STATE]);
     
-    // Technical parameters
-    mb_input_registers[MB_INPUT_COMPRESSOR_FREQ_CPY] = mb_input_registers[MB_INPUT_COMPRESSOR_FREQ] = 
-        getIntMinus1(g_protocol_rx.data[OFFS_COMPRESSOR_FREQ]);
-    mb_input_registers[MB_INPUT_PUMP_FLOW_CPY] = mb_input_registers[MB_INPUT_PUMP_FLOW] = 
-        getPumpFlow(); // Special case - needs full function
-    mb_input_registers[MB_INPUT_OPERATIONS_HOURS_CPY] = mb_input_registers[MB_INPUT_OPERATIONS_HOURS] = 
-        getUint16(OFFS_OPERATIONS_HOURS);
-    mb_input_registers[MB_INPUT_OPERATIONS_COUNTER_CPY] = mb_input_registers[MB_INPUT_OPERATIONS_COUNTER] = 
-        getUint16(OFFS_OPERATIONS_COUNTER);
-    
-    // Additional temperatures (stored as int8_t, write as int16_t)
-    mb_input_registers[MB_INPUT_MAIN_HEX_OUTLET_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_MAIN_HEX_OUTLET_TEMP]);
-    mb_input_registers[MB_INPUT_DISCHARGE_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_DISCHARGE_TEMP]);
-    mb_input_registers[MB_INPUT_INSIDE_PIPE_TEMP_CPY] = mb_input_registers[MB_INPUT_INSIDE_PIPE_TEMP] = 
-        getIntMinus128(g_protocol_rx.data[OFFS_INSIDE_PIPE_TEMP]);
-    mb_input_registers[MB_INPUT_DEFROST_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_DEFROST_TEMP]);
-    mb_input_registers[MB_INPUT_EVA_OUTLET_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_EVA_OUTLET_TEMP]);
-    mb_input_registers[MB_INPUT_BYPASS_OUTLET_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_BYPASS_OUTLET_TEMP]);
-    mb_input_registers[MB_INPUT_IPM_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_IPM_TEMP]);
-    mb_input_registers[MB_INPUT_OUTSIDE_PIPE_TEMP_CPY] = mb_input_registers[MB_INPUT_OUTSIDE_PIPE_TEMP] = 
-        getIntMinus128(g_protocol_rx.data[OFFS_OUTSIDE_PIPE_TEMP]);
-    mb_input_registers[MB_INPUT_Z1_ROOM_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_TEMP]);
-    mb_input_registers[MB_INPUT_Z2_ROOM_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_TEMP]);
-    mb_input_registers[MB_INPUT_Z1_WATER_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_WATER_TEMP]);
-    mb_input_registers[MB_INPUT_Z2_WATER_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_WATER_TEMP]);
-    mb_input_registers[MB_INPUT_Z1_WATER_TARGET_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_WATER_TARGET_TEMP]);
-    mb_input_registers[MB_INPUT_Z2_WATER_TARGET_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_WATER_TARGET_TEMP]);
-    mb_input_registers[MB_INPUT_SECOND_INLET_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_SECOND_INLET_TEMP]);
-    mb_input_registers[MB_INPUT_ECONOMIZER_OUTLET_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_ECONOMIZER_OUTLET_TEMP]);
-    mb_input_registers[MB_INPUT_SECOND_ROOM_THERMO_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_SECOND_ROOM_THERMOSTAT_TEMP]);
-    
-    // Zone request temperatures (stored as int8_t, write as int16_t)
-    mb_input_registers[MB_INPUT_Z1_HEAT_REQUEST_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_HEAT_REQUEST_TEMP]);
-    mb_input_registers[MB_INPUT_Z1_COOL_REQUEST_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_COOL_REQUEST_TEMP]);
-    mb_input_registers[MB_INPUT_Z2_HEAT_REQUEST_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_HEAT_REQUEST_TEMP]);
-    mb_input_registers[MB_INPUT_Z2_COOL_REQUEST_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_COOL_REQUEST_TEMP]);
-    
-    // Zone curve settings (stored as int8_t, write as int16_t)
-    mb_input_registers[MB_INPUT_Z1_HEAT_CURVE_TARGET_HIGH] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_HEAT_CURVE_TARGET_HIGH]);
-    mb_input_registers[MB_INPUT_Z1_HEAT_CURVE_TARGET_LOW] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_HEAT_CURVE_TARGET_LOW]);
-    mb_input_registers[MB_INPUT_Z1_HEAT_CURVE_OUTSIDE_HIGH] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_HEAT_CURVE_OUTSIDE_HIGH]);
-    mb_input_registers[MB_INPUT_Z1_HEAT_CURVE_OUTSIDE_LOW] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_HEAT_CURVE_OUTSIDE_LOW]);
-    mb_input_registers[MB_INPUT_Z1_COOL_CURVE_TARGET_HIGH] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_COOL_CURVE_TARGET_HIGH]);
-    mb_input_registers[MB_INPUT_Z1_COOL_CURVE_TARGET_LOW] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_COOL_CURVE_TARGET_LOW]);
-    mb_input_registers[MB_INPUT_Z1_COOL_CURVE_OUTSIDE_HIGH] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_COOL_CURVE_OUTSIDE_HIGH]);
-    mb_input_registers[MB_INPUT_Z1_COOL_CURVE_OUTSIDE_LOW] = getIntMinus128(g_protocol_rx.data[OFFS_Z1_COOL_CURVE_OUTSIDE_LOW]);
-    mb_input_registers[MB_INPUT_Z2_HEAT_CURVE_TARGET_HIGH] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_HEAT_CURVE_TARGET_HIGH]);
-    mb_input_registers[MB_INPUT_Z2_HEAT_CURVE_TARGET_LOW] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_HEAT_CURVE_TARGET_LOW]);
-    mb_input_registers[MB_INPUT_Z2_HEAT_CURVE_OUTSIDE_HIGH] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_HEAT_CURVE_OUTSIDE_HIGH]);
-    mb_input_registers[MB_INPUT_Z2_HEAT_CURVE_OUTSIDE_LOW] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_HEAT_CURVE_OUTSIDE_LOW]);
-    mb_input_registers[MB_INPUT_Z2_COOL_CURVE_TARGET_HIGH] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_COOL_CURVE_TARGET_HIGH]);
-    mb_input_registers[MB_INPUT_Z2_COOL_CURVE_TARGET_LOW] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_COOL_CURVE_TARGET_LOW]);
-    mb_input_registers[MB_INPUT_Z2_COOL_CURVE_OUTSIDE_HIGH] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_COOL_CURVE_OUTSIDE_HIGH]);
-    mb_input_registers[MB_INPUT_Z2_COOL_CURVE_OUTSIDE_LOW] = getIntMinus128(g_protocol_rx.data[OFFS_Z2_COOL_CURVE_OUTSIDE_LOW]);
-    
-    // Additional operation states
-    mb_input_registers[MB_INPUT_MAIN_SCHEDULE_STATE] = getBit1and2(g_protocol_rx.data[OFFS_MAIN_SCHEDULE_STATE]);
+    // Pump flow uses bytes 169-170
+    if (decode_bytes_changed(changed, OFFS_PUMP_FLOW_FRACTIONAL, 2)) {
+        int16_t pump_flow = getPumpFlow();
+        decode_store(MB_INPUT_PUMP_FLOW, pump_flow, &count);
+    }
     
-    // Technical parameters
-    mb_input_registers[MB_INPUT_FAN1_MOTOR_SPEED] = getIntMinus1Times10(g_protocol_rx.data[OFFS_FAN1_MOTOR_SPEED]);
-    mb_input_registers[MB_INPUT_FAN2_MOTOR_SPEED] = getIntMinus1Times10(g_protocol_rx.data[OFFS_FAN2_MOTOR_SPEED]);
-    mb_input_registers[MB_INPUT_HIGH_PRESSURE] = getIntMinus1Div5(g_protocol_rx.data[OFFS_HIGH_PRESSURE]);
-    mb_input_registers[MB_INPUT_PUMP_SPEED_CPY] = mb_input_registers[MB_INPUT_PUMP_SPEED] = 
-        getIntMinus1Times50(g_protocol_rx.data[OFFS_PUMP_SPEED]);
-    mb_input_registers[MB_INPUT_LOW_PRESSURE] = getIntMinus1Times50(g_protocol_rx.data[OFFS_LOW_PRESSURE]);
-    mb_input_registers[MB_INPUT_COMPRESSOR_CURRENT_CPY] = mb_input_registers[MB_INPUT_COMPRESSOR_CURRENT] = 
-        getIntMinus1Div5(g_protocol_rx.data[OFFS_COMPRESSOR_CURRENT]);
-    mb_input_registers[MB_INPUT_PUMP_DUTY_CPY] = mb_input_registers[MB_INPUT_PUMP_DUTY] =
-        getIntMinus1(g_protocol_rx.data[OFFS_PUMP_DUTY]);
-    mb_input_registers[MB_INPUT_MAX_PUMP_DUTY] = getIntMinus1(g_protocol_rx.data[OFFS_MAX_PUMP_DUTY]);
-    
-    // Heater states
-    mb_input_registers[MB_INPUT_DHW_HEATER_STATE] = getBit5and6(g_protocol_rx.data[OFFS_DHW_HEATER_STATE]);
-    mb_input_registers[MB_INPUT_ROOM_HEATER_STATE] = getBit7and8(g_protocol_rx.data[OFFS_ROOM_HEATER_STATE]);
-    mb_input_registers[MB_INPUT_INTERNAL_HEATER_STATE] = getBit7and8(g_protocol_rx.data[OFFS_INTERNAL_HEATER_STATE]);
-    mb_input_registers[MB_INPUT_EXTERNAL_HEATER_STATE] = getBit5and6(g_protocol_rx.data[OFFS_EXTERNAL_HEATER_STATE]);
-    mb_input_registers[MB_INPUT_FORCE_HEATER_STATE] = getBit5and6(g_protocol_rx.data[OFFS_FORCE_HEATER_STATE]);
-    mb_input_registers[MB_INPUT_STERILIZATION_STATE] = getBit5and6(g_protocol_rx.data[OFFS_STERILIZATION_STATE]);
-    mb_input_registers[MB_INPUT_STERILIZATION_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_STERILIZATION_TEMP]);
-    mb_input_registers[MB_INPUT_STERILIZATION_MAX_TIME] = getIntMinus1(g_protocol_rx.data[OFFS_STERILIZATION_MAX_TIME]);
-    
-    // Deltas and shifts (stored as int16_t * 100)
-    mb_input_registers[MB_INPUT_DHW_HEAT_DELTA] = getIntMinus128(g_protocol_rx.data[OFFS_DHW_HEAT_DELTA]);
-    mb_input_registers[MB_INPUT_HEAT_DELTA] = getIntMinus128(g_protocol_rx.data[OFFS_HEAT_DELTA]);
-    mb_input_registers[MB_INPUT_COOL_DELTA] = getIntMinus128(g_protocol_rx.data[OFFS_COOL_DELTA]);
-    mb_input_registers[MB_INPUT_DHW_HOLIDAY_SHIFT_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_DHW_HOLIDAY_SHIFT_TEMP]);
-    mb_input_registers[MB_INPUT_ROOM_HOLIDAY_SHIFT_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_ROOM_HOLIDAY_SHIFT_TEMP]);
-    mb_input_registers[MB_INPUT_BUFFER_TANK_DELTA] = getIntMinus128(g_protocol_rx.data[OFFS_BUFFER_TANK_DELTA]);
-    
-    // Mode settings
-    mb_input_registers[MB_INPUT_HEATING_MODE_CPY] = mb_input_registers[MB_INPUT_HEATING_MODE] =
-        getBit7and8(g_protocol_rx.data[OFFS_HEATING_MODE]);
-    mb_input_registers[MB_INPUT_HEATING_OFF_OUTDOOR_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_HEATING_OFF_OUTDOOR_TEMP]);
-    mb_input_registers[MB_INPUT_HEATER_ON_OUTDOOR_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_HEATER_ON_OUTDOOR_TEMP]);
-    mb_input_registers[MB_INPUT_HEAT_TO_COOL_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_HEAT_TO_COOL_TEMP]);
-    mb_input_registers[MB_INPUT_COOL_TO_HEAT_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_COOL_TO_HEAT_TEMP]);
-    mb_input_registers[MB_INPUT_COOLING_MODE_CPY] = mb_input_registers[MB_INPUT_COOLING_MODE] =
-        getBit5and6(g_protocol_rx.data[OFFS_COOLING_MODE]);
-    
-    // Solar and buffer settings
-    mb_input_registers[MB_INPUT_BUFFER_INSTALLED] = getBit5and6(g_protocol_rx.data[OFFS_BUFFER_INSTALLED]);
-    mb_input_registers[MB_INPUT_DHW_INSTALLED] = getBit7and8(g_protocol_rx.data[OFFS_DHW_INSTALLED]);
-    mb_input_registers[MB_INPUT_SOLAR_MODE] = getBit3and4(g_protocol_rx.data[OFFS_SOLAR_MODE]);
-    mb_input_registers[MB_INPUT_SOLAR_ON_DELTA] = getIntMinus128(g_protocol_rx.data[OFFS_SOLAR_ON_DELTA]);
-    mb_input_registers[MB_INPUT_SOLAR_OFF_DELTA] = getIntMinus128(g_protocol_rx.data[OFFS_SOLAR_OFF_DELTA]);
-    mb_input_registers[MB_INPUT_SOLAR_FROST_PROTECTION] = getIntMinus128(g_protocol_rx.data[OFFS_SOLAR_FROST_PROTECTION]);
-    mb_input_registers[MB_INPUT_SOLAR_HIGH_LIMIT] = getIntMinus128(g_protocol_rx.data[OFFS_SOLAR_HIGH_LIMIT]);
-    
-    // Pump and liquid settings
-    mb_input_registers[MB_INPUT_PUMP_FLOWRATE_MODE] = getBit3and4(g_protocol_rx.data[OFFS_PUMP_FLOWRATE_MODE]);
-    mb_input_registers[MB_INPUT_LIQUID_TYPE] = getBit1(g_protocol_rx.data[OFFS_LIQUID_TYPE]);
-    mb_input_registers[MB_INPUT_ALT_EXTERNAL_SENSOR] = getBit3and4(g_protocol_rx.data[OFFS_ALT_EXTERNAL_SENSOR]);
-    mb_input_registers[MB_INPUT_ANTI_FREEZE_MODE] = getBit5and6(g_protocol_rx.data[OFFS_ANTI_FREEZE_MODE]);
-    mb_input_registers[MB_INPUT_OPTIONAL_PCB] = getBit7and8(g_protocol_rx.data[OFFS_OPTIONAL_PCB]);
-    
-    // Zone sensor settings
-    mb_input_registers[MB_INPUT_Z1_SENSOR_SETTINGS] = getSecondByte(g_protocol_rx.data[OFFS_Z1_SENSOR_SETTINGS]);
-    mb_input_registers[MB_INPUT_Z2_SENSOR_SETTINGS] = getFirstByte(g_protocol_rx.data[OFFS_Z2_SENSOR_SETTINGS]);
-    
-    // External controls
-    mb_input_registers[MB_INPUT_EXTERNAL_PAD_HEATER] = getBit3and4(g_protocol_rx.data[OFFS_EXTERNAL_PAD_HEATER]);
-    mb_input_registers[MB_INPUT_WATER_PRESSURE_CPY] = mb_input_registers[MB_INPUT_WATER_PRESSURE] = 
-        getIntMinus1Div50(g_protocol_rx.data[OFFS_WATER_PRESSURE]);
-    mb_input_registers[MB_INPUT_EXTERNAL_CONTROL_CPY] = mb_input_registers[MB_INPUT_EXTERNAL_CONTROL] = 
-        getBit7and8(g_protocol_rx.data[OFFS_EXTERNAL_CONTROL]);
-    mb_input_registers[MB_INPUT_EXTERNAL_HEAT_COOL_CONTROL] = getBit5and6(g_protocol_rx.data[OFFS_EXTERNAL_HEAT_COOL_CONTROL]);
-    mb_input_registers[MB_INPUT_EXTERNAL_ERROR_SIGNAL_CPY] = mb_input_registers[MB_INPUT_EXTERNAL_ERROR_SIGNAL] = 
-        getBit3and4(g_protocol_rx.data[OFFS_EXTERNAL_ERROR_SIGNAL]);
-    mb_input_registers[MB_INPUT_EXTERNAL_COMPRESSOR_CONTROL] = getBit1and2(g_protocol_rx.data[OFFS_EXTERNAL_COMPRESSOR_CONTROL]);
-    
-    // Pump states
-    mb_input_registers[MB_INPUT_Z2_PUMP_STATE] = getBit1and2(g_protocol_rx.data[OFFS_Z2_PUMP_STATE]);
-    mb_input_registers[MB_INPUT_Z1_PUMP_STATE] = getBit3and4(g_protocol_rx.data[OFFS_Z1_PUMP_STATE]);
-    mb_input_registers[MB_INPUT_TWO_WAY_VALVE_STATE_CPY] = mb_input_registers[MB_INPUT_TWO_WAY_VALVE_STATE] = 
-        getBit5and6(g_protocol_rx.data[OFFS_TWOWAY_VALVE_STATE]);
-    mb_input_registers[MB_INPUT_THREE_WAY_VALVE_STATE2_CPY] = mb_input_registers[MB_INPUT_THREE_WAY_VALVE_STATE2] = 
-        getBit7and8(g_protocol_rx.data[OFFS_THREEWAY_VALVE_STATE2]);
-    
-    // Valve PID settings (stored as int16_t * 100)
-    mb_input_registers[MB_INPUT_Z1_VALVE_PID] = getValvePID(g_protocol_rx.data[OFFS_Z1_VALVE_PID]);
-    mb_input_registers[MB_INPUT_Z2_VALVE_PID] = getValvePID(g_protocol_rx.data[OFFS_Z2_VALVE_PID]);
-    
-    // Bivalent settings
-    mb_input_registers[MB_INPUT_BIVALENT_CONTROL] = getBit7and8(g_protocol_rx.data[OFFS_BIVALENT_CONTROL]);
-    mb_input_registers[MB_INPUT_BIVALENT_MODE] = getBit5and6(g_protocol_rx.data[OFFS_BIVALENT_MODE]);
-    mb_input_registers[MB_INPUT_BIVALENT_START_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_BIVALENT_START_TEMP]);
-    mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_HEAT] = getBit3and4(g_protocol_rx.data[OFFS_BIVALENT_ADV_HEAT]);
-    mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_DHW] = getBit1and2(g_protocol_rx.data[OFFS_BIVALENT_ADV_DHW]);
-    mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_START_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_BIVALENT_ADV_START_TEMP]);
-    mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_STOP_TEMP] = getIntMinus128(g_protocol_rx.data[OFFS_BIVALENT_ADV_STOP_TEMP]);
-    mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_START_DELAY] = getIntMinus1(g_protocol_rx.data[OFFS_BIVALENT_ADV_START_DELAY]);
-    mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_STOP_DELAY] = getIntMinus1(g_protocol_rx.data[OFFS_BIVALENT_ADV_STOP_DELAY]);
-    mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_DHW_DELAY] = getIntMinus1(g_protocol_rx.data[OFFS_BIVALENT_ADV_DHW_DELAY]);
-    
-    // Timing settings
-    mb_input_registers[MB_INPUT_HEATER_DELAY_TIME] = getIntMinus1(g_protocol_rx.data[OFFS_HEATER_DELAY_TIME]);
-    mb_input_registers[MB_INPUT_HEATER_START_DELTA] = getIntMinus128(g_protocol_rx.data[OFFS_HEATER_START_DELTA]);
-    mb_input_registers[MB_INPUT_HEATER_STOP_DELTA] = getIntMinus128(g_protocol_rx.data[OFFS_HEATER_STOP_DELTA]);
-    
-    // Operation hours
-    mb_input_registers[MB_INPUT_ROOM_HEATER_OPS_HOURS] = getUint16(OFFS_ROOM_HEATER_OPERATIONS_HOURS);
-    mb_input_registers[MB_INPUT_DHW_HEATER_OPS_HOURS] = getUint16(OFFS_DHW_HEATER_OPERATIONS_HOURS);
-    
-    // Error and model (string topics) — write directly to Modbus registers
-    {
-        // Error string is at bytes 113-114 (Error_type and Error_number)
+    // Error string is at bytes 113-114 (Error_type and Error_number)
+    if (decode_bytes_changed(changed, OFFS_ERROR_TYPE, 2)) {
         int error_type = (int)(g_protocol_rx.data[OFFS_ERROR_TYPE]);
         int error_number = ((int)(g_protocol_rx.data[OFFS_ERROR_NUMBER])) - 17;
+        int16_t type_reg = 0;
+        int16_t number_reg = 0;
         if (error_type == 177) { // B1=F type error
-            mb_input_registers[MB_INPUT_ERROR_TYPE_CPY] = mb_input_registers[MB_INPUT_ERROR_TYPE] = (int)'F';
-            mb_input_registers[MB_INPUT_ERROR_NUMBER_CPY] = mb_input_registers[MB_INPUT_ERROR_NUMBER] = error_number;
+            type_reg = (int16_t)'F';
+            number_reg = error_number;
         } else if (error_type == 161) { // A1=H type error
-            mb_input_registers[MB_INPUT_ERROR_TYPE_CPY] = mb_input_registers[MB_INPUT_ERROR_TYPE] = (int)'H';
-            mb_input_registers[MB_INPUT_ERROR_NUMBER_CPY] = mb_input_registers[MB_INPUT_ERROR_NUMBER] = error_number;
-        } else {
-            mb_input_registers[MB_INPUT_ERROR_TYPE_CPY] = mb_input_registers[MB_INPUT_ERROR_TYPE] = 0;
-            mb_input_registers[MB_INPUT_ERROR_NUMBER_CPY] = mb_input_registers[MB_INPUT_ERROR_NUMBER] = 0;
+            type_reg = (int16_t)'H';
+            number_reg = error_number;
         }
+        decode_store(MB_INPUT_ERROR_TYPE, type_reg, &count);
+        decode_store(MB_INPUT_ERROR_NUMBER, number_reg, &count);
     }
+    
     // Model string is at bytes 129-138 (10 bytes)
-    {
+    if (decode_bytes_changed(changed, OFFS_HP_MODEL_0, 10)) {
         int data_offset = OFFS_HP_MODEL_0;
         for(int i = 0; i < 5; i++) {
-            mb_input_registers[MB_INPUT_HP_MODEL_0 + i] = (g_protocol_rx.data[data_offset] << 8) | g_protocol_rx.data[data_offset + 1];
+            decode_store(MB_INPUT_HP_MODEL_0 + i, (int16_t)((g_protocol_rx.data[data_offset] << 8) | g_protocol_rx.data[data_offset + 1]), &count);
             data_offset += 2;
         }
     }
     
-    ESP_LOGD(TAG, "Main data decoded successfully");
+    if (updated != NULL) {
+        *updated = count;
+    }
+    ESP_LOGD(TAG, "Main data decoded successfully (%d registers changed)", (int)count);
     return ESP_OK;
 }
 
@@ -545,12 +645,12 @@ esp_err_t decode_extra_data(void) {
     ESP_LOGD(TAG, "Decoding extra data");
     
     // Decode directly into Modbus input registers (uint16_t -> int16_t, compatible)
-    mb_input_registers[MB_INPUT_HEAT_POWER_CONSUMPTION_EXTRA] = getUint16(OFFS_XTOP_HEAT_POWER_CONSUMPTION_EXTRA);
-    mb_input_registers[MB_INPUT_COOL_POWER_CONSUMPTION_EXTRA] = getUint16(OFFS_XTOP_COOL_POWER_CONSUMPTION_EXTRA);
-    mb_input_registers[MB_INPUT_DHW_POWER_CONSUMPTION_EXTRA] = getUint16(OFFS_XTOP_DHW_POWER_CONSUMPTION_EXTRA);
-    mb_input_registers[MB_INPUT_HEAT_POWER_PRODUCTION_EXTRA] = getUint16(OFFS_XTOP_HEAT_POWER_PRODUCTION_EXTRA);
-    mb_input_registers[MB_INPUT_COOL_POWER_PRODUCTION_EXTRA] = getUint16(OFFS_XTOP_COOL_POWER_PRODUCTION_EXTRA);
-    mb_input_registers[MB_INPUT_DHW_POWER_PRODUCTION_EXTRA] = getUint16(OFFS_XTOP_DHW_POWER_PRODUCTION_EXTRA);
+    mb_input_registers_back[MB_INPUT_HEAT_POWER_CONSUMPTION_EXTRA] = getUint16(OFFS_XTOP_HEAT_POWER_CONSUMPTION_EXTRA);
+    mb_input_registers_back[MB_INPUT_COOL_POWER_CONSUMPTION_EXTRA] = getUint16(OFFS_XTOP_COOL_POWER_CONSUMPTION_EXTRA);
+    mb_input_registers_back[MB_INPUT_DHW_POWER_CONSUMPTION_EXTRA] = getUint16(OFFS_XTOP_DHW_POWER_CONSUMPTION_EXTRA);
+    mb_input_registers_back[MB_INPUT_HEAT_POWER_PRODUCTION_EXTRA] = getUint16(OFFS_XTOP_HEAT_POWER_PRODUCTION_EXTRA);
+    mb_input_registers_back[MB_INPUT_COOL_POWER_PRODUCTION_EXTRA] = getUint16(OFFS_XTOP_COOL_POWER_PRODUCTION_EXTRA);
+    mb_input_registers_back[MB_INPUT_DHW_POWER_PRODUCTION_EXTRA] = getUint16(OFFS_XTOP_DHW_POWER_PRODUCTION_EXTRA);
     
     ESP_LOGD(TAG, "Extra data decoded successfully");
     return ESP_OK;
@@ -567,13 +667,13 @@ esp_err_t decode_opt_data(void) {
     uint8_t opt_data = g_protocol_rx.data[OFFS_OPT_PCB_DATA];
     
     // Decode directly into Modbus input registers (uint8_t -> int16_t)
-    mb_input_registers[MB_INPUT_Z1_WATER_PUMP] = (int16_t)((opt_data >> 7) & 0x01);
-    mb_input_registers[MB_INPUT_Z1_MIXING_VALVE] = (int16_t)((opt_data >> 5) & 0x03);
-    mb_input_registers[MB_INPUT_Z2_WATER_PUMP] = (int16_t)((opt_data >> 4) & 0x01);
-    mb_input_registers[MB_INPUT_Z2_MIXING_VALVE] = (int16_t)((opt_data >> 2) & 0x03);
-    mb_input_registers[MB_INPUT_POOL_WATER_PUMP] = (int16_t)((opt_data >> 1) & 0x01);
-    mb_input_registers[MB_INPUT_SOLAR_WATER_PUMP] = (int16_t)((opt_data >> 0) & 0x01);
-    mb_input_registers[MB_INPUT_ALARM_STATE] = (int16_t)((opt_data >> 3) & 0x01);
+    mb_input_registers_back[MB_INPUT_Z1_WATER_PUMP] = (int16_t)((opt_data >> 7) & 0x01);
+    mb_input_registers_back[MB_INPUT_Z1_MIXING_VALVE] = (int16_t)((opt_data >> 5) & 0x03);
+    mb_input_registers_back[MB_INPUT_Z2_WATER_PUMP] = (int16_t)((opt_data >> 4) & 0x01);
+    mb_input_registers_back[MB_INPUT_Z2_MIXING_VALVE] = (int16_t)((opt_data >> 2) & 0x03);
+    mb_input_registers_back[MB_INPUT_POOL_WATER_PUMP] = (int16_t)((opt_data >> 1) & 0x01);
+    mb_input_registers_back[MB_INPUT_SOLAR_WATER_PUMP] = (int16_t)((opt_data >> 0) & 0x01);
+    mb_input_registers_back[MB_INPUT_ALARM_STATE] = (int16_t)((opt_data >> 3) & 0x01);
     
     ESP_LOGD(TAG, "Optional data decoded successfully (written directly to Modbus registers)");
     return ESP_OK;
@@ -583,190 +683,190 @@ void log_main_data(void) {
     ESP_LOGI(TAG, "=== DECODED MAIN DATA ===");
     
     // Main temperatures
-    ESP_LOGI(TAG, "main_inlet_temp: %d", mb_input_registers[MB_INPUT_MAIN_INLET_TEMP]);
-    ESP_LOGI(TAG, "main_outlet_temp: %d", mb_input_registers[MB_INPUT_MAIN_OUTLET_TEMP]);
-    ESP_LOGI(TAG, "main_target_temp: %d", mb_input_registers[MB_INPUT_MAIN_TARGET_TEMP]);
-    ESP_LOGI(TAG, "dhw_temp: %d", mb_input_registers[MB_INPUT_DHW_TEMP]);
-    ESP_LOGI(TAG, "dhw_target_temp: %d", mb_input_registers[MB_INPUT_DHW_TARGET_TEMP]);
-    ESP_LOGI(TAG, "outside_temp: %d", mb_input_registers[MB_INPUT_OUTSIDE_TEMP]);
-    ESP_LOGI(TAG, "room_thermostat_temp: %d", mb_input_registers[MB_INPUT_ROOM_THERMOSTAT_TEMP]);
-    ESP_LOGI(TAG, "buffer_temp: %d", mb_input_registers[MB_INPUT_BUFFER_TEMP]);
-    ESP_LOGI(TAG, "solar_temp: %d", mb_input_registers[MB_INPUT_SOLAR_TEMP]);
-    ESP_LOGI(TAG, "pool_temp: %d", mb_input_registers[MB_INPUT_POOL_TEMP]);
+    ESP_LOGI(TAG, "main_inlet_temp: %d", mb_input_registers_back[MB_INPUT_MAIN_INLET_TEMP]);
+    ESP_LOGI(TAG, "main_outlet_temp: %d", mb_input_registers_back[MB_INPUT_MAIN_OUTLET_TEMP]);
+    ESP_LOGI(TAG, "main_target_temp: %d", mb_input_registers_back[MB_INPUT_MAIN_TARGET_TEMP]);
+    ESP_LOGI(TAG, "dhw_temp: %d", mb_input_registers_back[MB_INPUT_DHW_TEMP]);
+    ESP_LOGI(TAG, "dhw_target_temp: %d", mb_input_registers_back[MB_INPUT_DHW_TARGET_TEMP]);
+    ESP_LOGI(TAG, "outside_temp: %d", mb_input_registers_back[MB_INPUT_OUTSIDE_TEMP]);
+    ESP_LOGI(TAG, "room_thermostat_temp: %d", mb_input_registers_back[MB_INPUT_ROOM_THERMOSTAT_TEMP]);
+    ESP_LOGI(TAG, "buffer_temp: %d", mb_input_registers_back[MB_INPUT_BUFFER_TEMP]);
+    ESP_LOGI(TAG, "solar_temp: %d", mb_input_registers_back[MB_INPUT_SOLAR_TEMP]);
+    ESP_LOGI(TAG, "pool_temp: %d", mb_input_registers_back[MB_INPUT_POOL_TEMP]);
     
     // Power data
-    ESP_LOGI(TAG, "heat_power_production: %u", (uint16_t)mb_input_registers[MB_INPUT_HEAT_POWER_PRODUCTION]);
-    ESP_LOGI(TAG, "heat_power_consumption: %u", (uint16_t)mb_input_registers[MB_INPUT_HEAT_POWER_CONSUMPTION]);
-    ESP_LOGI(TAG, "cool_power_production: %u", (uint16_t)mb_input_registers[MB_INPUT_COOL_POWER_PRODUCTION]);
-    ESP_LOGI(TAG, "cool_power_consumption: %u", (uint16_t)mb_input_registers[MB_INPUT_COOL_POWER_CONSUMPTION]);
-    ESP_LOGI(TAG, "dhw_power_production: %u", (uint16_t)mb_input_registers[MB_INPUT_DHW_POWER_PRODUCTION]);
-    ESP_LOGI(TAG, "dhw_power_consumption: %u", (uint16_t)mb_input_registers[MB_INPUT_DHW_POWER_CONSUMPTION]);
+    ESP_LOGI(TAG, "heat_power_production: %u", (uint16_t)mb_input_registers_back[MB_INPUT_HEAT_POWER_PRODUCTION]);
+    ESP_LOGI(TAG, "heat_power_consumption: %u", (uint16_t)mb_input_registers_back[MB_INPUT_HEAT_POWER_CONSUMPTION]);
+    ESP_LOGI(TAG, "cool_power_production: %u", (uint16_t)mb_input_registers_back[MB_INPUT_COOL_POWER_PRODUCTION]);
+    ESP_LOGI(TAG, "cool_power_consumption: %u", (uint16_t)mb_input_registers_back[MB_INPUT_COOL_POWER_CONSUMPTION]);
+    ESP_LOGI(TAG, "dhw_power_production: %u", (uint16_t)mb_input_registers_back[MB_INPUT_DHW_POWER_PRODUCTION]);
+    ESP_LOGI(TAG, "dhw_power_consumption: %u", (uint16_t)mb_input_registers_back[MB_INPUT_DHW_POWER_CONSUMPTION]);
     
     // States
-    ESP_LOGI(TAG, "heatpump_state: %u", (uint16_t)mb_input_registers[MB_INPUT_HEATPUMP_STATE]);
-    ESP_LOGI(TAG, "force_dhw_state: %u", (uint16_t)mb_input_registers[MB_INPUT_FORCE_DHW_STATE]);
-    ESP_LOGI(TAG, "operating_mode_state: %u", (uint16_t)mb_input_registers[MB_INPUT_OPERATING_MODE_STATE]);
-    ESP_LOGI(TAG, "quiet_mode_schedule: %u", (uint16_t)mb_input_registers[MB_INPUT_QUIET_MODE_SCHEDULE]);
-    ESP_LOGI(TAG, "powerful_mode_time: %u", (uint16_t)mb_input_registers[MB_INPUT_POWERFUL_MODE_TIME]);
-    ESP_LOGI(TAG, "quiet_mode_level: %u", (uint16_t)mb_input_registers[MB_INPUT_QUIET_MODE_LEVEL]);
-    ESP_LOGI(TAG, "holiday_mode_state: %u", (uint16_t)mb_input_registers[MB_INPUT_HOLIDAY_MODE_STATE]);
-    ESP_LOGI(TAG, "three_way_valve_state: %u", (uint16_t)mb_input_registers[MB_INPUT_THREE_WAY_VALVE_STATE]);
-    ESP_LOGI(TAG, "defrosting_state: %u", (uint16_t)mb_input_registers[MB_INPUT_DEFROSTING_STATE]);
-    ESP_LOGI(TAG, "main_schedule_state: %u", (uint16_t)mb_input_registers[MB_INPUT_MAIN_SCHEDULE_STATE]);
-    ESP_LOGI(TAG, "zones_state: %u", (uint16_t)mb_input_registers[MB_INPUT_ZONES_STATE]);
+    ESP_LOGI(TAG, "heatpump_state: %u", (uint16_t)mb_input_registers_back[MB_INPUT_HEATPUMP_STATE]);
+    ESP_LOGI(TAG, "force_dhw_state: %u", (uint16_t)mb_input_registers_back[MB_INPUT_FORCE_DHW_STATE]);
+    ESP_LOGI(TAG, "operating_mode_state: %u", (uint16_t)mb_input_registers_back[MB_INPUT_OPERATING_MODE_STATE]);
+    ESP_LOGI(TAG, "quiet_mode_schedule: %u", (uint16_t)mb_input_registers_back[MB_INPUT_QUIET_MODE_SCHEDULE]);
+    ESP_LOGI(TAG, "powerful_mode_time: %u", (uint16_t)mb_input_registers_back[MB_INPUT_POWERFUL_MODE_TIME]);
+    ESP_LOGI(TAG, "quiet_mode_level: %u", (uint16_t)mb_input_registers_back[MB_INPUT_QUIET_MODE_LEVEL]);
+    ESP_LOGI(TAG, "holiday_mode_state: %u", (uint16_t)mb_input_registers_back[MB_INPUT_HOLIDAY_MODE_STATE]);
+    ESP_LOGI(TAG, "three_way_valve_state: %u", (uint16_t)mb_input_registers_back[MB_INPUT_THREE_WAY_VALVE_STATE]);
+    ESP_LOGI(TAG, "defrosting_state: %u", (uint16_t)mb_input_registers_back[MB_INPUT_DEFROSTING_STATE]);
+    ESP_LOGI(TAG, "main_schedule_state: %u", (uint16_t)mb_input_registers_back[MB_INPUT_MAIN_SCHEDULE_STATE]);
+    ESP_LOGI(TAG, "zones_state: %u", (uint16_t)mb_input_registers_back[MB_INPUT_ZONES_STATE]);
     
     // Technical parameters
-    ESP_LOGI(TAG, "compressor_freq: %u", (uint16_t)mb_input_registers[MB_INPUT_COMPRESSOR_FREQ]);
-    ESP_LOGI(TAG, "pump_flow: %d", mb_input_registers[MB_INPUT_PUMP_FLOW]);
-    ESP_LOGI(TAG, "operations_hours: %u", (uint16_t)mb_input_registers[MB_INPUT_OPERATIONS_HOURS]);
-    ESP_LOGI(TAG, "operations_counter: %u", (uint16_t)mb_input_registers[MB_INPUT_OPERATIONS_COUNTER]);
-    ESP_LOGI(TAG, "fan1_motor_speed: %u", (uint16_t)mb_input_registers[MB_INPUT_FAN1_MOTOR_SPEED]);
-    ESP_LOGI(TAG, "fan2_motor_speed: %u", (uint16_t)mb_input_registers[MB_INPUT_FAN2_MOTOR_SPEED]);
-    ESP_LOGI(TAG, "high_pressure: %d", mb_input_registers[MB_INPUT_HIGH_PRESSURE]);
-    ESP_LOGI(TAG, "pump_speed: %u", (uint16_t)mb_input_registers[MB_INPUT_PUMP_SPEED]);
-    ESP_LOGI(TAG, "low_pressure: %d", mb_input_registers[MB_INPUT_LOW_PRESSURE]);
-    ESP_LOGI(TAG, "compressor_current: %d", mb_input_registers[MB_INPUT_COMPRESSOR_CURRENT]);
-    ESP_LOGI(TAG, "pump_duty: %u", (uint16_t)mb_input_registers[MB_INPUT_PUMP_DUTY]);
-    ESP_LOGI(TAG, "max_pump_duty: %u", (uint16_t)mb_input_registers[MB_INPUT_MAX_PUMP_DUTY]);
+    ESP_LOGI(TAG, "compressor_freq: %u", (uint16_t)mb_input_registers_back[MB_INPUT_COMPRESSOR_FREQ]);
+    ESP_LOGI(TAG, "pump_flow: %d", mb_input_registers_back[MB_INPUT_PUMP_FLOW]);
+    ESP_LOGI(TAG, "operations_hours: %u", (uint16_t)mb_input_registers_back[MB_INPUT_OPERATIONS_HOURS]);
+    ESP_LOGI(TAG, "operations_counter: %u", (uint16_t)mb_input_registers_back[MB_INPUT_OPERATIONS_COUNTER]);
+    ESP_LOGI(TAG, "fan1_motor_speed: %u", (uint16_t)mb_input_registers_back[MB_INPUT_FAN1_MOTOR_SPEED]);
+    ESP_LOGI(TAG, "fan2_motor_speed: %u", (uint16_t)mb_input_registers_back[MB_INPUT_FAN2_MOTOR_SPEED]);
+    ESP_LOGI(TAG, "high_pressure: %d", mb_input_registers_back[MB_INPUT_HIGH_PRESSURE]);
+    ESP_LOGI(TAG, "pump_speed: %u", (uint16_t)mb_input_registers_back[MB_INPUT_PUMP_SPEED]);
+    ESP_LOGI(TAG, "low_pressure: %d", mb_input_registers_back[MB_INPUT_LOW_PRESSURE]);
+    ESP_LOGI(TAG, "compressor_current: %d", mb_input_registers_back[MB_INPUT_COMPRESSOR_CURRENT]);
+    ESP_LOGI(TAG, "pump_duty: %u", (uint16_t)mb_input_registers_back[MB_INPUT_PUMP_DUTY]);
+    ESP_LOGI(TAG, "max_pump_duty: %u", (uint16_t)mb_input_registers_back[MB_INPUT_MAX_PUMP_DUTY]);
     
     // Extra temperatures
-    ESP_LOGI(TAG, "main_hex_outlet_temp: %d", mb_input_registers[MB_INPUT_MAIN_HEX_OUTLET_TEMP]);
-    ESP_LOGI(TAG, "discharge_temp: %d", mb_input_registers[MB_INPUT_DISCHARGE_TEMP]);
-    ESP_LOGI(TAG, "inside_pipe_temp: %d", mb_input_registers[MB_INPUT_INSIDE_PIPE_TEMP]);
-    ESP_LOGI(TAG, "defrost_temp: %d", mb_input_registers[MB_INPUT_DEFROST_TEMP]);
-    ESP_LOGI(TAG, "eva_outlet_temp: %d", mb_input_registers[MB_INPUT_EVA_OUTLET_TEMP]);
-    ESP_LOGI(TAG, "bypass_outlet_temp: %d", mb_input_registers[MB_INPUT_BYPASS_OUTLET_TEMP]);
-    ESP_LOGI(TAG, "ipm_temp: %d", mb_input_registers[MB_INPUT_IPM_TEMP]);
-    ESP_LOGI(TAG, "outside_pipe_temp: %d", mb_input_registers[MB_INPUT_OUTSIDE_PIPE_TEMP]);
-    ESP_LOGI(TAG, "z1_temp: %d", mb_input_registers[MB_INPUT_Z1_ROOM_TEMP]);
-    ESP_LOGI(TAG, "z2_temp: %d", mb_input_registers[MB_INPUT_Z2_ROOM_TEMP]);
+    ESP_LOGI(TAG, "main_hex_outlet_temp: %d", mb_input_registers_back[MB_INPUT_MAIN_HEX_OUTLET_TEMP]);
+    ESP_LOGI(TAG, "discharge_temp: %d", mb_input_registers_back[MB_INPUT_DISCHARGE_TEMP]);
+    ESP_LOGI(TAG, "inside_pipe_temp: %d", mb_input_registers_back[MB_INPUT_INSIDE_PIPE_TEMP]);
+    ESP_LOGI(TAG, "defrost_temp: %d", mb_input_registers_back[MB_INPUT_DEFROST_TEMP]);
+    ESP_LOGI(TAG, "eva_outlet_temp: %d", mb_input_registers_back[MB_INPUT_EVA_OUTLET_TEMP]);
+    ESP_LOGI(TAG, "bypass_outlet_temp: %d", mb_input_registers_back[MB_INPUT_BYPASS_OUTLET_TEMP]);
+    ESP_LOGI(TAG, "ipm_temp: %d", mb_input_registers_back[MB_INPUT_IPM_TEMP]);
+    ESP_LOGI(TAG, "outside_pipe_temp: %d", mb_input_registers_back[MB_INPUT_OUTSIDE_PIPE_TEMP]);
+    ESP_LOGI(TAG, "z1_temp: %d", mb_input_registers_back[MB_INPUT_Z1_ROOM_TEMP]);
+    ESP_LOGI(TAG, "z2_temp: %d", mb_input_registers_back[MB_INPUT_Z2_ROOM_TEMP]);
     
     // Water temperatures
-    ESP_LOGI(TAG, "z1_water_temp: %d", mb_input_registers[MB_INPUT_Z1_WATER_TEMP]);
-    ESP_LOGI(TAG, "z2_water_temp: %d", mb_input_registers[MB_INPUT_Z2_WATER_TEMP]);
-    ESP_LOGI(TAG, "z1_water_target_temp: %d", mb_input_registers[MB_INPUT_Z1_WATER_TARGET_TEMP]);
-    ESP_LOGI(TAG, "z2_water_target_temp: %d", mb_input_registers[MB_INPUT_Z2_WATER_TARGET_TEMP]);
-    ESP_LOGI(TAG, "second_inlet_temp: %d", mb_input_registers[MB_INPUT_SECOND_INLET_TEMP]);
-    ESP_LOGI(TAG, "economizer_outlet_temp: %d", mb_input_registers[MB_INPUT_ECONOMIZER_OUTLET_TEMP]);
-    ESP_LOGI(TAG, "second_room_thermostat_temp: %d", mb_input_registers[MB_INPUT_SECOND_ROOM_THERMO_TEMP]);
+    ESP_LOGI(TAG, "z1_water_temp: %d", mb_input_registers_back[MB_INPUT_Z1_WATER_TEMP]);
+    ESP_LOGI(TAG, "z2_water_temp: %d", mb_input_registers_back[MB_INPUT_Z2_WATER_TEMP]);
+    ESP_LOGI(TAG, "z1_water_target_temp: %d", mb_input_registers_back[MB_INPUT_Z1_WATER_TARGET_TEMP]);
+    ESP_LOGI(TAG, "z2_water_target_temp: %d", mb_input_registers_back[MB_INPUT_Z2_WATER_TARGET_TEMP]);
+    ESP_LOGI(TAG, "second_inlet_temp: %d", mb_input_registers_back[MB_INPUT_SECOND_INLET_TEMP]);
+    ESP_LOGI(TAG, "economizer_outlet_temp: %d", mb_input_registers_back[MB_INPUT_ECONOMIZER_OUTLET_TEMP]);
+    ESP_LOGI(TAG, "second_room_thermostat_temp: %d", mb_input_registers_back[MB_INPUT_SECOND_ROOM_THERMO_TEMP]);
     
     // Zone request temperatures
-    ESP_LOGI(TAG, "z1_heat_request_temp: %d", mb_input_registers[MB_INPUT_Z1_HEAT_REQUEST_TEMP]);
-    ESP_LOGI(TAG, "z1_cool_request_temp: %d", mb_input_registers[MB_INPUT_Z1_COOL_REQUEST_TEMP]);
-    ESP_LOGI(TAG, "z2_heat_request_temp: %d", mb_input_registers[MB_INPUT_Z2_HEAT_REQUEST_TEMP]);
-    ESP_LOGI(TAG, "z2_cool_request_temp: %d", mb_input_registers[MB_INPUT_Z2_COOL_REQUEST_TEMP]);
+    ESP_LOGI(TAG, "z1_heat_request_temp: %d", mb_input_registers_back[MB_INPUT_Z1_HEAT_REQUEST_TEMP]);
+    ESP_LOGI(TAG, "z1_cool_request_temp: %d", mb_input_registers_back[MB_INPUT_Z1_COOL_REQUEST_TEMP]);
+    ESP_LOGI(TAG, "z2_heat_request_temp: %d", mb_input_registers_back[MB_INPUT_Z2_HEAT_REQUEST_TEMP]);
+    ESP_LOGI(TAG, "z2_cool_request_temp: %d", mb_input_registers_back[MB_INPUT_Z2_COOL_REQUEST_TEMP]);
     
     // Zone 1 curves
-    ESP_LOGI(TAG, "z1_heat_curve_target_high_temp: %d", mb_input_registers[MB_INPUT_Z1_HEAT_CURVE_TARGET_HIGH]);
-    ESP_LOGI(TAG, "z1_heat_curve_target_low_temp: %d", mb_input_registers[MB_INPUT_Z1_HEAT_CURVE_TARGET_LOW]);
-    ESP_LOGI(TAG, "z1_heat_curve_outside_high_temp: %d", mb_input_registers[MB_INPUT_Z1_HEAT_CURVE_OUTSIDE_HIGH]);
-    ESP_LOGI(TAG, "z1_heat_curve_outside_low_temp: %d", mb_input_registers[MB_INPUT_Z1_HEAT_CURVE_OUTSIDE_LOW]);
-    ESP_LOGI(TAG, "z1_cool_curve_target_high_temp: %d", mb_input_registers[MB_INPUT_Z1_COOL_CURVE_TARGET_HIGH]);
-    ESP_LOGI(TAG, "z1_cool_curve_target_low_temp: %d", mb_input_registers[MB_INPUT_Z1_COOL_CURVE_TARGET_LOW]);
-    ESP_LOGI(TAG, "z1_cool_curve_outside_high_temp: %d", mb_input_registers[MB_INPUT_Z1_COOL_CURVE_OUTSIDE_HIGH]);
-    ESP_LOGI(TAG, "z1_cool_curve_outside_low_temp: %d", mb_input_registers[MB_INPUT_Z1_COOL_CURVE_OUTSIDE_LOW]);
+    ESP_LOGI(TAG, "z1_heat_curve_target_high_temp: %d", mb_input_registers_back[MB_INPUT_Z1_HEAT_CURVE_TARGET_HIGH]);
+    ESP_LOGI(TAG, "z1_heat_curve_target_low_temp: %d", mb_input_registers_back[MB_INPUT_Z1_HEAT_CURVE_TARGET_LOW]);
+    ESP_LOGI(TAG, "z1_heat_curve_outside_high_temp: %d", mb_input_registers_back[MB_INPUT_Z1_HEAT_CURVE_OUTSIDE_HIGH]);
+    ESP_LOGI(TAG, "z1_heat_curve_outside_low_temp: %d", mb_input_registers_back[MB_INPUT_Z1_HEAT_CURVE_OUTSIDE_LOW]);
+    ESP_LOGI(TAG, "z1_cool_curve_target_high_temp: %d", mb_input_registers_back[MB_INPUT_Z1_COOL_CURVE_TARGET_HIGH]);
+    ESP_LOGI(TAG, "z1_cool_curve_target_low_temp: %d", mb_input_registers_back[MB_INPUT_Z1_COOL_CURVE_TARGET_LOW]);
+    ESP_LOGI(TAG, "z1_cool_curve_outside_high_temp: %d", mb_input_registers_back[MB_INPUT_Z1_COOL_CURVE_OUTSIDE_HIGH]);
+    ESP_LOGI(TAG, "z1_cool_curve_outside_low_temp: %d", mb_input_registers_back[MB_INPUT_Z1_COOL_CURVE_OUTSIDE_LOW]);
     
     // Zone 2 curves
-    ESP_LOGI(TAG, "z2_heat_curve_target_high_temp: %d", mb_input_registers[MB_INPUT_Z2_HEAT_CURVE_TARGET_HIGH]);
-    ESP_LOGI(TAG, "z2_heat_curve_target_low_temp: %d", mb_input_registers[MB_INPUT_Z2_HEAT_CURVE_TARGET_LOW]);
-    ESP_LOGI(TAG, "z2_heat_curve_outside_high_temp: %d", mb_input_registers[MB_INPUT_Z2_HEAT_CURVE_OUTSIDE_HIGH]);
-    ESP_LOGI(TAG, "z2_heat_curve_outside_low_temp: %d", mb_input_registers[MB_INPUT_Z2_HEAT_CURVE_OUTSIDE_LOW]);
-    ESP_LOGI(TAG, "z2_cool_curve_target_high_temp: %d", mb_input_registers[MB_INPUT_Z2_COOL_CURVE_TARGET_HIGH]);
-    ESP_LOGI(TAG, "z2_cool_curve_target_low_temp: %d", mb_input_registers[MB_INPUT_Z2_COOL_CURVE_TARGET_LOW]);
-    ESP_LOGI(TAG, "z2_cool_curve_outside_high_temp: %d", mb_input_registers[MB_INPUT_Z2_COOL_CURVE_OUTSIDE_HIGH]);
-    ESP_LOGI(TAG, "z2_cool_curve_outside_low_temp: %d", mb_input_registers[MB_INPUT_Z2_COOL_CURVE_OUTSIDE_LOW]);
+    ESP_LOGI(TAG, "z2_heat_curve_target_high_temp: %d", mb_input_registers_back[MB_INPUT_Z2_HEAT_CURVE_TARGET_HIGH]);
+    ESP_LOGI(TAG, "z2_heat_curve_target_low_temp: %d", mb_input_registers_back[MB_INPUT_Z2_HEAT_CURVE_TARGET_LOW]);
+    ESP_LOGI(TAG, "z2_heat_curve_outside_high_temp: %d", mb_input_registers_back[MB_INPUT_Z2_HEAT_CURVE_OUTSIDE_HIGH]);
+    ESP_LOGI(TAG, "z2_heat_curve_outside_low_temp: %d", mb_input_registers_back[MB_INPUT_Z2_HEAT_CURVE_OUTSIDE_LOW]);
+    ESP_LOGI(TAG, "z2_cool_curve_target_high_temp: %d", mb_input_registers_back[MB_INPUT_Z2_COOL_CURVE_TARGET_HIGH]);
+    ESP_LOGI(TAG, "z2_cool_curve_target_low_temp: %d", mb_input_registers_back[MB_INPUT_Z2_COOL_CURVE_TARGET_LOW]);
+    ESP_LOGI(TAG, "z2_cool_curve_outside_high_temp: %d", mb_input_registers_back[MB_INPUT_Z2_COOL_CURVE_OUTSIDE_HIGH]);
+    ESP_LOGI(TAG, "z2_cool_curve_outside_low_temp: %d", mb_input_registers_back[MB_INPUT_Z2_COOL_CURVE_OUTSIDE_LOW]);
     
     // Heaters
-    ESP_LOGI(TAG, "dhw_heater_state: %u", mb_input_registers[MB_INPUT_DHW_HEATER_STATE]);
-    ESP_LOGI(TAG, "room_heater_state: %u", mb_input_registers[MB_INPUT_ROOM_HEATER_STATE]);
-    ESP_LOGI(TAG, "internal_heater_state: %u", mb_input_registers[MB_INPUT_INTERNAL_HEATER_STATE]);
-    ESP_LOGI(TAG, "external_heater_state: %u", mb_input_registers[MB_INPUT_EXTERNAL_HEATER_STATE]);
-    ESP_LOGI(TAG, "force_heater_state: %u", mb_input_registers[MB_INPUT_FORCE_HEATER_STATE]);
-    ESP_LOGI(TAG, "sterilization_state: %u", mb_input_registers[MB_INPUT_STERILIZATION_STATE]);
-    ESP_LOGI(TAG, "sterilization_temp: %d", mb_input_registers[MB_INPUT_STERILIZATION_TEMP]);
-    ESP_LOGI(TAG, "sterilization_max_time: %u", mb_input_registers[MB_INPUT_STERILIZATION_MAX_TIME]);
+    ESP_LOGI(TAG, "dhw_heater_state: %u", mb_input_registers_back[MB_INPUT_DHW_HEATER_STATE]);
+    ESP_LOGI(TAG, "room_heater_state: %u", mb_input_registers_back[MB_INPUT_ROOM_HEATER_STATE]);
+    ESP_LOGI(TAG, "internal_heater_state: %u", mb_input_registers_back[MB_INPUT_INTERNAL_HEATER_STATE]);
+    ESP_LOGI(TAG, "external_heater_state: %u", mb_input_registers_back[MB_INPUT_EXTERNAL_HEATER_STATE]);
+    ESP_LOGI(TAG, "force_heater_state: %u", mb_input_registers_back[MB_INPUT_FORCE_HEATER_STATE]);
+    ESP_LOGI(TAG, "sterilization_state: %u", mb_input_registers_back[MB_INPUT_STERILIZATION_STATE]);
+    ESP_LOGI(TAG, "sterilization_temp: %d", mb_input_registers_back[MB_INPUT_STERILIZATION_TEMP]);
+    ESP_LOGI(TAG, "sterilization_max_time: %u", mb_input_registers_back[MB_INPUT_STERILIZATION_MAX_TIME]);
     
     // Deltas
-    ESP_LOGI(TAG, "dhw_heat_delta: %d", mb_input_registers[MB_INPUT_DHW_HEAT_DELTA]);
-    ESP_LOGI(TAG, "heat_delta: %d", mb_input_registers[MB_INPUT_HEAT_DELTA]);
-    ESP_LOGI(TAG, "cool_delta: %d", mb_input_registers[MB_INPUT_COOL_DELTA]);
-    ESP_LOGI(TAG, "dhw_holiday_shift_temp: %d", mb_input_registers[MB_INPUT_DHW_HOLIDAY_SHIFT_TEMP]);
-    ESP_LOGI(TAG, "room_holiday_shift_temp: %d", mb_input_registers[MB_INPUT_ROOM_HOLIDAY_SHIFT_TEMP]);
-    ESP_LOGI(TAG, "buffer_tank_delta: %d", mb_input_registers[MB_INPUT_BUFFER_TANK_DELTA]);
+    ESP_LOGI(TAG, "dhw_heat_delta: %d", mb_input_registers_back[MB_INPUT_DHW_HEAT_DELTA]);
+    ESP_LOGI(TAG, "heat_delta: %d", mb_input_registers_back[MB_INPUT_HEAT_DELTA]);
+    ESP_LOGI(TAG, "cool_delta: %d", mb_input_registers_back[MB_INPUT_COOL_DELTA]);
+    ESP_LOGI(TAG, "dhw_holiday_shift_temp: %d", mb_input_registers_back[MB_INPUT_DHW_HOLIDAY_SHIFT_TEMP]);
+    ESP_LOGI(TAG, "room_holiday_shift_temp: %d", mb_input_registers_back[MB_INPUT_ROOM_HOLIDAY_SHIFT_TEMP]);
+    ESP_LOGI(TAG, "buffer_tank_delta: %d", mb_input_registers_back[MB_INPUT_BUFFER_TANK_DELTA]);
     
     // Modes
-    ESP_LOGI(TAG, "heating_mode: %u", mb_input_registers[MB_INPUT_HEATING_MODE]);
-    ESP_LOGI(TAG, "heating_off_outdoor_temp: %d", mb_input_registers[MB_INPUT_HEATING_OFF_OUTDOOR_TEMP]);
-    ESP_LOGI(TAG, "heater_on_outdoor_temp: %d", mb_input_registers[MB_INPUT_HEATER_ON_OUTDOOR_TEMP]);
-    ESP_LOGI(TAG, "heat_to_cool_temp: %d", mb_input_registers[MB_INPUT_HEAT_TO_COOL_TEMP]);
-    ESP_LOGI(TAG, "cool_to_heat_temp: %d", mb_input_registers[MB_INPUT_COOL_TO_HEAT_TEMP]);
-    ESP_LOGI(TAG, "cooling_mode: %u", mb_input_registers[MB_INPUT_COOLING_MODE]);
+    ESP_LOGI(TAG, "heating_mode: %u", mb_input_registers_back[MB_INPUT_HEATING_MODE]);
+    ESP_LOGI(TAG, "heating_off_outdoor_temp: %d", mb_input_registers_back[MB_INPUT_HEATING_OFF_OUTDOOR_TEMP]);
+    ESP_LOGI(TAG, "heater_on_outdoor_temp: %d", mb_input_registers_back[MB_INPUT_HEATER_ON_OUTDOOR_TEMP]);
+    ESP_LOGI(TAG, "heat_to_cool_temp: %d", mb_input_registers_back[MB_INPUT_HEAT_TO_COOL_TEMP]);
+    ESP_LOGI(TAG, "cool_to_heat_temp: %d", mb_input_registers_back[MB_INPUT_COOL_TO_HEAT_TEMP]);
+    ESP_LOGI(TAG, "cooling_mode: %u", mb_input_registers_back[MB_INPUT_COOLING_MODE]);
     
     // Solar/Buffer
-    ESP_LOGI(TAG, "buffer_installed: %u", mb_input_registers[MB_INPUT_BUFFER_INSTALLED]);
-    ESP_LOGI(TAG, "dhw_installed: %u", mb_input_registers[MB_INPUT_DHW_INSTALLED]);
-    ESP_LOGI(TAG, "solar_mode: %u", mb_input_registers[MB_INPUT_SOLAR_MODE]);
-    ESP_LOGI(TAG, "solar_on_delta: %d", mb_input_registers[MB_INPUT_SOLAR_ON_DELTA]);
-    ESP_LOGI(TAG, "solar_off_delta: %d", mb_input_registers[MB_INPUT_SOLAR_OFF_DELTA]);
-    ESP_LOGI(TAG, "solar_frost_protection: %d", mb_input_registers[MB_INPUT_SOLAR_FROST_PROTECTION]);
-    ESP_LOGI(TAG, "solar_high_limit: %d", mb_input_registers[MB_INPUT_SOLAR_HIGH_LIMIT]);
+    ESP_LOGI(TAG, "buffer_installed: %u", mb_input_registers_back[MB_INPUT_BUFFER_INSTALLED]);
+    ESP_LOGI(TAG, "dhw_installed: %u", mb_input_registers_back[MB_INPUT_DHW_INSTALLED]);
+    ESP_LOGI(TAG, "solar_mode: %u", mb_input_registers_back[MB_INPUT_SOLAR_MODE]);
+    ESP_LOGI(TAG, "solar_on_delta: %d", mb_input_registers_back[MB_INPUT_SOLAR_ON_DELTA]);
+    ESP_LOGI(TAG, "solar_off_delta: %d", mb_input_registers_back[MB_INPUT_SOLAR_OFF_DELTA]);
+    ESP_LOGI(TAG, "solar_frost_protection: %d", mb_input_registers_back[MB_INPUT_SOLAR_FROST_PROTECTION]);
+    ESP_LOGI(TAG, "solar_high_limit: %d", mb_input_registers_back[MB_INPUT_SOLAR_HIGH_LIMIT]);
     
     // Pump/Liquid
-    ESP_LOGI(TAG, "pump_flowrate_mode: %u", mb_input_registers[MB_INPUT_PUMP_FLOWRATE_MODE]);
-    ESP_LOGI(TAG, "liquid_type: %u", mb_input_registers[MB_INPUT_LIQUID_TYPE]);
-    ESP_LOGI(TAG, "alt_external_sensor: %u", mb_input_registers[MB_INPUT_ALT_EXTERNAL_SENSOR]);
-    ESP_LOGI(TAG, "anti_freeze_mode: %u", mb_input_registers[MB_INPUT_ANTI_FREEZE_MODE]);
-    ESP_LOGI(TAG, "optional_pcb: %u", mb_input_registers[MB_INPUT_OPTIONAL_PCB]);
+    ESP_LOGI(TAG, "pump_flowrate_mode: %u", mb_input_registers_back[MB_INPUT_PUMP_FLOWRATE_MODE]);
+    ESP_LOGI(TAG, "liquid_type: %u", mb_input_registers_back[MB_INPUT_LIQUID_TYPE]);
+    ESP_LOGI(TAG, "alt_external_sensor: %u", mb_input_registers_back[MB_INPUT_ALT_EXTERNAL_SENSOR]);
+    ESP_LOGI(TAG, "anti_freeze_mode: %u", mb_input_registers_back[MB_INPUT_ANTI_FREEZE_MODE]);
+    ESP_LOGI(TAG, "optional_pcb: %u", mb_input_registers_back[MB_INPUT_OPTIONAL_PCB]);
     
     // Zone sensors
-    ESP_LOGI(TAG, "z1_sensor_settings: %u", mb_input_registers[MB_INPUT_Z1_SENSOR_SETTINGS]);
-    ESP_LOGI(TAG, "z2_sensor_settings: %u", mb_input_registers[MB_INPUT_Z2_SENSOR_SETTINGS]);
+    ESP_LOGI(TAG, "z1_sensor_settings: %u", mb_input_registers_back[MB_INPUT_Z1_SENSOR_SETTINGS]);
+    ESP_LOGI(TAG, "z2_sensor_settings: %u", mb_input_registers_back[MB_INPUT_Z2_SENSOR_SETTINGS]);
     
     // External
-    ESP_LOGI(TAG, "external_pad_heater: %u", mb_input_registers[MB_INPUT_EXTERNAL_PAD_HEATER]);
-    ESP_LOGI(TAG, "water_pressure: %d", mb_input_registers[MB_INPUT_WATER_PRESSURE]);
-    ESP_LOGI(TAG, "external_control: %u", mb_input_registers[MB_INPUT_EXTERNAL_CONTROL]);
-    ESP_LOGI(TAG, "external_heat_cool_control: %u", mb_input_registers[MB_INPUT_EXTERNAL_HEAT_COOL_CONTROL]);
-    ESP_LOGI(TAG, "external_error_signal: %u", mb_input_registers[MB_INPUT_EXTERNAL_ERROR_SIGNAL]);
-    ESP_LOGI(TAG, "external_compressor_control: %u", mb_input_registers[MB_INPUT_EXTERNAL_COMPRESSOR_CONTROL]);
+    ESP_LOGI(TAG, "external_pad_heater: %u", mb_input_registers_back[MB_INPUT_EXTERNAL_PAD_HEATER]);
+    ESP_LOGI(TAG, "water_pressure: %d", mb_input_registers_back[MB_INPUT_WATER_PRESSURE]);
+    ESP_LOGI(TAG, "external_control: %u", mb_input_registers_back[MB_INPUT_EXTERNAL_CONTROL]);
+    ESP_LOGI(TAG, "external_heat_cool_control: %u", mb_input_registers_back[MB_INPUT_EXTERNAL_HEAT_COOL_CONTROL]);
+    ESP_LOGI(TAG, "external_error_signal: %u", mb_input_registers_back[MB_INPUT_EXTERNAL_ERROR_SIGNAL]);
+    ESP_LOGI(TAG, "external_compressor_control: %u", mb_input_registers_back[MB_INPUT_EXTERNAL_COMPRESSOR_CONTROL]);
     
     // Pumps
-    ESP_LOGI(TAG, "z2_pump_state: %u", mb_input_registers[MB_INPUT_Z2_PUMP_STATE]);
-    ESP_LOGI(TAG, "z1_pump_state: %u", mb_input_registers[MB_INPUT_Z1_PUMP_STATE]);
-    ESP_LOGI(TAG, "two_way_valve_state: %u", mb_input_registers[MB_INPUT_TWO_WAY_VALVE_STATE]);
-    ESP_LOGI(TAG, "three_way_valve_state2: %u", mb_input_registers[MB_INPUT_THREE_WAY_VALVE_STATE2]);
+    ESP_LOGI(TAG, "z2_pump_state: %u", mb_input_registers_back[MB_INPUT_Z2_PUMP_STATE]);
+    ESP_LOGI(TAG, "z1_pump_state: %u", mb_input_registers_back[MB_INPUT_Z1_PUMP_STATE]);
+    ESP_LOGI(TAG, "two_way_valve_state: %u", mb_input_registers_back[MB_INPUT_TWO_WAY_VALVE_STATE]);
+    ESP_LOGI(TAG, "three_way_valve_state2: %u", mb_input_registers_back[MB_INPUT_THREE_WAY_VALVE_STATE2]);
     
     // PID
-    ESP_LOGI(TAG, "z1_valve_pid: %d", mb_input_registers[MB_INPUT_Z1_VALVE_PID]);
-    ESP_LOGI(TAG, "z2_valve_pid: %d", mb_input_registers[MB_INPUT_Z2_VALVE_PID]);
+    ESP_LOGI(TAG, "z1_valve_pid: %d", mb_input_registers_back[MB_INPUT_Z1_VALVE_PID]);
+    ESP_LOGI(TAG, "z2_valve_pid: %d", mb_input_registers_back[MB_INPUT_Z2_VALVE_PID]);
     
     // Bivalent
-    ESP_LOGI(TAG, "bivalent_control: %u", mb_input_registers[MB_INPUT_BIVALENT_CONTROL]);
-    ESP_LOGI(TAG, "bivalent_mode: %u", mb_input_registers[MB_INPUT_BIVALENT_MODE]);
-    ESP_LOGI(TAG, "bivalent_start_temp: %d", mb_input_registers[MB_INPUT_BIVALENT_START_TEMP]);
-    ESP_LOGI(TAG, "bivalent_advanced_heat: %u", mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_HEAT]);
-    ESP_LOGI(TAG, "bivalent_advanced_dhw: %u", mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_DHW]);
-    ESP_LOGI(TAG, "bivalent_advanced_start_temp: %d", mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_START_TEMP]);
-    ESP_LOGI(TAG, "bivalent_advanced_stop_temp: %d", mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_STOP_TEMP]);
-    ESP_LOGI(TAG, "bivalent_advanced_start_delay: %u", mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_START_DELAY]);
-    ESP_LOGI(TAG, "bivalent_advanced_stop_delay: %u", mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_STOP_DELAY]);
-    ESP_LOGI(TAG, "bivalent_advanced_dhw_delay: %u", mb_input_registers[MB_INPUT_BIVALENT_ADVANCED_DHW_DELAY]);
+    ESP_LOGI(TAG, "bivalent_control: %u", mb_input_registers_back[MB_INPUT_BIVALENT_CONTROL]);
+    ESP_LOGI(TAG, "bivalent_mode: %u", mb_input_registers_back[MB_INPUT_BIVALENT_MODE]);
+    ESP_LOGI(TAG, "bivalent_start_temp: %d", mb_input_registers_back[MB_INPUT_BIVALENT_START_TEMP]);
+    ESP_LOGI(TAG, "bivalent_advanced_heat: %u", mb_input_registers_back[MB_INPUT_BIVALENT_ADVANCED_HEAT]);
+    ESP_LOGI(TAG, "bivalent_advanced_dhw: %u", mb_input_registers_back[MB_INPUT_BIVALENT_ADVANCED_DHW]);
+    ESP_LOGI(TAG, "bivalent_advanced_start_temp: %d", mb_input_registers_back[MB_INPUT_BIVALENT_ADVANCED_START_TEMP]);
+    ESP_LOGI(TAG, "bivalent_advanced_stop_temp: %d", mb_input_registers_back[MB_INPUT_BIVALENT_ADVANCED_STOP_TEMP]);
+    ESP_LOGI(TAG, "bivalent_advanced_start_delay: %u", mb_input_registers_back[MB_INPUT_BIVALENT_ADVANCED_START_DELAY]);
+    ESP_LOGI(TAG, "bivalent_advanced_stop_delay: %u", mb_input_registers_back[MB_INPUT_BIVALENT_ADVANCED_STOP_DELAY]);
+    ESP_LOGI(TAG, "bivalent_advanced_dhw_delay: %u", mb_input_registers_back[MB_INPUT_BIVALENT_ADVANCED_DHW_DELAY]);
     
     // Heater timing settings
-    ESP_LOGI(TAG, "heater_delay_time: %u", mb_input_registers[MB_INPUT_HEATER_DELAY_TIME]);
-    ESP_LOGI(TAG, "heater_start_delta: %d", mb_input_registers[MB_INPUT_HEATER_START_DELTA]);
-    ESP_LOGI(TAG, "heater_stop_delta: %d", mb_input_registers[MB_INPUT_HEATER_STOP_DELTA]);
+    ESP_LOGI(TAG, "heater_delay_time: %u", mb_input_registers_back[MB_INPUT_HEATER_DELAY_TIME]);
+    ESP_LOGI(TAG, "heater_start_delta: %d", mb_input_registers_back[MB_INPUT_HEATER_START_DELTA]);
+    ESP_LOGI(TAG, "heater_stop_delta: %d", mb_input_registers_back[MB_INPUT_HEATER_STOP_DELTA]);
     
     // Hours
-    ESP_LOGI(TAG, "room_heater_operations_hours: %u", mb_input_registers[MB_INPUT_ROOM_HEATER_OPS_HOURS]);
-    ESP_LOGI(TAG, "dhw_heater_operations_hours: %u", mb_input_registers[MB_INPUT_DHW_HEATER_OPS_HOURS]);
-    ESP_LOGI(TAG, "error_type: '%c'", (char)mb_input_registers[MB_INPUT_ERROR_TYPE]);
-    ESP_LOGI(TAG, "error_number: %d", mb_input_registers[MB_INPUT_ERROR_NUMBER]);
+    ESP_LOGI(TAG, "room_heater_operations_hours: %u", mb_input_registers_back[MB_INPUT_ROOM_HEATER_OPS_HOURS]);
+    ESP_LOGI(TAG, "dhw_heater_operations_hours: %u", mb_input_registers_back[MB_INPUT_DHW_HEATER_OPS_HOURS]);
+    ESP_LOGI(TAG, "error_type: '%c'", (char)mb_input_registers_back[MB_INPUT_ERROR_TYPE]);
+    ESP_LOGI(TAG, "error_number: %d", mb_input_registers_back[MB_INPUT_ERROR_NUMBER]);
 
     {
         char model_str[30];
         for (size_t i = 0; i < 5; i++) {
-            uint16_t reg = (uint16_t)mb_input_registers[MB_INPUT_HP_MODEL_0 + i];
+            uint16_t reg = (uint16_t)mb_input_registers_back[MB_INPUT_HP_MODEL_0 + i];
             sprintf(model_str + i * 6, "%02X %02X ", reg >> 8, reg & 0xFF);
         }
         model_str[29] = '\0';
@@ -778,23 +878,23 @@ void log_main_data(void) {
 
 void log_extra_data(void) {
     ESP_LOGI(TAG, "=== DECODED EXTRA DATA ===");
-    ESP_LOGI(TAG, "heat_power_consumption_extra: %u", mb_input_registers[MB_INPUT_HEAT_POWER_CONSUMPTION_EXTRA]);
-    ESP_LOGI(TAG, "cool_power_consumption_extra: %u", mb_input_registers[MB_INPUT_COOL_POWER_CONSUMPTION_EXTRA]);
-    ESP_LOGI(TAG, "dhw_power_consumption_extra: %u", mb_input_registers[MB_INPUT_DHW_POWER_CONSUMPTION_EXTRA]);
-    ESP_LOGI(TAG, "heat_power_production_extra: %u", mb_input_registers[MB_INPUT_HEAT_POWER_PRODUCTION_EXTRA]);
-    ESP_LOGI(TAG, "cool_power_production_extra: %u", mb_input_registers[MB_INPUT_COOL_POWER_PRODUCTION_EXTRA]);
-    ESP_LOGI(TAG, "dhw_power_production_extra: %u", mb_input_registers[MB_INPUT_DHW_POWER_PRODUCTION_EXTRA]);
+    ESP_LOGI(TAG, "heat_power_consumption_extra: %u", mb_input_registers_back[MB_INPUT_HEAT_POWER_CONSUMPTION_EXTRA]);
+    ESP_LOGI(TAG, "cool_power_consumption_extra: %u", mb_input_registers_back[MB_INPUT_COOL_POWER_CONSUMPTION_EXTRA]);
+    ESP_LOGI(TAG, "dhw_power_consumption_extra: %u", mb_input_registers_back[MB_INPUT_DHW_POWER_CONSUMPTION_EXTRA]);
+    ESP_LOGI(TAG, "heat_power_production_extra: %u", mb_input_registers_back[MB_INPUT_HEAT_POWER_PRODUCTION_EXTRA]);
+    ESP_LOGI(TAG, "cool_power_production_extra: %u", mb_input_registers_back[MB_INPUT_COOL_POWER_PRODUCTION_EXTRA]);
+    ESP_LOGI(TAG, "dhw_power_production_extra: %u", mb_input_registers_back[MB_INPUT_DHW_POWER_PRODUCTION_EXTRA]);
     ESP_LOGI(TAG, "=== END DECODED EXTRA DATA ===");
 }
 
 void log_opt_data(void) {
     ESP_LOGI(TAG, "=== DECODED OPT DATA ===");
-    ESP_LOGI(TAG, "z1_water_pump: %u", mb_input_registers[MB_INPUT_Z1_WATER_PUMP]);
-    ESP_LOGI(TAG, "z1_mixing_valve: %u", mb_input_registers[MB_INPUT_Z1_MIXING_VALVE]);
-    ESP_LOGI(TAG, "z2_water_pump: %u", mb_input_registers[MB_INPUT_Z2_WATER_PUMP]);
-    ESP_LOGI(TAG, "z2_mixing_valve: %u", mb_input_registers[MB_INPUT_Z2_MIXING_VALVE]);
-    ESP_LOGI(TAG, "pool_water_pump: %u", mb_input_registers[MB_INPUT_POOL_WATER_PUMP]);
-    ESP_LOGI(TAG, "solar_water_pump: %u", mb_input_registers[MB_INPUT_SOLAR_WATER_PUMP]);
-    ESP_LOGI(TAG, "alarm_state: %u", mb_input_registers[MB_INPUT_ALARM_STATE]);
+    ESP_LOGI(TAG, "z1_water_pump: %u", mb_input_registers_back[MB_INPUT_Z1_WATER_PUMP]);
+    ESP_LOGI(TAG, "z1_mixing_valve: %u", mb_input_registers_back[MB_INPUT_Z1_MIXING_VALVE]);
+    ESP_LOGI(TAG, "z2_water_pump: %u", mb_input_registers_back[MB_INPUT_Z2_WATER_PUMP]);
+    ESP_LOGI(TAG, "z2_mixing_valve: %u", mb_input_registers_back[MB_INPUT_Z2_MIXING_VALVE]);
+    ESP_LOGI(TAG, "pool_water_pump: %u", mb_input_registers_back[MB_INPUT_POOL_WATER_PUMP]);
+    ESP_LOGI(TAG, "solar_water_pump: %u", mb_input_registers_back[MB_INPUT_SOLAR_WATER_PUMP]);
+    ESP_LOGI(TAG, "alarm_state: %u", mb_input_registers_back[MB_INPUT_ALARM_STATE]);
     ESP_LOGI(TAG, "=== END DECODED OPT DATA ===");
 }
\ No newline at end of file
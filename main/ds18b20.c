@@ -47,7 +47,7 @@ static const uint16_t ds18b20_reg_addrs[DS18B20_MAX_SENSORS] = {
 static void write_temp_to_register(uint16_t reg_addr, int16_t value) {
     if (reg_addr >= MB_REG_INPUT_START && reg_addr < MB_REG_INPUT_START + MB_REG_INPUT_COUNT) {
         uint16_t reg_index = reg_addr - MB_REG_INPUT_START;
-        mb_input_registers[reg_index] = value;
+        modbus_params_set_input(reg_index, value);
     }
 }
 
@@ -0,0 +1,171 @@
+/**
+ * @file frame_capture.c
+ * @brief Raw heat pump frame capture in a RAM ring buffer
+ * @version 0.1.0
+ * @date 2025
+ *
+ * Records are a frame_capture_record_t header followed by the frame bytes,
+ * stored back to back in a byte ring. A second ring holds the start position
+ * of the last CONFIG_FRAME_CAPTURE_MAX_RECORDS records so readers can find
+ * record boundaries after the oldest bytes have been overwritten.
+ *
+ * Positions are free-running byte counts. The writer announces how far it is
+ * about to write (capture_reserved) before touching the ring and publishes the
+ * new record (capture_records) afterwards. A reader copies both rings, then
+ * keeps only records that the writer can't have touched during the copy.
+ */
+
+#include "frame_capture.h"
+#include "project_config.h"
+#include "esp_timer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPTURE_BUF_MASK    (CONFIG_FRAME_CAPTURE_BUF_SIZE - 1)
+#define CAPTURE_REC_MASK    (CONFIG_FRAME_CAPTURE_MAX_RECORDS - 1)
+#define CAPTURE_MAX_FRAME   256
+
+_Static_assert((CONFIG_FRAME_CAPTURE_BUF_SIZE & CAPTURE_BUF_MASK) == 0, "capture ring size must be a power of two");
+_Static_assert((CONFIG_FRAME_CAPTURE_MAX_RECORDS & CAPTURE_REC_MASK) == 0, "capture record count must be a power of two");
+_Static_assert(CONFIG_FRAME_CAPTURE_BUF_SIZE >= 2 * (sizeof(frame_capture_record_t) + CAPTURE_MAX_FRAME),
+               "capture ring must hold at least two frames");
+
+static uint8_t capture_buf[CONFIG_FRAME_CAPTURE_BUF_SIZE];
+static uint32_t capture_start[CONFIG_FRAME_CAPTURE_MAX_RECORDS];
+static uint32_t capture_head = 0;       // End of the last published record (writer only)
+static uint32_t capture_reserved = 0;   // End of the record being written
+static uint32_t capture_records = 0;    // Published records since boot
+
+struct frame_capture_snapshot {
+    uint8_t buf[CONFIG_FRAME_CAPTURE_BUF_SIZE];
+    uint32_t start[CONFIG_FRAME_CAPTURE_MAX_RECORDS];
+    uint32_t next;                      // Next record number to return
+    uint32_t end;
+    uint8_t frame[CAPTURE_MAX_FRAME];   // Record bytes, unwrapped
+};
+
+static void capture_copy_in(uint32_t pos, const void *src, size_t size) {
+    uint32_t at = pos & CAPTURE_BUF_MASK;
+    size_t first = CONFIG_FRAME_CAPTURE_BUF_SIZE - at;
+    if (first > size) {
+        first = size;
+    }
+    memcpy(&capture_buf[at], src, first);
+    memcpy(capture_buf, (const uint8_t *)src + first, size - first);
+}
+
+static void capture_copy_out(const uint8_t *ring, uint32_t pos, void *dst, size_t size) {
+    uint32_t at = pos & CAPTURE_BUF_MASK;
+    size_t first = CONFIG_FRAME_CAPTURE_BUF_SIZE - at;
+    if (first > size) {
+        first = size;
+    }
+    memcpy(dst, &ring[at], first);
+    memcpy((uint8_t *)dst + first, ring, size - first);
+}
+
+/**
+ * @brief Record one frame, overwriting the oldest records when full
+ */
+void frame_capture_add(frame_capture_dir_t direction, uint8_t flags, const uint8_t *data, size_t size) {
+    if (data == NULL) {
+        return;
+    }
+    if (size > CAPTURE_MAX_FRAME) {
+        size = CAPTURE_MAX_FRAME;
+    }
+
+    frame_capture_record_t record = {
+        .time_us = esp_timer_get_time(),
+        .direction = (uint8_t)direction,
+        .flags = flags,
+        .len = (uint16_t)size,
+    };
+    uint32_t start = capture_head;
+    uint32_t end = start + sizeof(record) + size;
+
+    __atomic_store_n(&capture_reserved, end, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    capture_copy_in(start, &record, sizeof(record));
+    capture_copy_in(start + sizeof(record), data, size);
+    capture_start[capture_records & CAPTURE_REC_MASK] = start;
+    capture_head = end;
+
+    __atomic_store_n(&capture_records, capture_records + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Copy the ring for reading while the writer keeps running
+ */
+esp_err_t frame_capture_snapshot_take(frame_capture_snapshot_t **snapshot, frame_capture_file_header_t *header) {
+    if (snapshot == NULL || header == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    frame_capture_snapshot_t *snap = malloc(sizeof(*snap));
+    if (snap == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint32_t records = __atomic_load_n(&capture_records, __ATOMIC_ACQUIRE);
+    memcpy(snap->buf, capture_buf, sizeof(snap->buf));
+    memcpy(snap->start, capture_start, sizeof(snap->start));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint32_t reserved = __atomic_load_n(&capture_reserved, __ATOMIC_RELAXED);
+    uint32_t records_after = __atomic_load_n(&capture_records, __ATOMIC_RELAXED);
+
+    // Start slots of records the writer may have reused during the copy
+    // (one record can be in flight) are not trusted
+    uint32_t first = 0;
+    if (records_after + 1 > CONFIG_FRAME_CAPTURE_MAX_RECORDS) {
+        first = records_after + 1 - CONFIG_FRAME_CAPTURE_MAX_RECORDS;
+    }
+    // Neither are bytes below what the writer may have overwritten
+    uint32_t oldest_valid = reserved - CONFIG_FRAME_CAPTURE_BUF_SIZE;
+    while ((int32_t)(records - first) > 0 &&
+           (int32_t)(snap->start[first & CAPTURE_REC_MASK] - oldest_valid) < 0) {
+        first++;
+    }
+    if ((int32_t)(records - first) < 0) {
+        first = records;
+    }
+
+    snap->next = first;
+    snap->end = records;
+    *header = (frame_capture_file_header_t) {
+        .magic = FRAME_CAPTURE_MAGIC,
+        .version = FRAME_CAPTURE_VERSION,
+        .record_header_size = sizeof(frame_capture_record_t),
+        .count = records - first,
+        .dropped = first,
+    };
+    *snapshot = snap;
+    return ESP_OK;
+}
+
+/**
+ * @brief Get the next record of a snapshot, oldest first
+ */
+bool frame_capture_snapshot_next(frame_capture_snapshot_t *snapshot, frame_capture_record_t *record,
+                                 const uint8_t **data) {
+    if (snapshot == NULL || snapshot->next == snapshot->end) {
+        return false;
+    }
+    uint32_t start = snapshot->start[snapshot->next & CAPTURE_REC_MASK];
+    snapshot->next++;
+
+    capture_copy_out(snapshot->buf, start, record, sizeof(*record));
+    if (record->len > CAPTURE_MAX_FRAME) {
+        record->len = CAPTURE_MAX_FRAME;
+    }
+    capture_copy_out(snapshot->buf, start + sizeof(*record), snapshot->frame, record->len);
+    *data = snapshot->frame;
+    return true;
+}
+
+/**
+ * @brief Release a snapshot
+ */
+void frame_capture_snapshot_free(frame_capture_snapshot_t *snapshot) {
+    free(snapshot);
+}
@@ -8,6 +8,7 @@
 #include "include/hpc.h"
 #include "esp_log.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "driver/gpio.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -32,6 +33,28 @@ static bool reset_action_performed = false;
 
 #define HPC_RESET_BUTTON_GPIO   GPIO_NUM_0
 #define HPC_RESET_HOLD_TICKS    pdMS_TO_TICKS(4000)
+#define HPC_MAIN_LOOP_TICKS     pdMS_TO_TICKS(100)
+
+// Boot timeline, esp_timer time of each milestone (0 = not reached)
+static int64_t hpc_boot_us[HPC_BOOT_STAGE_COUNT];
+
+static const char *const hpc_boot_names[HPC_BOOT_STAGE_COUNT] = {
+    [HPC_BOOT_APP_MAIN] = "app_main",
+    [HPC_BOOT_PROTOCOL_STARTED] = "protocol",
+    [HPC_BOOT_MODBUS_STARTED] = "modbus_rtu",
+    [HPC_BOOT_WIFI_STARTED] = "wifi_start",
+    [HPC_BOOT_FIRST_FRAME] = "first_frame",
+    [HPC_BOOT_GOT_IP] = "got_ip",
+    [HPC_BOOT_HTTP_STARTED] = "http",
+    [HPC_BOOT_MODBUS_TCP_STARTED] = "modbus_tcp",
+    [HPC_BOOT_MQTT_STARTED] = "mqtt",
+};
+
+// Network services follow the WiFi state; the main task starts and stops them
+static TaskHandle_t hpc_main_task = NULL;
+static bool hpc_network_up = false;
+static bool hpc_modbus_tcp_started = false;
+static bool hpc_boot_logged = false;
 
 /**
  * @brief Initialize HPC application
@@ -89,38 +112,129 @@ esp_err_t hpc_init(void) {
 }
 
 /**
- * @brief Start HPC application
- * @return ESP_OK on success
+ * @brief Record a boot milestone; only the first call per stage counts
  */
-esp_err_t hpc_start(void) {
+void hpc_boot_mark(hpc_boot_stage_t stage) {
+    if (stage < HPC_BOOT_STAGE_COUNT && hpc_boot_us[stage] == 0) {
+        int64_t now = esp_timer_get_time();
+        hpc_boot_us[stage] = now > 0 ? now : 1;
+    }
+}
+
+/**
+ * @brief Get the time a boot milestone was reached
+ */
+int64_t hpc_boot_time_us(hpc_boot_stage_t stage) {
+    if (stage >= HPC_BOOT_STAGE_COUNT || hpc_boot_us[stage] == 0) {
+        return -1;
+    }
+    return hpc_boot_us[stage];
+}
+
+/**
+ * @brief Get the short name of a boot milestone
+ */
+const char *hpc_boot_stage_name(hpc_boot_stage_t stage) {
+    return stage < HPC_BOOT_STAGE_COUNT ? hpc_boot_names[stage] : "unknown";
+}
+
+/**
+ * @brief Log the boot timeline once every milestone has been reached
+ */
+static void hpc_boot_log_timeline(void) {
+    if (hpc_boot_logged) {
+        return;
+    }
+    for (int i = 0; i < HPC_BOOT_STAGE_COUNT; i++) {
+        if (hpc_boot_us[i] == 0) {
+            return;
+        }
+    }
+    hpc_boot_logged = true;
+    for (int i = 0; i < HPC_BOOT_STAGE_COUNT; i++) {
+        ESP_LOGI(TAG, "Boot %-12s %8.1f ms", hpc_boot_names[i], hpc_boot_us[i] / 1000.0);
+    }
+}
+
+/**
+ * @brief WiFi state listener, runs in the event loop or esp_timer task
+ * Only wakes the main task; the services are started and stopped there
+ */
+static void hpc_wifi_state_changed(wifi_connect_state_t state) {
+    if (state == WIFI_CONNECT_STATE_CONNECTED) {
+        hpc_boot_mark(HPC_BOOT_GOT_IP);
+    }
+    if (hpc_main_task != NULL) {
+        xTaskNotifyGive(hpc_main_task);
+    }
+}
+
+/**
+ * @brief Bring the network services in line with the WiFi state
+ *
+ * With an IP: HTTP server and MQTT client are (re)started, the Modbus TCP
+ * slave is started once and keeps listening across reconnects. Without:
+ * the HTTP server is stopped and MQTT publishing paused. A service that
+ * fails to start is retried on the next state change.
+ */
+static void hpc_update_network_services(void) {
     esp_err_t ret;
-    
-    // Start WiFi connection first (required for MQTT and HTTP server)
-    ret = wifi_connect_start();
+    char ip_str[16];
+    if (!wifi_connect_is_connected() || wifi_connect_get_ip(ip_str, sizeof(ip_str)) != ESP_OK) {
+        if (hpc_network_up) {
+            ESP_LOGW(TAG, "WiFi down, HTTP server stopped and MQTT paused");
+            http_server_stop();
+            mqtt_client_update_wifi_state();
+            hpc_network_up = false;
+        }
+        return;
+    }
+    ESP_LOGI(TAG, "WiFi connected, IP: %s", ip_str);
+    hpc_network_up = true;
+
+    ret = http_server_start();
     if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to start WiFi: %s (MQTT and HTTP server will not work)", esp_err_to_name(ret));
-        // Continue anyway - WiFi/MQTT/HTTP are optional
+        ESP_LOGW(TAG, "Failed to start HTTP server: %s", esp_err_to_name(ret));
     } else {
-        char ip_str[16];
-        if (wifi_connect_get_ip(ip_str, sizeof(ip_str)) == ESP_OK) {
-            ESP_LOGI(TAG, "WiFi connected, IP: %s", ip_str);
-            
-            // Start HTTP server
-            ret = http_server_start();
-            if (ret != ESP_OK) {
-                ESP_LOGW(TAG, "Failed to start HTTP server: %s", esp_err_to_name(ret));
-            } else {
-                ESP_LOGI(TAG, "HTTP server started on http://%s", ip_str);
-            }
+        hpc_boot_mark(HPC_BOOT_HTTP_STARTED);
+        ESP_LOGI(TAG, "HTTP server running on http://%s", ip_str);
+    }
+
+    if (!hpc_modbus_tcp_started) {
+        ret = modbus_slave_start_tcp();
+        if (ret == ESP_OK || ret == ESP_ERR_NOT_SUPPORTED) {
+            hpc_modbus_tcp_started = true;
+            hpc_boot_mark(HPC_BOOT_MODBUS_TCP_STARTED);
+        } else {
+            ESP_LOGW(TAG, "Failed to start Modbus TCP slave: %s (continuing with RTU only)", esp_err_to_name(ret));
         }
     }
-    
+
+    ret = mqtt_client_update_wifi_state();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to start MQTT client: %s (continuing without MQTT)", esp_err_to_name(ret));
+    } else {
+        hpc_boot_mark(HPC_BOOT_MQTT_STARTED);
+    }
+}
+
+/**
+ * @brief Start HPC application
+ *
+ * The heat pump and RS485 paths start right away; WiFi association runs in
+ * the background and the network services follow the WiFi state.
+ * @return ESP_OK on success
+ */
+esp_err_t hpc_start(void) {
+    esp_err_t ret;
+
     // Start heat pump protocol
     ret = protocol_start();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start protocol: %s", esp_err_to_name(ret));
         return ret;
     }
+    hpc_boot_mark(HPC_BOOT_PROTOCOL_STARTED);
 
     // Start Modbus slave
     ret = modbus_slave_start();
@@ -128,6 +242,7 @@ esp_err_t hpc_start(void) {
         ESP_LOGE(TAG, "Failed to start Modbus slave: %s", esp_err_to_name(ret));
         return ret;
     }
+    hpc_boot_mark(HPC_BOOT_MODBUS_STARTED);
 
     // Start ADC reading task
     ret = adc_start();
@@ -147,15 +262,15 @@ esp_err_t hpc_start(void) {
         ESP_LOGI(TAG, "DS18B20 started successfully");
     }
 
-    // Start MQTT client (only if WiFi is connected)
-    if (wifi_connect_is_connected()) {
-        ret = mqtt_client_start();
-        if (ret != ESP_OK) {
-            ESP_LOGW(TAG, "Failed to start MQTT client: %s (continuing without MQTT)", esp_err_to_name(ret));
-            // Don't fail start if MQTT fails - it's optional
-        }
+    // Start WiFi last; HTTP, Modbus TCP and MQTT follow the connection state
+    hpc_main_task = xTaskGetCurrentTaskHandle();
+    wifi_connect_set_state_callback(hpc_wifi_state_changed);
+    ret = wifi_connect_start();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Failed to start WiFi: %s (MQTT and HTTP server will not work)", esp_err_to_name(ret));
+        // Continue anyway - WiFi/MQTT/HTTP are optional
     } else {
-        ESP_LOGW(TAG, "WiFi not connected, skipping MQTT start");
+        hpc_boot_mark(HPC_BOOT_WIFI_STARTED);
     }
 
     return ESP_OK;
@@ -275,6 +390,8 @@ void app_restart() {
  void app_main(void) {
     esp_err_t ret;
 
+    hpc_boot_mark(HPC_BOOT_APP_MAIN);
+
     // Initialize application
     ret = hpc_init();
     if (ret != ESP_OK) {
@@ -291,9 +408,14 @@ void app_restart() {
 
     ESP_LOGI(TAG, "HPC application version %s started successfully", HPC_VERSION_STRING);
 
-    // Main loop - poll factory reset button
+    // Main loop - poll factory reset button, follow WiFi state changes,
+    // age and checkpoint the warm-start register cache
     while (1) {
+        if (ulTaskNotifyTake(pdTRUE, HPC_MAIN_LOOP_TICKS) > 0) {
+            hpc_update_network_services();
+        }
+        hpc_boot_log_timeline();
+        modbus_params_warm_cache_poll();
         hpc_factory_reset_button_poll();
-        vTaskDelay(pdMS_TO_TICKS(100));
     }
 }
\ No newline at end of file
@@ -9,17 +9,44 @@
 #include "include/modbus_params.h"
 #include "include/wifi_connect.h"
 #include "include/mqtt_pub.h"
+#include "include/frame_capture.h"
+#include "include/protocol.h"
+#include "include/modbus_slave.h"
+#include "include/metrics.h"
+#include "include/hpc.h"
+#include "include/project_config.h"
 #include "esp_log.h"
 #include "esp_http_server.h"
 #include "esp_timer.h"
 #include "esp_system.h"
 #include "esp_wifi.h"
-#include "cJSON.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
 
 static const char *TAG = "HTTP_SERVER";
 static httpd_handle_t server_handle = NULL;
+// Held while the protocol task queues a push on server_handle and while the
+// main task publishes or withdraws it, so a stopped server is never used
+static SemaphoreHandle_t server_handle_mutex = NULL;
+
+// httpd internal sockets, and the Modbus TCP listener plus MQTT
+#define HTTP_INTERNAL_SOCKETS 3
+#if CONFIG_MODBUS_TCP_ENABLED
+#define HTTP_OTHER_SOCKETS (1 + CONFIG_FMB_TCP_PORT_MAX_CONN + 1)
+#else
+#define HTTP_OTHER_SOCKETS 1
+#endif
+_Static_assert(CONFIG_HTTP_MAX_OPEN_SOCKETS + HTTP_INTERNAL_SOCKETS + HTTP_OTHER_SOCKETS <= CONFIG_LWIP_MAX_SOCKETS,
+               "CONFIG_LWIP_MAX_SOCKETS too small for httpd, Modbus TCP and MQTT");
+
+#define HTTP_STRINGIFY_(x) #x
+#define HTTP_STRINGIFY(x) HTTP_STRINGIFY_(x)
 
 // Helper function to format temperature value
 static void format_temp_value(char *buf, size_t len, int16_t value, bool is_x100) {
@@ -94,458 +121,772 @@ static void get_formatted_value(char *buf, size_t len, uint16_t reg_addr, mqtt_s
     }
 }
 
+// Dashboard page, gzip-compressed at build time from web/index.html
+extern const uint8_t index_html_gz_start[] asm("_binary_index_html_gz_start");
+extern const uint8_t index_html_gz_end[] asm("_binary_index_html_gz_end");
+
+// Strong ETag of the compressed page: quoted 64-bit FNV-1a of its bytes
+static char index_etag[19];
+
+static void index_etag_init(void) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const uint8_t *p = index_html_gz_start; p < index_html_gz_end; p++) {
+        hash = (hash ^ *p) * 0x100000001b3ULL;
+    }
+    snprintf(index_etag, sizeof(index_etag), "\"%016llx\"", (unsigned long long)hash);
+}
+
+// True if the If-None-Match header lists our ETag (or "*")
+static bool index_etag_matches(httpd_req_t *req) {
+    char value[96];
+    size_t len = httpd_req_get_hdr_value_len(req, "If-None-Match");
+    if (len == 0 || len >= sizeof(value) ||
+        httpd_req_get_hdr_value_str(req, "If-None-Match", value, sizeof(value)) != ESP_OK) {
+        return false;
+    }
+    return strstr(value, index_etag) != NULL || strcmp(value, "*") == 0;
+}
+
 // Root handler - HTML page
 static esp_err_t root_handler(httpd_req_t *req) {
-    ESP_LOGI(TAG, "HTML page requested");
-    
-    // Start building HTML page
-    const char* html_start = 
-        "<!DOCTYPE html>"
-        "<html><head>"
-        "<title>Panasonic Heat Pump Monitor</title>"
-        "<meta charset='UTF-8'>"
-        "<meta name='viewport' content='width=device-width, initial-scale=1'>"
-        "<style>"
-        "body{font-family:Arial,sans-serif;margin:0;padding:20px;background:#f5f5f5;color:#333;}"
-        ".container{max-width:1400px;margin:0 auto;background:white;border-radius:10px;box-shadow:0 2px 10px rgba(0,0,0,0.1);overflow:hidden;}"
-        ".header{background:linear-gradient(135deg,#2196F3,#1976D2);color:white;padding:20px;text-align:center;}"
-        ".header h1{margin:0;font-size:28px;font-weight:300;}"
-        ".status-bar{background:#E3F2FD;padding:10px 20px;border-bottom:1px solid #BBDEFB;display:flex;justify-content:space-between;align-items:center;flex-wrap:wrap;gap:10px;}"
-        ".status-item{display:flex;align-items:center;gap:8px;}"
-        ".status-dot{width:8px;height:8px;border-radius:50%;background:#4CAF50;}"
-        ".status-dot.offline{background:#F44336;}"
-        ".content{padding:20px;}"
-        ".grid{display:grid;grid-template-columns:repeat(auto-fit,minmax(300px,1fr));gap:20px;margin-bottom:20px;}"
-        ".card{background:white;border:1px solid #E0E0E0;border-radius:8px;overflow:hidden;box-shadow:0 1px 3px rgba(0,0,0,0.1);}"
-        ".card-header{background:#F8F9FA;padding:15px;border-bottom:1px solid #E0E0E0;font-weight:600;color:#424242;}"
-        ".card-body{padding:15px;max-height:400px;overflow-y:auto;}"
-        ".param-row{display:flex;justify-content:space-between;align-items:center;padding:8px 0;border-bottom:1px solid #F5F5F5;}"
-        ".param-row:last-child{border-bottom:none;}"
-        ".param-name{color:#666;font-size:14px;}"
-        ".param-value{font-weight:600;color:#2196F3;font-size:16px;}"
-        ".temp-value{color:#FF5722;}"
-        ".power-value{color:#4CAF50;}"
-        ".controls{padding:20px;background:#F8F9FA;border-top:1px solid #E0E0E0;text-align:center;}"
-        ".btn{background:#2196F3;color:white;border:none;padding:10px 20px;border-radius:5px;cursor:pointer;font-size:14px;margin:0 5px;}"
-        ".btn:hover{background:#1976D2;}"
-        ".last-update{color:#999;font-size:12px;margin-top:10px;}"
-        "</style>"
-        "</head><body>"
-        "<div class='container'>"
-        "<div class='header'>"
-        "<h1>🏠 Panasonic Heat Pump Monitor</h1>"
-        "</div>"
-        "<div class='status-bar'>"
-        "<div class='status-item'>"
-        "<div class='status-dot' id='statusDot'></div>"
-        "<span id='statusText'>Loading...</span>"
-        "</div>"
-        "<div class='status-item'>"
-        "<span>IP: <strong id='ip'>--</strong></span>"
-        "<span>WiFi: <strong id='wifi'>--</strong></span>"
-        "<span>Free memory: <strong id='memory'>--</strong></span>"
-        "<span>Uptime: <strong id='uptime'>--</strong></span>"
-        "<span>Last update: <strong id='lastUpdate'>--</strong></span>"
-        "</div>"
-        "</div>"
-        "<div class='controls'>"
-        "<button class='btn' onclick='loadData()'>🔄 Refresh Data</button>"
-        "<button class='btn' onclick='toggleAutoRefresh()' id='autoBtn'>⏸️ Pause Auto-refresh</button>"
-        "</div>"
-        "<div class='content'>"
-        "<div class='grid' id='dataGrid'>"
-        "Loading data..."
-        "</div>"
-        "</div>"
-        "</div>"
-        "<script>"
-        "var autoRefresh=true;"
-        "var refreshInterval;"
-        "function setElementText(id,text){var el=document.getElementById(id);if(el)el.textContent=text;}"
-        "function formatUptime(hours){"
-        "  if(!hours||isNaN(hours)||hours<0)return'0m';"
-        "  var totalMinutes=Math.floor(hours*60);"
-        "  var days=Math.floor(totalMinutes/(24*60));"
-        "  var remainingMinutes=totalMinutes%(24*60);"
-        "  var hours_part=Math.floor(remainingMinutes/60);"
-        "  var minutes_part=remainingMinutes%60;"
-        "  var result='';"
-        "  if(days>0)result+=days+'d ';"
-        "  if(hours_part>0)result+=hours_part+'h ';"
-        "  if(minutes_part>0||(days===0&&hours_part===0))result+=minutes_part+'m';"
-        "  return result.trim()||'0m';"
-        "}"
-        "function updateDisplay(data){"
-        "  setElementText('ip',data.device_ip||'--');"
-        "  setElementText('wifi',data.wifi_rssi?data.wifi_rssi+' dBm':'--');"
-        "  setElementText('memory',data.free_memory?data.free_memory.toFixed(1)+' kB':'--');"
-        "  setElementText('uptime',formatUptime(data.uptime));"
-        "  var status=document.getElementById('statusText');"
-        "  var dot=document.getElementById('statusDot');"
-        "  if(data.status==='online'){"
-        "    setElementText('statusText','Online');"
-        "    dot.className='status-dot';"
-        "  }else{"
-        "    setElementText('statusText','Offline');"
-        "    dot.className='status-dot offline';"
-        "  }"
-        "  var grid=document.getElementById('dataGrid');"
-        "  if(data.params&&data.params.length>0){"
-        "    var html='';"
-        "    var currentCategory='';"
-        "    data.params.forEach(function(param){"
-        "      if(param.category!==currentCategory){"
-        "        if(currentCategory!=='')html+='</div></div>';"
-        "        currentCategory=param.category;"
-        "        html+='<div class=\"card\"><div class=\"card-header\">'+param.category+'</div><div class=\"card-body\">';"
-        "      }"
-        "      var valueClass='param-value';"
-        "      if(param.unit==='°C')valueClass+=' temp-value';"
-        "      else if(param.unit==='W')valueClass+=' power-value';"
-        "      html+='<div class=\"param-row\"><span class=\"param-name\">'+param.name+'</span><span class=\"'+valueClass+'\">'+(param.value||'--')+(param.unit||'')+'</span></div>';"
-        "    });"
-        "    if(currentCategory!=='')html+='</div></div>';"
-        "    grid.innerHTML=html;"
-        "  }"
-        "  setElementText('lastUpdate',new Date().toLocaleTimeString());"
-        "}"
-        "function loadData(){"
-        "  var x=new XMLHttpRequest();"
-        "  x.open('GET','/json',true);"
-        "  x.onreadystatechange=function(){"
-        "    if(x.readyState==4){"
-        "      if(x.status==200){"
-        "        try{"
-        "          var data=JSON.parse(x.responseText);"
-        "          updateDisplay(data);"
-        "        }catch(e){"
-        "          console.error('JSON parsing error:', e);"
-        "        }"
-        "      }"
-        "    }"
-        "  };"
-        "  x.send();"
-        "}"
-        "function toggleAutoRefresh(){"
-        "  autoRefresh=!autoRefresh;"
-        "  var btn=document.getElementById('autoBtn');"
-        "  if(autoRefresh){"
-        "    btn.innerHTML='⏸️ Pause Auto-refresh';"
-        "    refreshInterval=setInterval(loadData,5000);"
-        "  }else{"
-        "    btn.innerHTML='▶️ Resume Auto-refresh';"
-        "    clearInterval(refreshInterval);"
-        "  }"
-        "}"
-        "window.onload=function(){"
-        "  loadData();"
-        "  refreshInterval=setInterval(loadData,5000);"
-        "};"
-        "</script>"
-        "</body></html>";
-    
+    ESP_LOGD(TAG, "HTML page requested");
+
+    httpd_resp_set_hdr(req, "ETag", index_etag);
+    httpd_resp_set_hdr(req, "Cache-Control", "max-age=" HTTP_STRINGIFY(CONFIG_HTTP_DASHBOARD_MAX_AGE_SEC) ", must-revalidate");
+    if (index_etag_matches(req)) {
+        httpd_resp_set_status(req, "304 Not Modified");
+        return httpd_resp_send(req, NULL, 0);
+    }
+
     httpd_resp_set_type(req, "text/html");
-    httpd_resp_send(req, html_start, strlen(html_start));
-    return ESP_OK;
+    httpd_resp_set_hdr(req, "Content-Encoding", "gzip");
+    return httpd_resp_send(req, (const char *)index_html_gz_start, index_html_gz_end - index_html_gz_start);
+}
+
+// Parameter definitions for HTTP server
+typedef struct {
+    uint16_t reg_addr;
+    const char *name;
+    mqtt_subtopic_t subtopic;
+} http_param_t;
+
+// All parameters shown on the dashboard, in display order
+static const http_param_t http_params[] = {
+    {MB_INPUT_STATUS, "Status", MQTT_SUB_SYS},
+    {MB_INPUT_EXTENDED_DATA, "Extended Data", MQTT_SUB_SYS},
+    {MB_INPUT_CACHE_STALE, "Cached Data", MQTT_SUB_SYS},
+    {MB_INPUT_CACHE_AGE, "Cache Age (s)", MQTT_SUB_SYS},
+    {MB_INPUT_MAIN_INLET_TEMP, "Main Inlet", MQTT_SUB_TEMP},
+    {MB_INPUT_MAIN_OUTLET_TEMP, "Main Outlet", MQTT_SUB_TEMP},
+    {MB_INPUT_MAIN_TARGET_TEMP, "Main Target", MQTT_SUB_TEMP},
+    {MB_INPUT_DHW_TEMP, "DHW", MQTT_SUB_TEMP},
+    {MB_INPUT_DHW_TARGET_TEMP, "DHW Target", MQTT_SUB_TEMP},
+    {MB_INPUT_OUTSIDE_TEMP, "Outside", MQTT_SUB_TEMP},
+    {MB_INPUT_ROOM_THERMOSTAT_TEMP, "Room Thermostat", MQTT_SUB_TEMP},
+    {MB_INPUT_BUFFER_TEMP, "Buffer", MQTT_SUB_TEMP},
+    {MB_INPUT_SOLAR_TEMP, "Solar", MQTT_SUB_TEMP},
+    {MB_INPUT_POOL_TEMP, "Pool", MQTT_SUB_TEMP},
+    {MB_INPUT_MAIN_HEX_OUTLET_TEMP, "Main HEX Outlet", MQTT_SUB_TEMP},
+    {MB_INPUT_DISCHARGE_TEMP, "Discharge", MQTT_SUB_TEMP},
+    {MB_INPUT_INSIDE_PIPE_TEMP, "Inside Pipe", MQTT_SUB_TEMP},
+    {MB_INPUT_DEFROST_TEMP, "Defrost", MQTT_SUB_TEMP},
+    {MB_INPUT_EVA_OUTLET_TEMP, "EVA Outlet", MQTT_SUB_TEMP},
+    {MB_INPUT_BYPASS_OUTLET_TEMP, "Bypass Outlet", MQTT_SUB_TEMP},
+    {MB_INPUT_IPM_TEMP, "IPM", MQTT_SUB_TEMP},
+    {MB_INPUT_OUTSIDE_PIPE_TEMP, "Outside Pipe", MQTT_SUB_TEMP},
+    {MB_INPUT_Z1_ROOM_TEMP, "Z1 Room", MQTT_SUB_TEMP},
+    {MB_INPUT_Z2_ROOM_TEMP, "Z2 Room", MQTT_SUB_TEMP},
+    {MB_INPUT_Z1_WATER_TEMP, "Z1 Water", MQTT_SUB_TEMP},
+    {MB_INPUT_Z2_WATER_TEMP, "Z2 Water", MQTT_SUB_TEMP},
+    {MB_INPUT_Z1_WATER_TARGET_TEMP, "Z1 Water Target", MQTT_SUB_TEMP},
+    {MB_INPUT_Z2_WATER_TARGET_TEMP, "Z2 Water Target", MQTT_SUB_TEMP},
+    {MB_INPUT_SECOND_INLET_TEMP, "Second Inlet", MQTT_SUB_TEMP},
+    {MB_INPUT_ECONOMIZER_OUTLET_TEMP, "Economizer Outlet", MQTT_SUB_TEMP},
+    {MB_INPUT_SECOND_ROOM_THERMO_TEMP, "Second Room Thermo", MQTT_SUB_TEMP},
+    {MB_INPUT_Z1_HEAT_REQUEST_TEMP, "Z1 Heat Request", MQTT_SUB_TEMP},
+    {MB_INPUT_Z1_COOL_REQUEST_TEMP, "Z1 Cool Request", MQTT_SUB_TEMP},
+    {MB_INPUT_Z2_HEAT_REQUEST_TEMP, "Z2 Heat Request", MQTT_SUB_TEMP},
+    {MB_INPUT_Z2_COOL_REQUEST_TEMP, "Z2 Cool Request", MQTT_SUB_TEMP},
+    {MB_INPUT_HEAT_POWER_PRODUCTION, "Heat Production", MQTT_SUB_POWER},
+    {MB_INPUT_HEAT_POWER_CONSUMPTION, "Heat Consumption", MQTT_SUB_POWER},
+    {MB_INPUT_COOL_POWER_PRODUCTION, "Cool Production", MQTT_SUB_POWER},
+    {MB_INPUT_COOL_POWER_CONSUMPTION, "Cool Consumption", MQTT_SUB_POWER},
+    {MB_INPUT_DHW_POWER_PRODUCTION, "DHW Production", MQTT_SUB_POWER},
+    {MB_INPUT_DHW_POWER_CONSUMPTION, "DHW Consumption", MQTT_SUB_POWER},
+    {MB_INPUT_COMPRESSOR_FREQ, "Compressor Frequency", MQTT_SUB_FREQ},
+    {MB_INPUT_PUMP_FLOW, "Pump Flow", MQTT_SUB_FLOW},
+    {MB_INPUT_OPERATIONS_HOURS, "Operations Hours", MQTT_SUB_HOUR},
+    {MB_INPUT_OPERATIONS_COUNTER, "Operations Counter", MQTT_SUB_COUNT},
+    {MB_INPUT_FAN1_MOTOR_SPEED, "Fan 1 Speed", MQTT_SUB_SPEED},
+    {MB_INPUT_FAN2_MOTOR_SPEED, "Fan 2 Speed", MQTT_SUB_SPEED},
+    {MB_INPUT_HIGH_PRESSURE, "High Pressure", MQTT_SUB_PRESS},
+    {MB_INPUT_PUMP_SPEED, "Pump Speed", MQTT_SUB_SPEED},
+    {MB_INPUT_LOW_PRESSURE, "Low Pressure", MQTT_SUB_PRESS},
+    {MB_INPUT_COMPRESSOR_CURRENT, "Compressor Current", MQTT_SUB_CURRENT},
+    {MB_INPUT_PUMP_DUTY, "Pump Duty", MQTT_SUB_DUTY},
+    {MB_INPUT_MAX_PUMP_DUTY, "Max Pump Duty", MQTT_SUB_DUTY},
+    {MB_INPUT_HEATPUMP_STATE, "Heat Pump State", MQTT_SUB_STATE},
+    {MB_INPUT_FORCE_DHW_STATE, "Force DHW", MQTT_SUB_STATE},
+    {MB_INPUT_OPERATING_MODE_STATE, "Operating Mode", MQTT_SUB_STATE},
+    {MB_INPUT_QUIET_MODE_SCHEDULE, "Quiet Mode Schedule", MQTT_SUB_STATE},
+    {MB_INPUT_POWERFUL_MODE_TIME, "Powerful Mode Time", MQTT_SUB_STATE},
+    {MB_INPUT_QUIET_MODE_LEVEL, "Quiet Mode Level", MQTT_SUB_STATE},
+    {MB_INPUT_HOLIDAY_MODE_STATE, "Holiday Mode", MQTT_SUB_STATE},
+    {MB_INPUT_THREE_WAY_VALVE_STATE, "Three-Way Valve", MQTT_SUB_STATE},
+    {MB_INPUT_DEFROSTING_STATE, "Defrosting", MQTT_SUB_STATE},
+    {MB_INPUT_MAIN_SCHEDULE_STATE, "Main Schedule", MQTT_SUB_STATE},
+    {MB_INPUT_ZONES_STATE, "Zones", MQTT_SUB_STATE},
+    {MB_INPUT_DHW_HEATER_STATE, "DHW Heater", MQTT_SUB_STATE},
+    {MB_INPUT_ROOM_HEATER_STATE, "Room Heater", MQTT_SUB_STATE},
+    {MB_INPUT_INTERNAL_HEATER_STATE, "Internal Heater", MQTT_SUB_STATE},
+    {MB_INPUT_EXTERNAL_HEATER_STATE, "External Heater", MQTT_SUB_STATE},
+    {MB_INPUT_FORCE_HEATER_STATE, "Force Heater", MQTT_SUB_STATE},
+    {MB_INPUT_STERILIZATION_STATE, "Sterilization", MQTT_SUB_STATE},
+    {MB_INPUT_STERILIZATION_TEMP, "Sterilization Temp", MQTT_SUB_TEMP},
+    {MB_INPUT_STERILIZATION_MAX_TIME, "Sterilization Max Time", MQTT_SUB_HOUR},
+    {MB_INPUT_DHW_HEAT_DELTA, "DHW Heat Delta", MQTT_SUB_TEMP},
+    {MB_INPUT_HEAT_DELTA, "Heat Delta", MQTT_SUB_TEMP},
+    {MB_INPUT_COOL_DELTA, "Cool Delta", MQTT_SUB_TEMP},
+    {MB_INPUT_DHW_HOLIDAY_SHIFT_TEMP, "DHW Holiday Shift", MQTT_SUB_TEMP},
+    {MB_INPUT_ROOM_HOLIDAY_SHIFT_TEMP, "Room Holiday Shift", MQTT_SUB_TEMP},
+    {MB_INPUT_BUFFER_TANK_DELTA, "Buffer Tank Delta", MQTT_SUB_TEMP},
+    {MB_INPUT_HEATING_MODE, "Heating Mode", MQTT_SUB_STATE},
+    {MB_INPUT_HEATING_OFF_OUTDOOR_TEMP, "Heating Off Outdoor", MQTT_SUB_TEMP},
+    {MB_INPUT_HEATER_ON_OUTDOOR_TEMP, "Heater On Outdoor", MQTT_SUB_TEMP},
+    {MB_INPUT_HEAT_TO_COOL_TEMP, "Heat to Cool", MQTT_SUB_TEMP},
+    {MB_INPUT_COOL_TO_HEAT_TEMP, "Cool to Heat", MQTT_SUB_TEMP},
+    {MB_INPUT_COOLING_MODE, "Cooling Mode", MQTT_SUB_STATE},
+    {MB_INPUT_BUFFER_INSTALLED, "Buffer Installed", MQTT_SUB_SYS},
+    {MB_INPUT_DHW_INSTALLED, "DHW Installed", MQTT_SUB_SYS},
+    {MB_INPUT_SOLAR_MODE, "Solar Mode", MQTT_SUB_STATE},
+    {MB_INPUT_SOLAR_ON_DELTA, "Solar On Delta", MQTT_SUB_TEMP},
+    {MB_INPUT_SOLAR_OFF_DELTA, "Solar Off Delta", MQTT_SUB_TEMP},
+    {MB_INPUT_SOLAR_FROST_PROTECTION, "Solar Frost Protection", MQTT_SUB_TEMP},
+    {MB_INPUT_SOLAR_HIGH_LIMIT, "Solar High Limit", MQTT_SUB_TEMP},
+    {MB_INPUT_PUMP_FLOWRATE_MODE, "Pump Flowrate Mode", MQTT_SUB_STATE},
+    {MB_INPUT_LIQUID_TYPE, "Liquid Type", MQTT_SUB_SYS},
+    {MB_INPUT_ALT_EXTERNAL_SENSOR, "Alt External Sensor", MQTT_SUB_SYS},
+    {MB_INPUT_ANTI_FREEZE_MODE, "Anti-Freeze Mode", MQTT_SUB_STATE},
+    {MB_INPUT_OPTIONAL_PCB, "Optional PCB", MQTT_SUB_SYS},
+    {MB_INPUT_Z1_SENSOR_SETTINGS, "Z1 Sensor Settings", MQTT_SUB_SYS},
+    {MB_INPUT_Z2_SENSOR_SETTINGS, "Z2 Sensor Settings", MQTT_SUB_SYS},
+    {MB_INPUT_EXTERNAL_PAD_HEATER, "External Pad Heater", MQTT_SUB_STATE},
+    {MB_INPUT_WATER_PRESSURE, "Water Pressure", MQTT_SUB_PRESS},
+    {MB_INPUT_EXTERNAL_CONTROL, "External Control", MQTT_SUB_STATE},
+    {MB_INPUT_EXTERNAL_HEAT_COOL_CONTROL, "External Heat/Cool", MQTT_SUB_STATE},
+    {MB_INPUT_EXTERNAL_ERROR_SIGNAL, "External Error", MQTT_SUB_STATE},
+    {MB_INPUT_EXTERNAL_COMPRESSOR_CONTROL, "External Compressor", MQTT_SUB_STATE},
+    {MB_INPUT_Z2_PUMP_STATE, "Z2 Pump", MQTT_SUB_STATE},
+    {MB_INPUT_Z1_PUMP_STATE, "Z1 Pump", MQTT_SUB_STATE},
+    {MB_INPUT_TWO_WAY_VALVE_STATE, "Two-Way Valve", MQTT_SUB_STATE},
+    {MB_INPUT_THREE_WAY_VALVE_STATE2, "Three-Way Valve 2", MQTT_SUB_STATE},
+    {MB_INPUT_Z1_VALVE_PID, "Z1 Valve PID", MQTT_SUB_SYS},
+    {MB_INPUT_Z2_VALVE_PID, "Z2 Valve PID", MQTT_SUB_SYS},
+    {MB_INPUT_BIVALENT_CONTROL, "Bivalent Control", MQTT_SUB_STATE},
+    {MB_INPUT_BIVALENT_MODE, "Bivalent Mode", MQTT_SUB_STATE},
+    {MB_INPUT_BIVALENT_START_TEMP, "Bivalent Start Temp", MQTT_SUB_TEMP},
+    {MB_INPUT_BIVALENT_ADVANCED_HEAT, "Bivalent Advanced Heat", MQTT_SUB_STATE},
+    {MB_INPUT_BIVALENT_ADVANCED_DHW, "Bivalent Advanced DHW", MQTT_SUB_STATE},
+    {MB_INPUT_BIVALENT_ADVANCED_START_TEMP, "Bivalent Advanced Start", MQTT_SUB_TEMP},
+    {MB_INPUT_BIVALENT_ADVANCED_STOP_TEMP, "Bivalent Advanced Stop", MQTT_SUB_TEMP},
+    {MB_INPUT_BIVALENT_ADVANCED_START_DELAY, "Bivalent Advanced Start Delay", MQTT_SUB_HOUR},
+    {MB_INPUT_BIVALENT_ADVANCED_STOP_DELAY, "Bivalent Advanced Stop Delay", MQTT_SUB_HOUR},
+    {MB_INPUT_BIVALENT_ADVANCED_DHW_DELAY, "Bivalent Advanced DHW Delay", MQTT_SUB_HOUR},
+    {MB_INPUT_HEATER_DELAY_TIME, "Heater Delay Time", MQTT_SUB_HOUR},
+    {MB_INPUT_HEATER_START_DELTA, "Heater Start Delta", MQTT_SUB_TEMP},
+    {MB_INPUT_HEATER_STOP_DELTA, "Heater Stop Delta", MQTT_SUB_TEMP},
+    {MB_INPUT_ERROR_TYPE, "Error Type", MQTT_SUB_ERROR},
+    {MB_INPUT_ERROR_NUMBER, "Error Number", MQTT_SUB_ERROR},
+    {MB_INPUT_ROOM_HEATER_OPS_HOURS, "Room Heater Ops Hours", MQTT_SUB_HOUR},
+    {MB_INPUT_DHW_HEATER_OPS_HOURS, "DHW Heater Ops Hours", MQTT_SUB_HOUR},
+    {MB_INPUT_Z1_WATER_PUMP, "Z1 Water Pump", MQTT_SUB_STATE},
+    {MB_INPUT_Z1_MIXING_VALVE, "Z1 Mixing Valve", MQTT_SUB_STATE},
+    {MB_INPUT_Z2_WATER_PUMP, "Z2 Water Pump", MQTT_SUB_STATE},
+    {MB_INPUT_Z2_MIXING_VALVE, "Z2 Mixing Valve", MQTT_SUB_STATE},
+    {MB_INPUT_POOL_WATER_PUMP, "Pool Water Pump", MQTT_SUB_STATE},
+    {MB_INPUT_SOLAR_WATER_PUMP, "Solar Water Pump", MQTT_SUB_STATE},
+    {MB_INPUT_ALARM_STATE, "Alarm State", MQTT_SUB_STATE},
+    {MB_INPUT_ADC_AIN, "ADC AIN", MQTT_SUB_SYS},
+    {MB_INPUT_ADC_NTC1, "ADC NTC1", MQTT_SUB_TEMP},
+    {MB_INPUT_ADC_NTC2, "ADC NTC2", MQTT_SUB_TEMP},
+    {MB_INPUT_DS18B20_TEMP,  "DS18B20 #1", MQTT_SUB_TEMP},
+    {MB_INPUT_DS18B20_TEMP2, "DS18B20 #2", MQTT_SUB_TEMP},
+    {MB_INPUT_DS18B20_TEMP3, "DS18B20 #3", MQTT_SUB_TEMP},
+    {MB_INPUT_DS18B20_TEMP4, "DS18B20 #4", MQTT_SUB_TEMP},
+    {MB_INPUT_DS18B20_TEMP5, "DS18B20 #5", MQTT_SUB_TEMP},
+    {MB_INPUT_DS18B20_TEMP6, "DS18B20 #6", MQTT_SUB_TEMP},
+    {MB_INPUT_DS18B20_TEMP7, "DS18B20 #7", MQTT_SUB_TEMP},
+    {MB_INPUT_DS18B20_TEMP8, "DS18B20 #8", MQTT_SUB_TEMP},
+    {0, NULL, 0} // End marker
+};
+
+// Category mapping
+static const char *const category_map[] = {
+    [MQTT_SUB_SYS] = "🔧 System",
+    [MQTT_SUB_TEMP] = "🌡️ Temperatures",
+    [MQTT_SUB_FLOW] = "💧 Flow",
+    [MQTT_SUB_STATE] = "⚙️ States",
+    [MQTT_SUB_POWER] = "⚡ Power",
+    [MQTT_SUB_FREQ] = "📊 Frequency",
+    [MQTT_SUB_HOUR] = "⏱️ Hours",
+    [MQTT_SUB_COUNT] = "🔢 Counters",
+    [MQTT_SUB_SPEED] = "🌪️ Speed",
+    [MQTT_SUB_PRESS] = "📊 Pressure",
+    [MQTT_SUB_CURRENT] = "⚡ Current",
+    [MQTT_SUB_DUTY] = "📈 Duty",
+    [MQTT_SUB_ERROR] = "⚠️ Errors"
+};
+
+// Compact JSON streamed with httpd_resp_send_chunk() from a fixed buffer
+typedef struct {
+    httpd_req_t *req;
+    esp_err_t err;          // First send error, later writes are dropped
+    size_t used;
+    char buf[CONFIG_HTTP_JSON_CHUNK_SIZE];
+} json_stream_t;
+
+static void json_stream_flush(json_stream_t *js) {
+    if (js->err == ESP_OK && js->used > 0) {
+        js->err = httpd_resp_send_chunk(js->req, js->buf, js->used);
+    }
+    js->used = 0;
+}
+
+static void json_stream_raw(json_stream_t *js, const char *data, size_t len) {
+    while (len > 0 && js->err == ESP_OK) {
+        size_t n = sizeof(js->buf) - js->used;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(js->buf + js->used, data, n);
+        js->used += n;
+        data += n;
+        len -= n;
+        if (js->used == sizeof(js->buf)) {
+            json_stream_flush(js);
+        }
+    }
+}
+
+static void json_stream_puts(json_stream_t *js, const char *text) {
+    json_stream_raw(js, text, strlen(text));
+}
+
+static void json_stream_printf(json_stream_t *js, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void json_stream_printf(json_stream_t *js, const char *fmt, ...) {
+    char tmp[128];
+    va_list args;
+    va_start(args, fmt);
+    int len = vsnprintf(tmp, sizeof(tmp), fmt, args);
+    va_end(args);
+    if (len > 0) {
+        json_stream_raw(js, tmp, (size_t)len < sizeof(tmp) ? (size_t)len : sizeof(tmp) - 1);
+    }
+}
+
+// Quoted JSON string; UTF-8 passes through, control characters are escaped
+static void json_stream_string(json_stream_t *js, const char *text) {
+    json_stream_raw(js, "\"", 1);
+    const char *run = text;
+    for (const char *p = text; *p != '\0'; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (c != '"' && c != '\\' && c >= 0x20) {
+            continue;
+        }
+        json_stream_raw(js, run, p - run);
+        if (c == '"' || c == '\\') {
+            char esc[2] = { '\\', (char)c };
+            json_stream_raw(js, esc, sizeof(esc));
+        } else {
+            json_stream_printf(js, "\\u%04x", c);
+        }
+        run = p + 1;
+    }
+    json_stream_puts(js, run);
+    json_stream_raw(js, "\"", 1);
+}
+
+// "key":"value"
+static void json_stream_field(json_stream_t *js, const char *key, const char *value) {
+    json_stream_string(js, key);
+    json_stream_raw(js, ":", 1);
+    json_stream_string(js, value);
+}
+
+// Format a parameter value and pick its unit
+static const char *json_param_value(const http_param_t *param, int16_t value, char *buf, size_t len) {
+    uint16_t reg_addr = param->reg_addr;
+    switch (param->subtopic) {
+        case MQTT_SUB_TEMP: {
+            bool is_x100 =
+                (reg_addr == MB_INPUT_MAIN_INLET_TEMP) ||
+                (reg_addr == MB_INPUT_MAIN_OUTLET_TEMP) ||
+                (reg_addr >= MB_INPUT_DS18B20_TEMP && reg_addr <= MB_INPUT_DS18B20_TEMP8) ||
+                (reg_addr == MB_INPUT_ADC_NTC1) ||
+                (reg_addr == MB_INPUT_ADC_NTC2);
+            if (is_x100) {
+                snprintf(buf, len, "%.2f", value / 100.0f);
+            } else {
+                snprintf(buf, len, "%d", value);
+            }
+            return "°C";
+        }
+        case MQTT_SUB_POWER:
+            snprintf(buf, len, "%d", value);
+            return "W";
+        case MQTT_SUB_FREQ:
+            snprintf(buf, len, "%d", value);
+            return "Hz";
+        case MQTT_SUB_FLOW:
+            snprintf(buf, len, "%d", value);
+            return "L/min";
+        case MQTT_SUB_SPEED:
+            snprintf(buf, len, "%d", value);
+            return "rpm";
+        case MQTT_SUB_PRESS:
+            snprintf(buf, len, "%d", value);
+            return "bar";
+        case MQTT_SUB_CURRENT:
+            snprintf(buf, len, "%d", value);
+            return "A";
+        case MQTT_SUB_DUTY:
+            snprintf(buf, len, "%d", value);
+            return "%";
+        case MQTT_SUB_HOUR:
+            snprintf(buf, len, "%d", value);
+            return "H";
+        default:
+            snprintf(buf, len, "%d", value);
+            return "";
+    }
 }
 
-// JSON API handler
+// Register snapshot of the request being served. The server runs all
+// handlers in its one task, so a single static copy is enough.
+static int16_t json_regs[MB_REG_INPUT_COUNT];
+
+// JSON API handler - streams compact JSON without heap allocations
 static esp_err_t json_handler(httpd_req_t *req) {
-    cJSON *json = cJSON_CreateObject();
-    cJSON *params_array = cJSON_CreateArray();
-    
+    // Work on a coherent copy so all values come from the same frame
+    modbus_params_read_inputs(json_regs, MB_REG_INPUT_START, MB_REG_INPUT_COUNT);
+    const int16_t *regs = json_regs;
+
     // Check if we have valid data
-    bool data_valid = (mb_input_registers[MB_INPUT_STATUS] != 0 || 
-                       mb_input_registers[MB_INPUT_MAIN_INLET_TEMP] != INT16_MIN);
-    
-    // Parameter definitions for HTTP server
-    typedef struct {
-        uint16_t reg_addr;
-        const char *name;
-        mqtt_subtopic_t subtopic;
-    } http_param_t;
-    
-    // Define all parameters we want to display
-    static const http_param_t http_params[] = {
-        {MB_INPUT_STATUS, "Status", MQTT_SUB_SYS},
-        {MB_INPUT_EXTENDED_DATA, "Extended Data", MQTT_SUB_SYS},
-        {MB_INPUT_MAIN_INLET_TEMP, "Main Inlet", MQTT_SUB_TEMP},
-        {MB_INPUT_MAIN_OUTLET_TEMP, "Main Outlet", MQTT_SUB_TEMP},
-        {MB_INPUT_MAIN_TARGET_TEMP, "Main Target", MQTT_SUB_TEMP},
-        {MB_INPUT_DHW_TEMP, "DHW", MQTT_SUB_TEMP},
-        {MB_INPUT_DHW_TARGET_TEMP, "DHW Target", MQTT_SUB_TEMP},
-        {MB_INPUT_OUTSIDE_TEMP, "Outside", MQTT_SUB_TEMP},
-        {MB_INPUT_ROOM_THERMOSTAT_TEMP, "Room Thermostat", MQTT_SUB_TEMP},
-        {MB_INPUT_BUFFER_TEMP, "Buffer", MQTT_SUB_TEMP},
-        {MB_INPUT_SOLAR_TEMP, "Solar", MQTT_SUB_TEMP},
-        {MB_INPUT_POOL_TEMP, "Pool", MQTT_SUB_TEMP},
-        {MB_INPUT_MAIN_HEX_OUTLET_TEMP, "Main HEX Outlet", MQTT_SUB_TEMP},
-        {MB_INPUT_DISCHARGE_TEMP, "Discharge", MQTT_SUB_TEMP},
-        {MB_INPUT_INSIDE_PIPE_TEMP, "Inside Pipe", MQTT_SUB_TEMP},
-        {MB_INPUT_DEFROST_TEMP, "Defrost", MQTT_SUB_TEMP},
-        {MB_INPUT_EVA_OUTLET_TEMP, "EVA Outlet", MQTT_SUB_TEMP},
-        {MB_INPUT_BYPASS_OUTLET_TEMP, "Bypass Outlet", MQTT_SUB_TEMP},
-        {MB_INPUT_IPM_TEMP, "IPM", MQTT_SUB_TEMP},
-        {MB_INPUT_OUTSIDE_PIPE_TEMP, "Outside Pipe", MQTT_SUB_TEMP},
-        {MB_INPUT_Z1_ROOM_TEMP, "Z1 Room", MQTT_SUB_TEMP},
-        {MB_INPUT_Z2_ROOM_TEMP, "Z2 Room", MQTT_SUB_TEMP},
-        {MB_INPUT_Z1_WATER_TEMP, "Z1 Water", MQTT_SUB_TEMP},
-        {MB_INPUT_Z2_WATER_TEMP, "Z2 Water", MQTT_SUB_TEMP},
-        {MB_INPUT_Z1_WATER_TARGET_TEMP, "Z1 Water Target", MQTT_SUB_TEMP},
-        {MB_INPUT_Z2_WATER_TARGET_TEMP, "Z2 Water Target", MQTT_SUB_TEMP},
-        {MB_INPUT_SECOND_INLET_TEMP, "Second Inlet", MQTT_SUB_TEMP},
-        {MB_INPUT_ECONOMIZER_OUTLET_TEMP, "Economizer Outlet", MQTT_SUB_TEMP},
-        {MB_INPUT_SECOND_ROOM_THERMO_TEMP, "Second Room Thermo", MQTT_SUB_TEMP},
-        {MB_INPUT_Z1_HEAT_REQUEST_TEMP, "Z1 Heat Request", MQTT_SUB_TEMP},
-        {MB_INPUT_Z1_COOL_REQUEST_TEMP, "Z1 Cool Request", MQTT_SUB_TEMP},
-        {MB_INPUT_Z2_HEAT_REQUEST_TEMP, "Z2 Heat Request", MQTT_SUB_TEMP},
-        {MB_INPUT_Z2_COOL_REQUEST_TEMP, "Z2 Cool Request", MQTT_SUB_TEMP},
-        {MB_INPUT_HEAT_POWER_PRODUCTION, "Heat Production", MQTT_SUB_POWER},
-        {MB_INPUT_HEAT_POWER_CONSUMPTION, "Heat Consumption", MQTT_SUB_POWER},
-        {MB_INPUT_COOL_POWER_PRODUCTION, "Cool Production", MQTT_SUB_POWER},
-        {MB_INPUT_COOL_POWER_CONSUMPTION, "Cool Consumption", MQTT_SUB_POWER},
-        {MB_INPUT_DHW_POWER_PRODUCTION, "DHW Production", MQTT_SUB_POWER},
-        {MB_INPUT_DHW_POWER_CONSUMPTION, "DHW Consumption", MQTT_SUB_POWER},
-        {MB_INPUT_COMPRESSOR_FREQ, "Compressor Frequency", MQTT_SUB_FREQ},
-        {MB_INPUT_PUMP_FLOW, "Pump Flow", MQTT_SUB_FLOW},
-        {MB_INPUT_OPERATIONS_HOURS, "Operations Hours", MQTT_SUB_HOUR},
-        {MB_INPUT_OPERATIONS_COUNTER, "Operations Counter", MQTT_SUB_COUNT},
-        {MB_INPUT_FAN1_MOTOR_SPEED, "Fan 1 Speed", MQTT_SUB_SPEED},
-        {MB_INPUT_FAN2_MOTOR_SPEED, "Fan 2 Speed", MQTT_SUB_SPEED},
-        {MB_INPUT_HIGH_PRESSURE, "High Pressure", MQTT_SUB_PRESS},
-        {MB_INPUT_PUMP_SPEED, "Pump Speed", MQTT_SUB_SPEED},
-        {MB_INPUT_LOW_PRESSURE, "Low Pressure", MQTT_SUB_PRESS},
-        {MB_INPUT_COMPRESSOR_CURRENT, "Compressor Current", MQTT_SUB_CURRENT},
-        {MB_INPUT_PUMP_DUTY, "Pump Duty", MQTT_SUB_DUTY},
-        {MB_INPUT_MAX_PUMP_DUTY, "Max Pump Duty", MQTT_SUB_DUTY},
-        {MB_INPUT_HEATPUMP_STATE, "Heat Pump State", MQTT_SUB_STATE},
-        {MB_INPUT_FORCE_DHW_STATE, "Force DHW", MQTT_SUB_STATE},
-        {MB_INPUT_OPERATING_MODE_STATE, "Operating Mode", MQTT_SUB_STATE},
-        {MB_INPUT_QUIET_MODE_SCHEDULE, "Quiet Mode Schedule", MQTT_SUB_STATE},
-        {MB_INPUT_POWERFUL_MODE_TIME, "Powerful Mode Time", MQTT_SUB_STATE},
-        {MB_INPUT_QUIET_MODE_LEVEL, "Quiet Mode Level", MQTT_SUB_STATE},
-        {MB_INPUT_HOLIDAY_MODE_STATE, "Holiday Mode", MQTT_SUB_STATE},
-        {MB_INPUT_THREE_WAY_VALVE_STATE, "Three-Way Valve", MQTT_SUB_STATE},
-        {MB_INPUT_DEFROSTING_STATE, "Defrosting", MQTT_SUB_STATE},
-        {MB_INPUT_MAIN_SCHEDULE_STATE, "Main Schedule", MQTT_SUB_STATE},
-        {MB_INPUT_ZONES_STATE, "Zones", MQTT_SUB_STATE},
-        {MB_INPUT_DHW_HEATER_STATE, "DHW Heater", MQTT_SUB_STATE},
-        {MB_INPUT_ROOM_HEATER_STATE, "Room Heater", MQTT_SUB_STATE},
-        {MB_INPUT_INTERNAL_HEATER_STATE, "Internal Heater", MQTT_SUB_STATE},
-        {MB_INPUT_EXTERNAL_HEATER_STATE, "External Heater", MQTT_SUB_STATE},
-        {MB_INPUT_FORCE_HEATER_STATE, "Force Heater", MQTT_SUB_STATE},
-        {MB_INPUT_STERILIZATION_STATE, "Sterilization", MQTT_SUB_STATE},
-        {MB_INPUT_STERILIZATION_TEMP, "Sterilization Temp", MQTT_SUB_TEMP},
-        {MB_INPUT_STERILIZATION_MAX_TIME, "Sterilization Max Time", MQTT_SUB_HOUR},
-        {MB_INPUT_DHW_HEAT_DELTA, "DHW Heat Delta", MQTT_SUB_TEMP},
-        {MB_INPUT_HEAT_DELTA, "Heat Delta", MQTT_SUB_TEMP},
-        {MB_INPUT_COOL_DELTA, "Cool Delta", MQTT_SUB_TEMP},
-        {MB_INPUT_DHW_HOLIDAY_SHIFT_TEMP, "DHW Holiday Shift", MQTT_SUB_TEMP},
-        {MB_INPUT_ROOM_HOLIDAY_SHIFT_TEMP, "Room Holiday Shift", MQTT_SUB_TEMP},
-        {MB_INPUT_BUFFER_TANK_DELTA, "Buffer Tank Delta", MQTT_SUB_TEMP},
-        {MB_INPUT_HEATING_MODE, "Heating Mode", MQTT_SUB_STATE},
-        {MB_INPUT_HEATING_OFF_OUTDOOR_TEMP, "Heating Off Outdoor", MQTT_SUB_TEMP},
-        {MB_INPUT_HEATER_ON_OUTDOOR_TEMP, "Heater On Outdoor", MQTT_SUB_TEMP},
-        {MB_INPUT_HEAT_TO_COOL_TEMP, "Heat to Cool", MQTT_SUB_TEMP},
-        {MB_INPUT_COOL_TO_HEAT_TEMP, "Cool to Heat", MQTT_SUB_TEMP},
-        {MB_INPUT_COOLING_MODE, "Cooling Mode", MQTT_SUB_STATE},
-        {MB_INPUT_BUFFER_INSTALLED, "Buffer Installed", MQTT_SUB_SYS},
-        {MB_INPUT_DHW_INSTALLED, "DHW Installed", MQTT_SUB_SYS},
-        {MB_INPUT_SOLAR_MODE, "Solar Mode", MQTT_SUB_STATE},
-        {MB_INPUT_SOLAR_ON_DELTA, "Solar On Delta", MQTT_SUB_TEMP},
-        {MB_INPUT_SOLAR_OFF_DELTA, "Solar Off Delta", MQTT_SUB_TEMP},
-        {MB_INPUT_SOLAR_FROST_PROTECTION, "Solar Frost Protection", MQTT_SUB_TEMP},
-        {MB_INPUT_SOLAR_HIGH_LIMIT, "Solar High Limit", MQTT_SUB_TEMP},
-        {MB_INPUT_PUMP_FLOWRATE_MODE, "Pump Flowrate Mode", MQTT_SUB_STATE},
-        {MB_INPUT_LIQUID_TYPE, "Liquid Type", MQTT_SUB_SYS},
-        {MB_INPUT_ALT_EXTERNAL_SENSOR, "Alt External Sensor", MQTT_SUB_SYS},
-        {MB_INPUT_ANTI_FREEZE_MODE, "Anti-Freeze Mode", MQTT_SUB_STATE},
-        {MB_INPUT_OPTIONAL_PCB, "Optional PCB", MQTT_SUB_SYS},
-        {MB_INPUT_Z1_SENSOR_SETTINGS, "Z1 Sensor Settings", MQTT_SUB_SYS},
-        {MB_INPUT_Z2_SENSOR_SETTINGS, "Z2 Sensor Settings", MQTT_SUB_SYS},
-        {MB_INPUT_EXTERNAL_PAD_HEATER, "External Pad Heater", MQTT_SUB_STATE},
-        {MB_INPUT_WATER_PRESSURE, "Water Pressure", MQTT_SUB_PRESS},
-        {MB_INPUT_EXTERNAL_CONTROL, "External Control", MQTT_SUB_STATE},
-        {MB_INPUT_EXTERNAL_HEAT_COOL_CONTROL, "External Heat/Cool", MQTT_SUB_STATE},
-        {MB_INPUT_EXTERNAL_ERROR_SIGNAL, "External Error", MQTT_SUB_STATE},
-        {MB_INPUT_EXTERNAL_COMPRESSOR_CONTROL, "External Compressor", MQTT_SUB_STATE},
-        {MB_INPUT_Z2_PUMP_STATE, "Z2 Pump", MQTT_SUB_STATE},
-        {MB_INPUT_Z1_PUMP_STATE, "Z1 Pump", MQTT_SUB_STATE},
-        {MB_INPUT_TWO_WAY_VALVE_STATE, "Two-Way Valve", MQTT_SUB_STATE},
-        {MB_INPUT_THREE_WAY_VALVE_STATE2, "Three-Way Valve 2", MQTT_SUB_STATE},
-        {MB_INPUT_Z1_VALVE_PID, "Z1 Valve PID", MQTT_SUB_SYS},
-        {MB_INPUT_Z2_VALVE_PID, "Z2 Valve PID", MQTT_SUB_SYS},
-        {MB_INPUT_BIVALENT_CONTROL, "Bivalent Control", MQTT_SUB_STATE},
-        {MB_INPUT_BIVALENT_MODE, "Bivalent Mode", MQTT_SUB_STATE},
-        {MB_INPUT_BIVALENT_START_TEMP, "Bivalent Start Temp", MQTT_SUB_TEMP},
-        {MB_INPUT_BIVALENT_ADVANCED_HEAT, "Bivalent Advanced Heat", MQTT_SUB_STATE},
-        {MB_INPUT_BIVALENT_ADVANCED_DHW, "Bivalent Advanced DHW", MQTT_SUB_STATE},
-        {MB_INPUT_BIVALENT_ADVANCED_START_TEMP, "Bivalent Advanced Start", MQTT_SUB_TEMP},
-        {MB_INPUT_BIVALENT_ADVANCED_STOP_TEMP, "Bivalent Advanced Stop", MQTT_SUB_TEMP},
-        {MB_INPUT_BIVALENT_ADVANCED_START_DELAY, "Bivalent Advanced Start Delay", MQTT_SUB_HOUR},
-        {MB_INPUT_BIVALENT_ADVANCED_STOP_DELAY, "Bivalent Advanced Stop Delay", MQTT_SUB_HOUR},
-        {MB_INPUT_BIVALENT_ADVANCED_DHW_DELAY, "Bivalent Advanced DHW Delay", MQTT_SUB_HOUR},
-        {MB_INPUT_HEATER_DELAY_TIME, "Heater Delay Time", MQTT_SUB_HOUR},
-        {MB_INPUT_HEATER_START_DELTA, "Heater Start Delta", MQTT_SUB_TEMP},
-        {MB_INPUT_HEATER_STOP_DELTA, "Heater Stop Delta", MQTT_SUB_TEMP},
-        {MB_INPUT_ERROR_TYPE, "Error Type", MQTT_SUB_ERROR},
-        {MB_INPUT_ERROR_NUMBER, "Error Number", MQTT_SUB_ERROR},
-        {MB_INPUT_ROOM_HEATER_OPS_HOURS, "Room Heater Ops Hours", MQTT_SUB_HOUR},
-        {MB_INPUT_DHW_HEATER_OPS_HOURS, "DHW Heater Ops Hours", MQTT_SUB_HOUR},
-        {MB_INPUT_Z1_WATER_PUMP, "Z1 Water Pump", MQTT_SUB_STATE},
-        {MB_INPUT_Z1_MIXING_VALVE, "Z1 Mixing Valve", MQTT_SUB_STATE},
-        {MB_INPUT_Z2_WATER_PUMP, "Z2 Water Pump", MQTT_SUB_STATE},
-        {MB_INPUT_Z2_MIXING_VALVE, "Z2 Mixing Valve", MQTT_SUB_STATE},
-        {MB_INPUT_POOL_WATER_PUMP, "Pool Water Pump", MQTT_SUB_STATE},
-        {MB_INPUT_SOLAR_WATER_PUMP, "Solar Water Pump", MQTT_SUB_STATE},
-        {MB_INPUT_ALARM_STATE, "Alarm State", MQTT_SUB_STATE},
-        {MB_INPUT_ADC_AIN, "ADC AIN", MQTT_SUB_SYS},
-        {MB_INPUT_ADC_NTC1, "ADC NTC1", MQTT_SUB_TEMP},
-        {MB_INPUT_ADC_NTC2, "ADC NTC2", MQTT_SUB_TEMP},
-        {MB_INPUT_DS18B20_TEMP,  "DS18B20 #1", MQTT_SUB_TEMP},
-        {MB_INPUT_DS18B20_TEMP2, "DS18B20 #2", MQTT_SUB_TEMP},
-        {MB_INPUT_DS18B20_TEMP3, "DS18B20 #3", MQTT_SUB_TEMP},
-        {MB_INPUT_DS18B20_TEMP4, "DS18B20 #4", MQTT_SUB_TEMP},
-        {MB_INPUT_DS18B20_TEMP5, "DS18B20 #5", MQTT_SUB_TEMP},
-        {MB_INPUT_DS18B20_TEMP6, "DS18B20 #6", MQTT_SUB_TEMP},
-        {MB_INPUT_DS18B20_TEMP7, "DS18B20 #7", MQTT_SUB_TEMP},
-        {MB_INPUT_DS18B20_TEMP8, "DS18B20 #8", MQTT_SUB_TEMP},
-        {0, NULL, 0} // End marker
-    };
-    
-    // Category mapping
-    const char* category_map[] = {
-        [MQTT_SUB_SYS] = "🔧 System",
-        [MQTT_SUB_TEMP] = "🌡️ Temperatures",
-        [MQTT_SUB_FLOW] = "💧 Flow",
-        [MQTT_SUB_STATE] = "⚙️ States",
-        [MQTT_SUB_POWER] = "⚡ Power",
-        [MQTT_SUB_FREQ] = "📊 Frequency",
-        [MQTT_SUB_HOUR] = "⏱️ Hours",
-        [MQTT_SUB_COUNT] = "🔢 Counters",
-        [MQTT_SUB_SPEED] = "🌪️ Speed",
-        [MQTT_SUB_PRESS] = "📊 Pressure",
-        [MQTT_SUB_CURRENT] = "⚡ Current",
-        [MQTT_SUB_DUTY] = "📈 Duty",
-        [MQTT_SUB_ERROR] = "⚠️ Errors"
-    };
-    
+    bool data_valid = (regs[MB_INPUT_STATUS] != 0 || 
+                       regs[MB_INPUT_MAIN_INLET_TEMP] != INT16_MIN);
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
+
+    json_stream_t js = { .req = req, .err = ESP_OK, .used = 0 };
+    json_stream_puts(&js, "{\"params\":[");
+
+    bool first = true;
     for (size_t i = 0; http_params[i].reg_addr != 0; i++) {
-        uint16_t reg_addr = http_params[i].reg_addr;
-        const char *name = http_params[i].name;
-        mqtt_subtopic_t subtopic = http_params[i].subtopic;
-        
-        int16_t value = mb_input_registers[reg_addr];
-        
+        const http_param_t *param = &http_params[i];
+        int16_t value = regs[param->reg_addr];
         if (value == INT16_MIN) {
             continue; // Skip invalid values
         }
-        
-        cJSON *param = cJSON_CreateObject();
-        cJSON_AddStringToObject(param, "name", name);
-        
-        char value_str[64];
-        const char *unit = "";
-        
-        switch (subtopic) {
-            case MQTT_SUB_TEMP: {
-                bool is_x100 =
-                    (reg_addr == MB_INPUT_MAIN_INLET_TEMP) ||
-                    (reg_addr == MB_INPUT_MAIN_OUTLET_TEMP) ||
-                    (reg_addr >= MB_INPUT_DS18B20_TEMP && reg_addr <= MB_INPUT_DS18B20_TEMP8) ||
-                    (reg_addr == MB_INPUT_ADC_NTC1) ||
-                    (reg_addr == MB_INPUT_ADC_NTC2);
-                if (is_x100) {
-                    snprintf(value_str, sizeof(value_str), "%.2f", value / 100.0f);
-                } else {
-                    snprintf(value_str, sizeof(value_str), "%d", value);
-                }
-                unit = "°C";
-                break;
-            }
-            case MQTT_SUB_POWER:
-                snprintf(value_str, sizeof(value_str), "%d", value);
-                unit = "W";
-                break;
-            case MQTT_SUB_FREQ:
-                snprintf(value_str, sizeof(value_str), "%d", value);
-                unit = "Hz";
-                break;
-            case MQTT_SUB_FLOW:
-                snprintf(value_str, sizeof(value_str), "%d", value);
-                unit = "L/min";
-                break;
-            case MQTT_SUB_SPEED:
-                snprintf(value_str, sizeof(value_str), "%d", value);
-                unit = "rpm";
-                break;
-            case MQTT_SUB_PRESS:
-                snprintf(value_str, sizeof(value_str), "%d", value);
-                unit = "bar";
-                break;
-            case MQTT_SUB_CURRENT:
-                snprintf(value_str, sizeof(value_str), "%d", value);
-                unit = "A";
-                break;
-            case MQTT_SUB_DUTY:
-                snprintf(value_str, sizeof(value_str), "%d", value);
-                unit = "%";
-                break;
-            case MQTT_SUB_HOUR:
-                snprintf(value_str, sizeof(value_str), "%d", value);
-                unit = "H";
-                break;
-            default:
-                snprintf(value_str, sizeof(value_str), "%d", value);
-                break;
-        }
-        
-        cJSON_AddStringToObject(param, "value", value_str);
-        cJSON_AddStringToObject(param, "unit", unit);
-        if (subtopic < sizeof(category_map) / sizeof(category_map[0])) {
-            cJSON_AddStringToObject(param, "category", category_map[subtopic]);
-        } else {
-            cJSON_AddStringToObject(param, "category", "📊 Other");
+
+        char value_str[16];
+        const char *unit = json_param_value(param, value, value_str, sizeof(value_str));
+        const char *category = "📊 Other";
+        if (param->subtopic < sizeof(category_map) / sizeof(category_map[0]) && category_map[param->subtopic] != NULL) {
+            category = category_map[param->subtopic];
         }
-        
-        cJSON_AddItemToArray(params_array, param);
+
+        json_stream_printf(&js, first ? "{\"reg\":%u," : ",{\"reg\":%u,", param->reg_addr);
+        first = false;
+        json_stream_field(&js, "name", param->name);
+        json_stream_raw(&js, ",", 1);
+        json_stream_field(&js, "value", value_str);
+        json_stream_raw(&js, ",", 1);
+        json_stream_field(&js, "unit", unit);
+        json_stream_raw(&js, ",", 1);
+        json_stream_field(&js, "category", category);
+        json_stream_raw(&js, "}", 1);
     }
-    
-    cJSON_AddItemToObject(json, "params", params_array);
-    cJSON_AddStringToObject(json, "status", data_valid ? "online" : "offline");
-    
+
+    json_stream_puts(&js, "],");
+    json_stream_field(&js, "status", data_valid ? "online" : "offline");
+
     // System information
-    cJSON_AddNumberToObject(json, "uptime", (float)esp_timer_get_time() / (1000000.0f * 3600.0f));
-    cJSON_AddNumberToObject(json, "free_memory", (float)(esp_get_free_heap_size() / 1024.0f));
-    
+    json_stream_printf(&js, ",\"uptime\":%.4f", (double)esp_timer_get_time() / (1000000.0 * 3600.0));
+    json_stream_printf(&js, ",\"free_memory\":%.1f", esp_get_free_heap_size() / 1024.0);
+
     // WiFi information
     wifi_ap_record_t ap_info;
     if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
-        cJSON_AddNumberToObject(json, "wifi_rssi", ap_info.rssi);
-        cJSON_AddStringToObject(json, "wifi_ssid", (char*)ap_info.ssid);
+        json_stream_printf(&js, ",\"wifi_rssi\":%d,", ap_info.rssi);
+        json_stream_field(&js, "wifi_ssid", (const char *)ap_info.ssid);
     } else {
-        cJSON_AddNumberToObject(json, "wifi_rssi", 0);
-        cJSON_AddStringToObject(json, "wifi_ssid", "Not connected");
+        json_stream_puts(&js, ",\"wifi_rssi\":0,");
+        json_stream_field(&js, "wifi_ssid", "Not connected");
     }
-    
+
     // IP address
     char ip_str[32];
+    json_stream_raw(&js, ",", 1);
     if (wifi_connect_get_ip(ip_str, sizeof(ip_str)) == ESP_OK) {
-        cJSON_AddStringToObject(json, "device_ip", ip_str);
+        json_stream_field(&js, "device_ip", ip_str);
     } else {
-        cJSON_AddStringToObject(json, "device_ip", "Not available");
+        json_stream_field(&js, "device_ip", "Not available");
     }
-    
-    char *json_string = cJSON_Print(json);
-    
-    httpd_resp_set_type(req, "application/json");
-    httpd_resp_set_hdr(req, "Access-Control-Allow-Origin", "*");
-    httpd_resp_send(req, json_string, strlen(json_string));
-    
-    free(json_string);
-    cJSON_Delete(json);
-    
-    return ESP_OK;
+    json_stream_raw(&js, "}", 1);
+
+    json_stream_flush(&js);
+    if (js.err == ESP_OK) {
+        js.err = httpd_resp_send_chunk(req, NULL, 0);
+    }
+    return js.err;
+}
+
+// Prometheus text exposition, streamed through the /json chunk writer
+
+static const char *const metrics_block_names[PROTOCOL_BLOCK_COUNT] = {
+    [PROTOCOL_BLOCK_INIT] = "init",
+    [PROTOCOL_BLOCK_MAIN] = "main",
+    [PROTOCOL_BLOCK_EXTRA] = "extra",
+    [PROTOCOL_BLOCK_OPT] = "opt",
+};
+
+static const char *const metrics_port_names[MODBUS_SLAVE_COUNT] = {
+    [MODBUS_SLAVE_RTU] = "rtu",
+    [MODBUS_SLAVE_TCP] = "tcp",
+};
+
+// Tasks whose stack high-water mark is exported; missing ones are skipped
+static const char *const metrics_tasks[] = {
+    "protocol", "modbus_task", "modbus_rtu", "modbus_tcp", "mqtt_pub", "httpd", "adc_task", "ds18b20_task",
+};
+
+static void metrics_header(json_stream_t *js, const char *name, const char *type, const char *help) {
+    json_stream_printf(js, "# HELP %s %s\n", name, help);
+    json_stream_printf(js, "# TYPE %s %s\n", name, type);
+}
+
+static void metrics_value(json_stream_t *js, const char *name, const char *type, const char *help, uint64_t value) {
+    metrics_header(js, name, type, help);
+    json_stream_printf(js, "%s %llu\n", name, (unsigned long long)value);
+}
+
+// One histogram series; labels is "" or "key=\"value\","
+static void metrics_hist(json_stream_t *js, const char *name, const char *labels, const metrics_hist_t *hist) {
+    static const uint32_t bounds[METRICS_HIST_BUCKETS] = METRICS_HIST_BOUNDS_US;
+    uint32_t cumulative = 0;
+    for (size_t i = 0; i < METRICS_HIST_BUCKETS; i++) {
+        cumulative += hist->bucket[i];
+        json_stream_printf(js, "%s_bucket{%sle=\"%g\"} %lu\n", name, labels, bounds[i] / 1e6, (unsigned long)cumulative);
+    }
+    cumulative += hist->bucket[METRICS_HIST_BUCKETS];
+    json_stream_printf(js, "%s_bucket{%sle=\"+Inf\"} %lu\n", name, labels, (unsigned long)cumulative);
+    size_t len = strlen(labels);
+    if (len > 0) {
+        // Same labels without the trailing comma
+        json_stream_printf(js, "%s_sum{%.*s} %.6f\n", name, (int)len - 1, labels, hist->sum_us / 1e6);
+        json_stream_printf(js, "%s_count{%.*s} %lu\n", name, (int)len - 1, labels, (unsigned long)cumulative);
+    } else {
+        json_stream_printf(js, "%s_sum %.6f\n", name, hist->sum_us / 1e6);
+        json_stream_printf(js, "%s_count %lu\n", name, (unsigned long)cumulative);
+    }
+}
+
+static void metrics_block_hists(json_stream_t *js, const char *name, const metrics_hist_t *hists) {
+    for (size_t i = 0; i < PROTOCOL_BLOCK_COUNT; i++) {
+        char labels[24];
+        snprintf(labels, sizeof(labels), "block=\"%s\",", metrics_block_names[i]);
+        metrics_hist(js, name, labels, &hists[i]);
+    }
+}
+
+// Statistics copies of the scrape being served (server task only, see json_regs)
+static protocol_stats_t metrics_protocol;
+static mqtt_publish_stats_t metrics_mqtt;
+static modbus_slave_stats_t metrics_modbus;
+
+// Metrics handler - counters and histograms in the Prometheus text format
+static esp_err_t metrics_handler(httpd_req_t *req) {
+    protocol_get_stats(&metrics_protocol);
+    mqtt_client_get_stats(&metrics_mqtt);
+    modbus_slave_get_stats(&metrics_modbus);
+    const protocol_stats_t *ps = &metrics_protocol;
+
+    httpd_resp_set_type(req, "text/plain; version=0.0.4; charset=utf-8");
+    json_stream_t js = { .req = req, .err = ESP_OK, .used = 0 };
+
+    metrics_value(&js, "panasonic_uptime_seconds", "gauge", "Time since boot",
+                  (uint64_t)(esp_timer_get_time() / 1000000));
+    metrics_value(&js, "panasonic_free_heap_bytes", "gauge", "Free heap", esp_get_free_heap_size());
+    metrics_value(&js, "panasonic_min_free_heap_bytes", "gauge", "Lowest free heap since boot",
+                  esp_get_minimum_free_heap_size());
+
+    // Heat pump protocol
+    metrics_value(&js, "panasonic_protocol_polls_total", "counter", "Poll requests sent", ps->poll_count);
+    metrics_value(&js, "panasonic_protocol_writes_total", "counter", "Write frames sent", ps->write_count);
+    metrics_value(&js, "panasonic_protocol_writes_merged_total", "counter",
+                  "Write commands merged into another frame", ps->write_merged);
+    metrics_value(&js, "panasonic_protocol_frames_unchanged_total", "counter",
+                  "Valid frames identical to the previous one of their block", ps->frames_unchanged);
+    metrics_header(&js, "panasonic_protocol_rx_errors_total", "counter", "Responses missing or rejected");
+    json_stream_printf(&js, "panasonic_protocol_rx_errors_total{reason=\"timeout\"} %lu\n", (unsigned long)ps->rx_timeouts);
+    json_stream_printf(&js, "panasonic_protocol_rx_errors_total{reason=\"incomplete\"} %lu\n", (unsigned long)ps->rx_incomplete);
+    json_stream_printf(&js, "panasonic_protocol_rx_errors_total{reason=\"size\"} %lu\n", (unsigned long)ps->rx_bad_size);
+    json_stream_printf(&js, "panasonic_protocol_rx_errors_total{reason=\"header\"} %lu\n", (unsigned long)ps->rx_bad_header);
+    json_stream_printf(&js, "panasonic_protocol_rx_errors_total{reason=\"checksum\"} %lu\n", (unsigned long)ps->rx_bad_checksum);
+    metrics_header(&js, "panasonic_protocol_response_seconds", "histogram", "Request sent to complete response");
+    metrics_block_hists(&js, "panasonic_protocol_response_seconds", ps->response_time);
+    metrics_header(&js, "panasonic_protocol_decode_seconds", "histogram", "Decode and publish of a valid frame");
+    metrics_block_hists(&js, "panasonic_protocol_decode_seconds", ps->decode_time);
+    metrics_value(&js, "panasonic_protocol_write_queue_depth", "gauge", "Write commands waiting",
+                  g_protocol_ctx.command_queue != NULL ? uxQueueMessagesWaiting(g_protocol_ctx.command_queue) : 0);
+    metrics_value(&js, "panasonic_protocol_write_queue_depth_max", "gauge", "Most write commands waiting at once",
+                  ps->write_queue_max);
+    metrics_header(&js, "panasonic_protocol_write_wait_seconds", "histogram", "Write command queued to sent");
+    metrics_hist(&js, "panasonic_protocol_write_wait_seconds", "", &ps->write_wait);
+    metrics_header(&js, "panasonic_protocol_poll_interval_seconds", "gauge", "Current adaptive poll interval");
+    for (size_t i = PROTOCOL_BLOCK_MAIN; i < PROTOCOL_BLOCK_COUNT; i++) {
+        json_stream_printf(&js, "panasonic_protocol_poll_interval_seconds{block=\"%s\"} %.3f\n",
+                           metrics_block_names[i], ps->poll_interval_ms[i] / 1000.0);
+    }
+    metrics_value(&js, "panasonic_protocol_poll_transitions_total", "counter",
+                  "State transitions that switched main polling to the minimum interval", ps->poll_transitions);
+
+    // MQTT publisher
+    metrics_header(&js, "panasonic_mqtt_snapshots_total", "counter", "Register snapshots by outcome");
+    json_stream_printf(&js, "panasonic_mqtt_snapshots_total{result=\"submitted\"} %lu\n", (unsigned long)metrics_mqtt.submitted);
+    json_stream_printf(&js, "panasonic_mqtt_snapshots_total{result=\"coalesced\"} %lu\n", (unsigned long)metrics_mqtt.coalesced);
+    json_stream_printf(&js, "panasonic_mqtt_snapshots_total{result=\"dropped\"} %lu\n", (unsigned long)metrics_mqtt.dropped);
+    json_stream_printf(&js, "panasonic_mqtt_snapshots_total{result=\"published\"} %lu\n", (unsigned long)metrics_mqtt.published);
+    json_stream_printf(&js, "panasonic_mqtt_snapshots_total{result=\"failed\"} %lu\n", (unsigned long)metrics_mqtt.failed);
+    metrics_header(&js, "panasonic_mqtt_publish_seconds", "histogram", "Time to publish one snapshot");
+    metrics_hist(&js, "panasonic_mqtt_publish_seconds", "", &metrics_mqtt.batch_time);
+
+    // Modbus slave
+    metrics_header(&js, "panasonic_modbus_requests_total", "counter", "Master requests by slave and area access");
+    for (size_t i = 0; i < MODBUS_SLAVE_COUNT; i++) {
+        const modbus_slave_port_stats_t *mp = &metrics_modbus.port[i];
+        const char *port = metrics_port_names[i];
+        json_stream_printf(&js, "panasonic_modbus_requests_total{port=\"%s\",event=\"input_read\"} %lu\n",
+                           port, (unsigned long)mp->input_reads);
+        json_stream_printf(&js, "panasonic_modbus_requests_total{port=\"%s\",event=\"holding_read\"} %lu\n",
+                           port, (unsigned long)mp->holding_reads);
+        json_stream_printf(&js, "panasonic_modbus_requests_total{port=\"%s\",event=\"holding_write\"} %lu\n",
+                           port, (unsigned long)mp->holding_writes);
+    }
+    metrics_value(&js, "panasonic_modbus_writes_dispatched_total", "counter",
+                  "Holding register writes applied", metrics_modbus.writes_dispatched);
+
+    // Boot timeline
+    metrics_header(&js, "panasonic_boot_stage_seconds", "gauge", "Time after boot each startup milestone was reached");
+    for (int i = 0; i < HPC_BOOT_STAGE_COUNT; i++) {
+        int64_t us = hpc_boot_time_us((hpc_boot_stage_t)i);
+        if (us >= 0) {
+            json_stream_printf(&js, "panasonic_boot_stage_seconds{stage=\"%s\"} %.3f\n",
+                               hpc_boot_stage_name((hpc_boot_stage_t)i), us / 1e6);
+        }
+    }
+
+    // Tasks
+    metrics_header(&js, "panasonic_task_stack_free_bytes", "gauge", "Lowest free stack since the task started");
+    for (size_t i = 0; i < sizeof(metrics_tasks) / sizeof(metrics_tasks[0]); i++) {
+        TaskHandle_t task = xTaskGetHandle(metrics_tasks[i]);
+        if (task != NULL) {
+            json_stream_printf(&js, "panasonic_task_stack_free_bytes{task=\"%s\"} %lu\n", metrics_tasks[i],
+                               (unsigned long)uxTaskGetStackHighWaterMark(task));
+        }
+    }
+
+    json_stream_flush(&js);
+    if (js.err == ESP_OK) {
+        js.err = httpd_resp_send_chunk(req, NULL, 0);
+    }
+    return js.err;
+}
+
+// Frame capture download - binary, see frame_capture.h for the format
+static esp_err_t capture_handler(httpd_req_t *req) {
+    frame_capture_snapshot_t *snapshot = NULL;
+    frame_capture_file_header_t header;
+    if (frame_capture_snapshot_take(&snapshot, &header) != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Out of memory");
+        return ESP_FAIL;
+    }
+
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"frames.hpfc\"");
+    httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+    // Batch records into chunks instead of one send per frame
+    static const size_t chunk_size = 1024;
+    char *chunk = malloc(chunk_size);
+    if (chunk == NULL) {
+        frame_capture_snapshot_free(snapshot);
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Out of memory");
+        return ESP_FAIL;
+    }
+    memcpy(chunk, &header, sizeof(header));
+    size_t used = sizeof(header);
+
+    esp_err_t ret = ESP_OK;
+    frame_capture_record_t record;
+    const uint8_t *data;
+    while (ret == ESP_OK && frame_capture_snapshot_next(snapshot, &record, &data)) {
+        if (used + sizeof(record) + record.len > chunk_size) {
+            ret = httpd_resp_send_chunk(req, chunk, used);
+            used = 0;
+        }
+        memcpy(chunk + used, &record, sizeof(record));
+        memcpy(chunk + used + sizeof(record), data, record.len);
+        used += sizeof(record) + record.len;
+    }
+    if (ret == ESP_OK && used > 0) {
+        ret = httpd_resp_send_chunk(req, chunk, used);
+    }
+    if (ret == ESP_OK) {
+        ret = httpd_resp_send_chunk(req, NULL, 0);
+    }
+
+    free(chunk);
+    frame_capture_snapshot_free(snapshot);
+    ESP_LOGI(TAG, "Frame capture sent: %u records, %u dropped", (unsigned)header.count, (unsigned)header.dropped);
+    return ret;
+}
+
+// WebSocket push: after each decode cycle the values that changed since the
+// last push go to every /ws client as one or more text frames of the form
+// {"params":[{"reg":N,"value":"..."},...],"status":"online"}; "value" is
+// null when a register became invalid. Deltas carry absolute values, so a
+// client that loads /json after connecting stays consistent.
+static int16_t ws_sent[MB_REG_INPUT_COUNT];     // Values of the last push
+static bool ws_sent_valid = false;              // ws_sent holds a push
+static bool ws_sent_online = false;
+static bool ws_push_pending = false;            // Work item queued, not yet run
+static char ws_frame[CONFIG_HTTP_WS_FRAME_SIZE];
+
+// Room kept for one more entry: {"params":[{"reg":65535,"value":"-327.68"}
+// plus the frame tail ],"status":"offline"}
+#define WS_ENTRY_MAX    72
+
+// Send one text frame to every WebSocket client of the server
+static void ws_broadcast(const char *text, size_t len) {
+    int fds[CONFIG_HTTP_MAX_OPEN_SOCKETS];
+    size_t count = sizeof(fds) / sizeof(fds[0]);
+    if (httpd_get_client_list(server_handle, &count, fds) != ESP_OK) {
+        return;
+    }
+    httpd_ws_frame_t frame = {
+        .final = true,
+        .fragmented = false,
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)text,
+        .len = len,
+    };
+    for (size_t i = 0; i < count; i++) {
+        if (httpd_ws_get_fd_info(server_handle, fds[i]) == HTTPD_WS_CLIENT_WEBSOCKET &&
+            httpd_ws_send_frame_async(server_handle, fds[i], &frame) != ESP_OK) {
+            ESP_LOGD(TAG, "WebSocket push to fd %d failed", fds[i]);
+        }
+    }
+}
+
+static bool ws_has_clients(void) {
+    int fds[CONFIG_HTTP_MAX_OPEN_SOCKETS];
+    size_t count = sizeof(fds) / sizeof(fds[0]);
+    if (httpd_get_client_list(server_handle, &count, fds) != ESP_OK) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (httpd_ws_get_fd_info(server_handle, fds[i]) == HTTPD_WS_CLIENT_WEBSOCKET) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Runs in the server task, so it shares json_regs with the handlers
+static void ws_push_work(void *arg) {
+    (void)arg;
+    __atomic_store_n(&ws_push_pending, false, __ATOMIC_RELAXED);
+    if (server_handle == NULL || !ws_has_clients()) {
+        return;
+    }
+
+    modbus_params_read_inputs(json_regs, MB_REG_INPUT_START, MB_REG_INPUT_COUNT);
+    const int16_t *regs = json_regs;
+    bool online = (regs[MB_INPUT_STATUS] != 0 || regs[MB_INPUT_MAIN_INLET_TEMP] != INT16_MIN);
+
+    size_t used = 0;
+    size_t sent = 0;
+    for (size_t i = 0; http_params[i].reg_addr != 0; i++) {
+        const http_param_t *param = &http_params[i];
+        int16_t value = regs[param->reg_addr];
+        if (ws_sent_valid && ws_sent[param->reg_addr] == value) {
+            continue;
+        }
+        if (used + WS_ENTRY_MAX > sizeof(ws_frame)) {
+            used += snprintf(ws_frame + used, sizeof(ws_frame) - used, "]}");
+            ws_broadcast(ws_frame, used);
+            used = 0;
+        }
+        used += snprintf(ws_frame + used, sizeof(ws_frame) - used,
+                         used == 0 ? "{\"params\":[{\"reg\":%u," : ",{\"reg\":%u,", param->reg_addr);
+        if (value == INT16_MIN) {
+            used += snprintf(ws_frame + used, sizeof(ws_frame) - used, "\"value\":null}");
+        } else {
+            char value_str[16];
+            json_param_value(param, value, value_str, sizeof(value_str));
+            used += snprintf(ws_frame + used, sizeof(ws_frame) - used, "\"value\":\"%s\"}", value_str);
+        }
+        sent++;
+    }
+    if (used > 0 || !ws_sent_valid || online != ws_sent_online) {
+        used += snprintf(ws_frame + used, sizeof(ws_frame) - used, "%s\"status\":\"%s\"}",
+                         used == 0 ? "{" : "],", online ? "online" : "offline");
+        ws_broadcast(ws_frame, used);
+    }
+
+    memcpy(ws_sent, regs, sizeof(ws_sent));
+    ws_sent_valid = true;
+    ws_sent_online = online;
+    ESP_LOGD(TAG, "WebSocket push: %u changed values", (unsigned)sent);
+}
+
+// WebSocket endpoint - the server answers pings and closes itself, data
+// frames from the page are read and ignored
+static esp_err_t ws_handler(httpd_req_t *req) {
+    if (req->method == HTTP_GET) {
+        ESP_LOGI(TAG, "WebSocket client connected, fd %d", httpd_req_to_sockfd(req));
+        return ESP_OK;
+    }
+
+    uint8_t payload[32];
+    httpd_ws_frame_t frame = { .payload = NULL };
+    esp_err_t ret = httpd_ws_recv_frame(req, &frame, 0);
+    if (ret != ESP_OK || frame.len == 0) {
+        return ret;
+    }
+    if (frame.len > sizeof(payload)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    frame.payload = payload;
+    return httpd_ws_recv_frame(req, &frame, frame.len);
+}
+
+/**
+ * @brief Queue a WebSocket push of the registers changed since the last one
+ */
+void http_server_notify_inputs(void) {
+    if (server_handle_mutex == NULL) {
+        return;
+    }
+    xSemaphoreTake(server_handle_mutex, portMAX_DELAY);
+    if (server_handle != NULL && !__atomic_exchange_n(&ws_push_pending, true, __ATOMIC_RELAXED)) {
+        if (httpd_queue_work(server_handle, ws_push_work, NULL) != ESP_OK) {
+            __atomic_store_n(&ws_push_pending, false, __ATOMIC_RELAXED);
+        }
+    }
+    xSemaphoreGive(server_handle_mutex);
 }
 
 // Initialize HTTP server
@@ -555,13 +896,23 @@ esp_err_t http_server_init(void) {
         return ESP_OK;
     }
     
+    if (server_handle_mutex == NULL) {
+        server_handle_mutex = xSemaphoreCreateMutex();
+        if (server_handle_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create server handle mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
     config.max_uri_handlers = 10;
-    config.max_open_sockets = 7;
+    config.max_open_sockets = CONFIG_HTTP_MAX_OPEN_SOCKETS;
     
     ESP_LOGI(TAG, "Starting HTTP server on port: '%d'", config.server_port);
+    index_etag_init();
     
-    if (httpd_start(&server_handle, &config) == ESP_OK) {
+    httpd_handle_t server = NULL;
+    if (httpd_start(&server, &config) == ESP_OK) {
         // Register URI handlers
         httpd_uri_t root_uri = {
             .uri       = "/",
@@ -569,7 +920,7 @@ esp_err_t http_server_init(void) {
             .handler   = root_handler,
             .user_ctx  = NULL
         };
-        httpd_register_uri_handler(server_handle, &root_uri);
+        httpd_register_uri_handler(server, &root_uri);
         
         httpd_uri_t json_uri = {
             .uri       = "/json",
@@ -577,7 +928,37 @@ esp_err_t http_server_init(void) {
             .handler   = json_handler,
             .user_ctx  = NULL
         };
-        httpd_register_uri_handler(server_handle, &json_uri);
+        httpd_register_uri_handler(server, &json_uri);
+        
+        httpd_uri_t capture_uri = {
+            .uri       = "/capture",
+            .method    = HTTP_GET,
+            .handler   = capture_handler,
+            .user_ctx  = NULL
+        };
+        httpd_register_uri_handler(server, &capture_uri);
+        
+        httpd_uri_t metrics_uri = {
+            .uri       = "/metrics",
+            .method    = HTTP_GET,
+            .handler   = metrics_handler,
+            .user_ctx  = NULL
+        };
+        httpd_register_uri_handler(server, &metrics_uri);
+        
+        httpd_uri_t ws_uri = {
+            .uri          = "/ws",
+            .method       = HTTP_GET,
+            .handler      = ws_handler,
+            .user_ctx     = NULL,
+            .is_websocket = true
+        };
+        httpd_register_uri_handler(server, &ws_uri);
+        
+        // Publish the handle only once the server is complete
+        xSemaphoreTake(server_handle_mutex, portMAX_DELAY);
+        server_handle = server;
+        xSemaphoreGive(server_handle_mutex);
         
         ESP_LOGI(TAG, "HTTP server started successfully");
         return ESP_OK;
@@ -598,8 +979,15 @@ esp_err_t http_server_stop(void) {
         return ESP_OK;
     }
     
-    httpd_stop(server_handle);
+    // Unpublish the handle first; once the mutex is released no push can
+    // be on its way into the server being stopped
+    xSemaphoreTake(server_handle_mutex, portMAX_DELAY);
+    httpd_handle_t server = server_handle;
     server_handle = NULL;
+    xSemaphoreGive(server_handle_mutex);
+    httpd_stop(server);
+    __atomic_store_n(&ws_push_pending, false, __ATOMIC_RELAXED);
+    ws_sent_valid = false;
     ESP_LOGI(TAG, "HTTP server stopped");
     return ESP_OK;
 }
@@ -10,6 +10,8 @@
 #ifndef DECODER_NEW_H
 #define DECODER_NEW_H
 
+#include <stddef.h>
+#include <stdint.h>
 #include "esp_err.h"
 
 #ifdef __cplusplus
@@ -22,6 +24,15 @@ extern "C" {
  */
 esp_err_t decode_main_data(void);
 
+/**
+ * @brief Decode only the main data fields whose bytes changed
+ * Registers are written only when their value differs
+ * @param changed Changed-byte bitmap of the frame (see PROTOCOL_FRAME_BYTE_CHANGED), NULL to decode all fields
+ * @param updated Optional output: number of registers whose value changed
+ * @return ESP_OK on success
+ */
+esp_err_t decode_main_data_changed(const uint32_t *changed, size_t *updated);
+
 /**
  * @brief Decode extra heat pump data
  * @return ESP_OK on success
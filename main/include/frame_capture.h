@@ -0,0 +1,88 @@
+/**
+ * @file frame_capture.h
+ * @brief Raw heat pump frame capture in a RAM ring buffer
+ *
+ * The protocol task records every transmitted command and received frame.
+ * Readers take a snapshot without blocking the writer and serialise it in
+ * the binary format below, e.g. for the /capture HTTP download.
+ */
+
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Capture file: one file header followed by `count` records, little endian
+#define FRAME_CAPTURE_MAGIC     0x43465048  // "HPFC"
+#define FRAME_CAPTURE_VERSION   1
+
+// Record flags
+#define FRAME_CAPTURE_FLAG_INCOMPLETE 0x01  // RX frame cut short by timeout or overflow
+
+typedef enum {
+    FRAME_CAPTURE_TX = 0,   // Gateway -> heat pump, including checksum
+    FRAME_CAPTURE_RX = 1    // Heat pump -> gateway, as assembled
+} frame_capture_dir_t;
+
+typedef struct __attribute__((packed)) {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_header_size;    // sizeof(frame_capture_record_t)
+    uint32_t count;                 // Records in this file
+    uint32_t dropped;               // Older records already overwritten
+} frame_capture_file_header_t;
+
+typedef struct __attribute__((packed)) {
+    int64_t time_us;                // esp_timer time
+    uint8_t direction;              // frame_capture_dir_t
+    uint8_t flags;
+    uint16_t len;                   // Frame bytes following this header
+} frame_capture_record_t;
+
+typedef struct frame_capture_snapshot frame_capture_snapshot_t;
+
+/**
+ * @brief Record one frame, overwriting the oldest records when full
+ * Single writer (the protocol task); never blocks and never allocates
+ * @param direction TX or RX
+ * @param flags FRAME_CAPTURE_FLAG_*
+ * @param data Frame bytes
+ * @param size Frame size
+ */
+void frame_capture_add(frame_capture_dir_t direction, uint8_t flags, const uint8_t *data, size_t size);
+
+/**
+ * @brief Copy the ring for reading while the writer keeps running
+ * @param snapshot Output snapshot, release with frame_capture_snapshot_free()
+ * @param header Output file header for the records of the snapshot
+ * @return ESP_OK on success, ESP_ERR_NO_MEM if the copy can't be allocated
+ */
+esp_err_t frame_capture_snapshot_take(frame_capture_snapshot_t **snapshot, frame_capture_file_header_t *header);
+
+/**
+ * @brief Get the next record of a snapshot, oldest first
+ * @param snapshot Snapshot
+ * @param record Output record header
+ * @param data Output frame bytes, valid until the next call
+ * @return false when all records have been returned
+ */
+bool frame_capture_snapshot_next(frame_capture_snapshot_t *snapshot, frame_capture_record_t *record,
+                                 const uint8_t **data);
+
+/**
+ * @brief Release a snapshot
+ */
+void frame_capture_snapshot_free(frame_capture_snapshot_t *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FRAME_CAPTURE_H
@@ -9,6 +9,7 @@
 #define HPC_H
 
 #include "esp_err.h"
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,6 +18,20 @@ extern "C" {
 // Application version
 #define HPC_VERSION_STRING "0.1.1"
 
+// Boot milestones, in the order they are normally reached
+typedef enum {
+    HPC_BOOT_APP_MAIN = 0,          // app_main() entered
+    HPC_BOOT_PROTOCOL_STARTED,      // Heat pump polling task running
+    HPC_BOOT_MODBUS_STARTED,        // Modbus RTU slave serving
+    HPC_BOOT_WIFI_STARTED,          // Station started, association in progress
+    HPC_BOOT_FIRST_FRAME,           // First valid main block decoded
+    HPC_BOOT_GOT_IP,
+    HPC_BOOT_HTTP_STARTED,
+    HPC_BOOT_MODBUS_TCP_STARTED,
+    HPC_BOOT_MQTT_STARTED,
+    HPC_BOOT_STAGE_COUNT
+} hpc_boot_stage_t;
+
 /**
  * @brief Initialize HPC application
  * @return ESP_OK on success
@@ -39,6 +54,24 @@ void hpc_factory_reset_button_init(void);
  */
 void hpc_factory_reset_button_poll(void);
 
+/**
+ * @brief Record a boot milestone; only the first call per stage counts
+ * @param stage Milestone reached
+ */
+void hpc_boot_mark(hpc_boot_stage_t stage);
+
+/**
+ * @brief Get the time a boot milestone was reached
+ * @param stage Milestone
+ * @return esp_timer time in microseconds, -1 if not reached yet
+ */
+int64_t hpc_boot_time_us(hpc_boot_stage_t stage);
+
+/**
+ * @brief Get the short name of a boot milestone, e.g. "got_ip"
+ */
+const char *hpc_boot_stage_name(hpc_boot_stage_t stage);
+
 /*
  * @brief Restart application
  */
@@ -32,6 +32,14 @@ esp_err_t http_server_start(void);
  */
 esp_err_t http_server_stop(void);
 
+/**
+ * @brief Queue a WebSocket push of the registers changed since the last one
+ * Called by the protocol task after modbus_params_commit_inputs(). Returns
+ * at once; the diff and the sends run in the server task, and calls made
+ * while a push is still queued are merged into it.
+ */
+void http_server_notify_inputs(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,58 @@
+/**
+ * @file metrics.h
+ * @brief Fixed-bucket latency histograms for the /metrics endpoint
+ *
+ * Each histogram has exactly one writer (the task that owns the measured
+ * path), so recording a sample is a few plain increments with no lock.
+ * Readers copy the struct; a copy taken while a sample is being recorded
+ * may be one sample behind in some fields, which the next scrape corrects.
+ * sum_us is 64-bit and not copied atomically on the 32-bit targets: a copy
+ * that races the carry into the high word can be off by 2^32 us (~72 min)
+ * for that one scrape.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Upper bucket bounds in microseconds, plus an implicit +Inf bucket.
+// Covers decode times (~100 us) up to UART replies and MQTT batches (seconds).
+#define METRICS_HIST_BOUNDS_US  { 100, 500, 1000, 5000, 10000, 50000, 100000, 250000, 500000, 1000000, 2500000, 5000000 }
+#define METRICS_HIST_BUCKETS    12
+
+typedef struct {
+    uint32_t bucket[METRICS_HIST_BUCKETS + 1];  // Per bucket, not cumulative; last is +Inf
+    uint32_t count;
+    uint64_t sum_us;
+} metrics_hist_t;
+
+/**
+ * @brief Record one sample
+ * @param hist Histogram, written by one task only
+ * @param us Sample in microseconds, negative values count as 0
+ */
+static inline void metrics_hist_observe(metrics_hist_t *hist, int64_t us) {
+    static const uint32_t bounds[METRICS_HIST_BUCKETS] = METRICS_HIST_BOUNDS_US;
+    if (us < 0) {
+        us = 0;
+    }
+    size_t i = 0;
+    while (i < METRICS_HIST_BUCKETS && (uint64_t)us > bounds[i]) {
+        i++;
+    }
+    hist->bucket[i]++;
+    hist->count++;
+    hist->sum_us += (uint64_t)us;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // METRICS_H
@@ -9,6 +9,7 @@
 #define MODBUS_PARAMS_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 #include "esp_err.h"
 
@@ -274,60 +275,16 @@ extern "C" {
 #define MB_INPUT_SOLAR_WATER_PUMP      0x0165
 #define MB_INPUT_ALARM_STATE           0x0166
 
-// Registers copy fo fast reading
-// Basic temperatures
-#define MB_INPUT_MAIN_INLET_TEMP_CPY            0x0170
-#define MB_INPUT_MAIN_OUTLET_TEMP_CPY           0x0171
-#define MB_INPUT_MAIN_TARGET_TEMP_CPY           0x0172
-#define MB_INPUT_DHW_TARGET_TEMP_CPY            0x0173
-#define MB_INPUT_OUTSIDE_TEMP_CPY               0x0174
-// Additional temperatures
-#define MB_INPUT_INSIDE_PIPE_TEMP_CPY           0x0175
-#define MB_INPUT_OUTSIDE_PIPE_TEMP_CPY          0x0176
-// Power and energy
-#define MB_INPUT_HEAT_POWER_CONSUMPTION_CPY     0x0177
-#define MB_INPUT_COOL_POWER_CONSUMPTION_CPY     0x0178
-#define MB_INPUT_DHW_POWER_CONSUMPTION_CPY      0x0179
-// ==================================================================
-// Technical parameters
-// ==================================================================
-#define MB_INPUT_COMPRESSOR_FREQ_CPY            0x017A
-#define MB_INPUT_PUMP_FLOW_CPY                  0x017B
-#define MB_INPUT_OPERATIONS_HOURS_CPY           0x017C
-#define MB_INPUT_OPERATIONS_COUNTER_CPY         0x017D
-#define MB_INPUT_PUMP_SPEED_CPY                 0x017E
-#define MB_INPUT_COMPRESSOR_CURRENT_CPY         0x017F
-#define MB_INPUT_PUMP_DUTY_CPY                  0x0180
-// ============================================================================
-// Operation states
-// ============================================================================
-#define MB_INPUT_HEATPUMP_STATE_CPY             0x0181
-#define MB_INPUT_FORCE_DHW_STATE_CPY            0x0182
-#define MB_INPUT_OPERATING_MODE_STATE_CPY       0x0183
-#define MB_INPUT_THREE_WAY_VALVE_STATE_CPY      0x0184
-#define MB_INPUT_DEFROSTING_STATE_CPY           0x0185
-// ==================================================================
-// Heating/Cooling mode settings
-// ==================================================================
-#define MB_INPUT_HEATING_MODE_CPY               0x0186
-#define MB_INPUT_COOLING_MODE_CPY               0x0187
-// ==================================================================
-// External controls
-// ==================================================================
-#define MB_INPUT_WATER_PRESSURE_CPY             0x0188
-#define MB_INPUT_EXTERNAL_CONTROL_CPY           0x0189
-#define MB_INPUT_EXTERNAL_ERROR_SIGNAL_CPY      0x018A
-// ==================================================================
-// Pump and valve states
-// ==================================================================
-#define MB_INPUT_TWO_WAY_VALVE_STATE_CPY        0x018B
-#define MB_INPUT_THREE_WAY_VALVE_STATE2_CPY     0x018C
-// ==================================================================
-// Error info
-// ==================================================================
-// Error state
-#define MB_INPUT_ERROR_TYPE_CPY         0x018D
-#define MB_INPUT_ERROR_NUMBER_CPY       0x018E
+// ============================================================================
+// Remap window (0x0170-0x018F)
+// ============================================================================
+// Slot i mirrors the input register whose address is stored in holding
+// register MB_HOLDING_REMAP_SRC_START + i, so a master can fetch a scattered
+// set of registers with one read. The default map is the former fixed copy
+// block (inlet, outlet, target, DHW target, outside temperature, ...).
+#define MB_INPUT_REMAP_START            0x0170
+#define MB_INPUT_REMAP_COUNT            32
+#define MB_REMAP_UNUSED                 0xFFFF  // Source of an empty slot, reads 0
 
 // ADC analog inputs (0x0190-0x0192)
 #define MB_INPUT_ADC_AIN                0x0190  // GPIO32
@@ -344,8 +301,15 @@ extern "C" {
 #define MB_INPUT_DS18B20_TEMP7          0x0199  // sensor #7
 #define MB_INPUT_DS18B20_TEMP8          0x019A  // sensor #8
 
+// Warm-start cache (0x019B-0x019C)
+// After a reboot the registers hold the last snapshot saved before it (RTC
+// memory, or the NVS checkpoint after a power loss) until the first main
+// frame is decoded.
+#define MB_INPUT_CACHE_STALE            0x019B  // 1 while the registers hold the restored snapshot
+#define MB_INPUT_CACHE_AGE              0x019C  // Age of the restored snapshot in s, 32767 max, -1 unknown
+
 // Total input registers
-#define MB_REG_INPUT_COUNT             0x019B  // 411 registers (0x0000-0x019A)
+#define MB_REG_INPUT_COUNT             0x019D  // 413 registers (0x0000-0x019C)
 
 // ============================================================================
 // HOLDING REGISTERS (Read/Write) - 0x1000-0x103F
@@ -434,10 +398,24 @@ extern "C" {
 
 #define MB_HOLDING_OPT_PCB_AVAILABLE        0x1090  // == 1 - Есть опциональная плата, включить обработку
 #define MB_HOLDING_SET_MQTT_PUBLISH         0x1091  // 1= включить публикацию в MQTT
+#define MB_HOLDING_MQTT_PAYLOAD_MODE        0x1092  // 0 = топик на каждый параметр, 1 = один JSON документ
+
+// Remap window configuration (write sources, then trigger apply)
+#define MB_HOLDING_REMAP_APPLY              0x1093  // 1 = применить и сохранить в NVS, 2 = карта по умолчанию
+#define MB_HOLDING_REMAP_SRC_START          0x10A0  // MB_INPUT_REMAP_COUNT адресов входных регистров
+#define MB_HOLDING_REMAP_SRC_REGS           MB_INPUT_REMAP_COUNT
 
-// Update total count to cover up to last defined register (0x1090)
-// Using 0xA0 (160) for safety margin
-#define MB_REG_HOLDING_COUNT            0x00A0  // covers 0x1000-0x109F (160 registers)
+#define MB_REMAP_APPLY_SAVE                 1
+#define MB_REMAP_APPLY_DEFAULTS             2
+
+// Adaptive heat pump polling limits, stored in NVS. A maximum below the
+// minimum is treated as equal to it.
+#define MB_HOLDING_POLL_MIN_SEC             0x1094  // 1-3600, shortest interval between polls of a block
+#define MB_HOLDING_POLL_MAX_SEC             0x1095  // 1-3600, longest interval between polls of a block
+#define MB_POLL_LIMIT_MAX_SEC               3600
+
+// Update total count to cover up to last defined register (0x10BF)
+#define MB_REG_HOLDING_COUNT            0x00C0  // covers 0x1000-0x10BF (192 registers)
 
 // ============================================================================
 // Register data structures
@@ -446,6 +424,11 @@ extern "C" {
 extern int16_t mb_input_registers[MB_REG_INPUT_COUNT];
 extern int16_t mb_holding_registers[MB_REG_HOLDING_COUNT];
 
+// Back buffer of the input registers. The decoder fills it and
+// modbus_params_commit_inputs() publishes it to mb_input_registers in one
+// step, so readers never see a mix of two frames.
+extern int16_t mb_input_registers_back[MB_REG_INPUT_COUNT];
+
 // ============================================================================
 // Function prototypes
 // ============================================================================
@@ -468,12 +451,85 @@ esp_err_t modbus_params_process_holding_write(uint16_t reg_addr);
  */
 void modbus_params_sync_serial_registers(void);
 
+/**
+ * @brief Publish the back buffer to mb_input_registers
+ * Copies mb_input_registers_back under the Modbus slave lock and bumps the
+ * sequence counter used by modbus_params_read_inputs(). Protocol task only.
+ */
+void modbus_params_commit_inputs(void);
+
+/**
+ * @brief Clear the stale flag of a restored snapshot
+ * Call before committing the first decoded main frame. Protocol task only.
+ * @return true if the flag was set, so the back buffer changed
+ */
+bool modbus_params_mark_inputs_fresh(void);
+
+/**
+ * @brief Save the published input registers to the RTC memory snapshot
+ * Call after committing a decoded main frame. Protocol task only.
+ */
+void modbus_params_save_warm_cache(void);
+
+/**
+ * @brief Age the restored snapshot and write the periodic NVS checkpoint
+ * Call periodically from the main task; does nothing between its deadlines.
+ */
+void modbus_params_warm_cache_poll(void);
+
+/**
+ * @brief Set a single input register outside of the decoder (sensors)
+ * Updates both the live and the back buffer so a later commit keeps the value
+ * @param reg_addr Input register address
+ * @param value Register value
+ */
+void modbus_params_set_input(uint16_t reg_addr, int16_t value);
+
+/**
+ * @brief Copy a coherent range of input registers
+ * Lock-free unless a commit overlaps the copy, which is then redone under
+ * the Modbus slave lock. Must not be called with that lock held.
+ * @param dst Destination buffer, at least count registers
+ * @param first First input register address
+ * @param count Number of registers
+ * @return ESP_OK on success
+ */
+esp_err_t modbus_params_read_inputs(int16_t *dst, uint16_t first, uint16_t count);
+
 /**
  * @brief Sync holding registers with current decoded heat pump data
  * This allows reading current values (temperatures, deltas, etc.) from holding registers
  */
 void modbus_params_sync_holding_from_input(void);
 
+/**
+ * @brief Install a remap window map
+ * Refreshes the window and the MB_HOLDING_REMAP_SRC_* registers at once.
+ * @param sources Input register address per slot, MB_REMAP_UNUSED for none
+ * @param count Number of slots given, the rest become unused
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG if a source is out of range
+ *         or inside the window itself (the map is left unchanged)
+ */
+esp_err_t modbus_params_set_remap(const uint16_t *sources, size_t count);
+
+/**
+ * @brief Copy the active remap window map
+ * @param sources Output, MB_INPUT_REMAP_COUNT entries
+ */
+void modbus_params_get_remap(uint16_t *sources);
+
+/**
+ * @brief Default remap window map (the former fixed copy block)
+ * @param sources Output, MB_INPUT_REMAP_COUNT entries
+ */
+void modbus_params_get_default_remap(uint16_t *sources);
+
+/**
+ * @brief Load the poll interval limits from NVS into MB_HOLDING_POLL_MIN_SEC/MAX_SEC
+ * Falls back to CONFIG_PROTOCOL_POLL_MIN_SEC/MAX_SEC when nothing valid is stored.
+ */
+void modbus_params_load_poll_limits(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,6 +1,6 @@
 /**
  * @file modbus_slave.h
- * @brief Modbus RTU slave interface for heat pump monitoring and control
+ * @brief Modbus RTU/TCP slave interface for heat pump monitoring and control
  * @version 1.0.0
  * @date 2025
  */
@@ -29,6 +29,25 @@ typedef struct {
     uint8_t slave_addr;
 } modbus_serial_config_t;
 
+// Slave instances
+typedef enum {
+    MODBUS_SLAVE_RTU = 0,
+    MODBUS_SLAVE_TCP,
+    MODBUS_SLAVE_COUNT
+} modbus_slave_port_t;
+
+// Master requests seen by one slave instance, one per accessed area
+typedef struct {
+    uint32_t input_reads;
+    uint32_t holding_reads;
+    uint32_t holding_writes;
+} modbus_slave_port_stats_t;
+
+typedef struct {
+    modbus_slave_port_stats_t port[MODBUS_SLAVE_COUNT];
+    uint32_t writes_dispatched;     // Holding registers handed to modbus_params
+} modbus_slave_stats_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -47,6 +66,14 @@ esp_err_t modbus_slave_init(void);
  */
 esp_err_t modbus_slave_start(void);
 
+/**
+ * @brief Start the Modbus TCP slave on the WiFi station interface
+ * Serves the same register areas as the RTU slave and feeds the same write
+ * dispatch. Call after modbus_slave_start() once the station has an IP.
+ * @return ESP_OK on success, ESP_ERR_NOT_SUPPORTED if disabled in project_config.h
+ */
+esp_err_t modbus_slave_start_tcp(void);
+
 /**
  * @brief Get current Modbus serial configuration
  * @param cfg_out Output pointer
@@ -55,11 +82,22 @@ esp_err_t modbus_slave_start(void);
 esp_err_t modbus_slave_get_serial_config(modbus_serial_config_t *cfg_out);
 
 /**
- * @brief Update shadow copy of holding registers
- * Should be called after syncing holding registers from input registers
- * to prevent false change detection
+ * @brief Get request statistics
+ * @param stats Output statistics
+ */
+void modbus_slave_get_stats(modbus_slave_stats_t *stats);
+
+/**
+ * @brief Lock the Modbus register areas against concurrent slave access
+ * Locks every running controller (RTU, then TCP); no-op before the RTU
+ * controller is created
+ */
+void modbus_slave_lock(void);
+
+/**
+ * @brief Unlock the Modbus register areas
  */
-void modbus_slave_update_shadow_copy(void);
+void modbus_slave_unlock(void);
 
 #ifdef __cplusplus
 }
@@ -10,6 +10,7 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include "metrics.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,11 +42,40 @@ bool mqtt_client_is_connected(void);
 
 /**
  * @brief Publish heat pump data to MQTT
- * This function reads data from Modbus registers and publishes them
- * @return ESP_OK on success
+ * Takes a snapshot of the Modbus registers and hands it to the publisher
+ * task, which sends it either as separate topics or as one JSON state
+ * document depending on MB_HOLDING_MQTT_PAYLOAD_MODE. Never blocks on the
+ * network; an unpublished older snapshot is replaced by the new one.
+ * @return ESP_OK on success, ESP_ERR_INVALID_STATE if not connected
  */
 esp_err_t mqtt_client_publish_data(void);
 
+/**
+ * @brief Publisher statistics
+ */
+typedef struct {
+    uint32_t submitted;     ///< Snapshots queued by mqtt_client_publish_data()
+    uint32_t coalesced;     ///< Snapshots replaced by a newer one before publishing
+    uint32_t dropped;       ///< Snapshots discarded while disconnected, queued or not
+    uint32_t published;     ///< Snapshots published completely
+    uint32_t failed;        ///< Snapshots with at least one failed publish
+    metrics_hist_t batch_time;  ///< Time to publish one snapshot, failed ones included
+} mqtt_publish_stats_t;
+
+/**
+ * @brief Get publisher statistics
+ * @param stats Output statistics
+ */
+void mqtt_client_get_stats(mqtt_publish_stats_t *stats);
+
+/**
+ * @brief Change the MQTT topic base (e.g. "hp")
+ * Rebuilds the precomputed topic table and forces a full resync
+ * @param base New topic base, shorter than CONFIG_MQTT_TOPIC_BASE_MAX_LEN
+ * @return ESP_OK on success
+ */
+esp_err_t mqtt_client_set_topic_base(const char *base);
+
 /**
  * @brief Update MQTT client state based on WiFi connection
  * Stops MQTT when WiFi disconnects, starts when WiFi connects
@@ -69,6 +99,14 @@ typedef enum {
     MQTT_SUB_ERROR
 } mqtt_subtopic_t;
 
+/**
+ * @brief MQTT payload mode (MB_HOLDING_MQTT_PAYLOAD_MODE)
+ */
+typedef enum {
+    MQTT_PAYLOAD_TOPICS = 0,    ///< One topic per value: <base>/<subtopic>/<name>
+    MQTT_PAYLOAD_JSON = 1       ///< One JSON document per cycle: <base>/state
+} mqtt_payload_mode_t;
+
 typedef struct {
     uint16_t reg_addr;
     const char *name;
@@ -1,6 +1,7 @@
 #ifndef NVS_HP_H
 #define NVS_HP_H
 
+#include <stddef.h>
 #include "esp_err.h"
 #include "modbus_slave.h"
 
@@ -18,6 +19,18 @@ esp_err_t modbus_nvs_save_opt_pcb(uint8_t value);
 esp_err_t modbus_nvs_load_mqtt_publish(uint8_t *value);
 esp_err_t modbus_nvs_save_mqtt_publish(uint8_t value);
 
+esp_err_t modbus_nvs_load_mqtt_payload_mode(uint8_t *value);
+esp_err_t modbus_nvs_save_mqtt_payload_mode(uint8_t value);
+
+esp_err_t modbus_nvs_load_remap(uint16_t *sources, size_t count);
+esp_err_t modbus_nvs_save_remap(const uint16_t *sources, size_t count);
+
+esp_err_t modbus_nvs_load_warm_cache(void *cache, size_t size);
+esp_err_t modbus_nvs_save_warm_cache(const void *cache, size_t size);
+
+esp_err_t modbus_nvs_load_poll_limits(uint16_t *min_sec, uint16_t *max_sec);
+esp_err_t modbus_nvs_save_poll_limits(uint16_t min_sec, uint16_t max_sec);
+
 #ifdef __cplusplus
 }
 #endif
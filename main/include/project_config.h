@@ -30,7 +30,13 @@ extern "C" {
  * Can be changed via NVS or Modbus register
  */
 #define CONFIG_WIFI_PASSWORD_DEFAULT "boss29586"
-#define CONFIG_WIFI_RECONNECT 30000
+
+/**
+ * @brief Reconnect backoff after a disconnect, in milliseconds
+ * The delay starts at MIN and doubles with each failed attempt up to MAX
+ */
+#define CONFIG_WIFI_RETRY_MIN_MS 1000
+#define CONFIG_WIFI_RETRY_MAX_MS 60000
 
 // ============================================================================
 // MQTT Configuration
@@ -54,6 +60,11 @@ extern "C" {
  */
 #define CONFIG_MQTT_TOPIC_BASE_DEFAULT "hp"
 
+/**
+ * @brief Maximum length for MQTT topic base (including terminator)
+ */
+#define CONFIG_MQTT_TOPIC_BASE_MAX_LEN 32
+
 /**
  * @brief Maximum length for MQTT client ID
  */
@@ -79,6 +90,122 @@ extern "C" {
  */
 #define CONFIG_MQTT_RETAIN 0
 
+/**
+ * @brief Temperature deadband in hundredths of a degree
+ * A temperature topic is republished only when it moved at least this much
+ * since the last published value. Whole-degree registers publish on any change.
+ */
+#define CONFIG_MQTT_DEADBAND_TEMP_CENTI 25
+
+/**
+ * @brief Power deadband in watts
+ */
+#define CONFIG_MQTT_DEADBAND_POWER_W 200
+
+/**
+ * @brief Interval of the full republish of all topics in seconds
+ * A full resync is also done after every (re)connect to the broker.
+ */
+#define CONFIG_MQTT_FULL_RESYNC_INTERVAL_SEC 600
+
+/**
+ * @brief Topic suffix of the JSON state document
+ * Used when MB_HOLDING_MQTT_PAYLOAD_MODE = 1: "hp" -> "hp/state"
+ */
+#define CONFIG_MQTT_STATE_TOPIC "state"
+
+/**
+ * @brief MQTT publisher task stack size and priority
+ * Kept below the protocol task so UART polling is never delayed by the network
+ */
+#define CONFIG_MQTT_PUBLISH_TASK_STACK 4096
+#define CONFIG_MQTT_PUBLISH_TASK_PRIORITY 4
+
+// ============================================================================
+// Modbus TCP
+// ============================================================================
+
+/**
+ * @brief Run a Modbus TCP slave next to the RTU slave (0 or 1)
+ * Same registers and unit id; up to CONFIG_FMB_TCP_PORT_MAX_CONN masters
+ */
+#define CONFIG_MODBUS_TCP_ENABLED 1
+
+/**
+ * @brief Modbus TCP listening port
+ */
+#define CONFIG_MODBUS_TCP_PORT 502
+
+// ============================================================================
+// HTTP server
+// ============================================================================
+
+/**
+ * @brief Browser cache lifetime of the dashboard page in seconds
+ * After it expires the browser revalidates with If-None-Match and gets a
+ * 304 unless the firmware (and with it the page ETag) changed
+ */
+#define CONFIG_HTTP_DASHBOARD_MAX_AGE_SEC 3600
+
+/**
+ * @brief Size of the /json chunk buffer in bytes
+ * Lives on the server task stack; the whole response is streamed through it
+ */
+#define CONFIG_HTTP_JSON_CHUNK_SIZE 512
+
+/**
+ * @brief Maximum open HTTP sockets, WebSocket clients included
+ * CONFIG_LWIP_MAX_SOCKETS (sdkconfig, 20) covers this plus 3 httpd internal
+ * sockets, the Modbus TCP listener with CONFIG_FMB_TCP_PORT_MAX_CONN (5)
+ * masters and the MQTT connection: 7 + 3 + 1 + 5 + 1 = 17, 3 spare.
+ */
+#define CONFIG_HTTP_MAX_OPEN_SOCKETS 7
+
+/**
+ * @brief Size of one WebSocket delta frame in bytes
+ * A push that doesn't fit is split into several frames
+ */
+#define CONFIG_HTTP_WS_FRAME_SIZE 1024
+
+// ============================================================================
+// Frame capture
+// ============================================================================
+
+/**
+ * @brief Size of the raw frame capture ring in bytes (power of two)
+ * A poll costs about 330 bytes (111-byte query + 203-byte main frame + headers)
+ */
+#define CONFIG_FRAME_CAPTURE_BUF_SIZE 16384
+
+/**
+ * @brief Maximum number of records kept in the capture ring (power of two)
+ */
+#define CONFIG_FRAME_CAPTURE_MAX_RECORDS 256
+
+// ============================================================================
+// Heat pump polling
+// ============================================================================
+
+/**
+ * @brief Default limits of the adaptive poll interval in seconds
+ * Overridden by holding registers 0x1094/0x1095 (stored in NVS). Defrost,
+ * compressor start/stop and DHW valve switching poll at the minimum, a
+ * quiet heat pump in standby backs off to the maximum.
+ */
+#define CONFIG_PROTOCOL_POLL_MIN_SEC 2
+#define CONFIG_PROTOCOL_POLL_MAX_SEC 60
+
+// ============================================================================
+// Warm-start register cache
+// ============================================================================
+
+/**
+ * @brief Interval between NVS checkpoints of the input registers in seconds
+ * The RTC memory copy survives resets; the NVS copy only serves cold starts,
+ * so it is written rarely to spare the flash (about 830 bytes per write)
+ */
+#define CONFIG_WARM_CACHE_NVS_INTERVAL_SEC 900
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/task.h"
+#include "metrics.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -34,10 +35,25 @@ extern "C" {
 
 // Timing constants
 #define PROTOCOL_READ_TIMEOUT_MS 2000
-#define PROTOCOL_QUERY_INTERVAL_MS 10000
+#ifndef PROTOCOL_QUERY_INTERVAL_MS
+#define PROTOCOL_QUERY_INTERVAL_MS 10000 // Overridable for host load tests
+#endif
+// Adaptive poll scheduler: intervals stay within MB_HOLDING_POLL_MIN_SEC/MAX_SEC.
+// PROTOCOL_QUERY_INTERVAL_MS is the cadence while the compressor runs.
+#ifdef PROTOCOL_POLL_ALLOW_ZERO
+#define PROTOCOL_POLL_LIMIT_MIN_SEC 0   // Host load tests: 0/0 limits poll back to back
+#else
+#define PROTOCOL_POLL_LIMIT_MIN_SEC 1
+#endif
+#define PROTOCOL_POLL_FAST_POLLS 5      // Main polls at the minimum interval after a state transition
+#define PROTOCOL_POLL_QUIET_REGS 2      // Main frames changing at most this many registers are quiet
+#define PROTOCOL_POLL_BUSY_REGS 8       // Main frames changing more than this many registers are busy
+#define PROTOCOL_WRITE_GATHER_MS 20     // Wait for more writes to merge (one Modbus request = several commands)
 
 // Queue size
 #define PROTOCOL_QUEUE_SIZE 10
+#define PROTOCOL_POLL_QUEUE_SIZE 4
+#define PROTOCOL_UART_EVENT_QUEUE_SIZE 20
 
 // Command data sizes
 #define PROTOCOL_MAX_DATA_SIZE      256
@@ -48,6 +64,15 @@ extern "C" {
 #define PROTOCOL_OPT_WRITE_SIZE     19
 #define PROTOCOL_HANDSHAKE_DATA_SIZE 51
 
+// Frame layout: [header][payload length][payload...][checksum]
+#define PROTOCOL_FRAME_OVERHEAD     3
+#define PROTOCOL_WRITE_DATA_START   4   // First payload byte after the 4-byte write header
+#define PROTOCOL_UART_RX_BUF_SIZE   (PROTOCOL_MAX_DATA_SIZE * 2)
+
+// Changed-byte bitmap of a frame: bit n is set when data[n] differs from the previous frame
+#define PROTOCOL_FRAME_BITMAP_WORDS ((PROTOCOL_MAX_DATA_SIZE + 31) / 32)
+#define PROTOCOL_FRAME_BYTE_CHANGED(bitmap, offset) (((bitmap)[(offset) >> 5] >> ((offset) & 31)) & 1u)
+
 
 // RX buffer with length metadata
 typedef struct {
@@ -76,11 +101,46 @@ typedef enum {
 typedef struct {
     uint8_t data[PROTOCOL_WRITE_SIZE];
     size_t len;    
+    int64_t queued_at_us;   // esp_timer time of the request, set by protocol_send_command() if 0
+    uint8_t opt_mask[PROTOCOL_OPT_WRITE_SIZE];  // Optional PCB writes: bits the command sets
 } protocol_cmd_t;
 
+// Block a request asks for, used to break down the statistics
+typedef enum {
+    PROTOCOL_BLOCK_INIT = 0,    // Initial query / handshake
+    PROTOCOL_BLOCK_MAIN,        // Main block poll or write
+    PROTOCOL_BLOCK_EXTRA,
+    PROTOCOL_BLOCK_OPT,         // Optional PCB
+    PROTOCOL_BLOCK_COUNT
+} protocol_block_t;
+
+// Write command latency (request to UART transmission) and pipeline counters
+typedef struct {
+    uint32_t write_count;       // Write frames sent
+    uint32_t write_merged;      // Write commands folded into another frame
+    uint32_t poll_count;
+    uint32_t frames_unchanged;  // Valid frames identical to the previous one of their type
+    int64_t write_latency_last_us;
+    int64_t write_latency_max_us;
+    int64_t write_latency_total_us;
+    uint32_t rx_timeouts;       // Requests without any response
+    uint32_t rx_incomplete;     // Responses cut short or overflowing the RX buffer
+    uint32_t rx_bad_size;       // Frames rejected by protocol_process_received_data()
+    uint32_t rx_bad_header;
+    uint32_t rx_bad_checksum;
+    uint32_t write_queue_max;   // Most write commands waiting at once
+    uint32_t poll_interval_ms[PROTOCOL_BLOCK_COUNT]; // Current adaptive poll interval (INIT unused)
+    uint32_t poll_transitions;  // State transitions that switched main polling to the minimum interval
+    metrics_hist_t response_time[PROTOCOL_BLOCK_COUNT]; // Request sent to complete response
+    metrics_hist_t decode_time[PROTOCOL_BLOCK_COUNT];   // Decode and publish of a valid frame
+    metrics_hist_t write_wait;  // Write command queued to sent (write_latency_* as a histogram)
+} protocol_stats_t;
+
 // Protocol context
 typedef struct {
-    QueueHandle_t command_queue;
+    QueueHandle_t command_queue;        // Write commands, served first
+    QueueHandle_t poll_queue;           // Periodic queries, served when no write is pending
+    QueueHandle_t uart_event_queue;
     TaskHandle_t protocol_task_handle;
     bool extra_data_block_available;
 } protocol_context_t;
@@ -105,31 +165,52 @@ esp_err_t protocol_start(void);
 
 /**
  * @brief Send command to heat pump
+ * Write commands preempt pending periodic queries
  * @param cmd Command to send
  * @return ESP_OK on success
  */
 esp_err_t protocol_send_command(const protocol_cmd_t *cmd);
 
+/**
+ * @brief Get protocol statistics
+ * @param stats Output statistics
+ */
+void protocol_get_stats(protocol_stats_t *stats);
+
+/**
+ * @brief Validate, decode and publish one received frame
+ * Called by the protocol task for every response; frames not already in
+ * g_protocol_rx are copied there for the decoder
+ * @param data Frame including header and checksum
+ * @param size Frame size
+ * @return ESP_OK if the frame is valid
+ */
+esp_err_t protocol_process_received_data(const uint8_t *data, size_t size);
+
 /**
  * @brief Send initial query to heat pump
+ * Queued as a low priority poll; call from the protocol task
  * @return ESP_OK on success
  */
 esp_err_t protocol_send_initial_query(void);
 
 /**
  * @brief Request main data from heat pump
+ * Queued as a low priority poll; call from the protocol task
  * @return ESP_OK on success
  */
 esp_err_t protocol_request_main_data(void);
 
 /**
  * @brief Request extra data from heat pump
+ * Queued as a low priority poll; call from the protocol task
  * @return ESP_OK on success
  */
 esp_err_t protocol_request_extra_data(void);
 
 /**
  * @brief Request optional data from heat pump
+ * Queued as a low priority poll; call from the protocol task
  * @return ESP_OK on success
  */
 esp_err_t protocol_request_opt_data(void);
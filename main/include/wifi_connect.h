@@ -26,6 +26,23 @@ typedef struct {
     char password[WIFI_PASSWORD_MAX_LEN];
 } wifi_credentials_t;
 
+/**
+ * @brief Connection state
+ */
+typedef enum {
+    WIFI_CONNECT_STATE_IDLE = 0,    ///< Station stopped
+    WIFI_CONNECT_STATE_CONNECTING,  ///< Association or DHCP in progress
+    WIFI_CONNECT_STATE_CONNECTED,   ///< IP assigned
+    WIFI_CONNECT_STATE_BACKOFF      ///< Disconnected, waiting before the next attempt
+} wifi_connect_state_t;
+
+/**
+ * @brief Connection state listener
+ * Called from the event loop or esp_timer task on every state change; must
+ * not block
+ */
+typedef void (*wifi_connect_state_cb_t)(wifi_connect_state_t state);
+
 /**
  * @brief Initialize WiFi connection module
  * @return ESP_OK on success
@@ -34,6 +51,8 @@ esp_err_t wifi_connect_init(void);
 
 /**
  * @brief Start WiFi connection
+ * Returns once the station is started, without waiting for an IP; use
+ * wifi_connect_set_state_callback() to follow the connection
  * @return ESP_OK on success
  */
 esp_err_t wifi_connect_start(void);
@@ -50,6 +69,17 @@ esp_err_t wifi_connect_stop(void);
  */
 bool wifi_connect_is_connected(void);
 
+/**
+ * @brief Get the connection state
+ */
+wifi_connect_state_t wifi_connect_get_state(void);
+
+/**
+ * @brief Register the connection state listener (one, replaces the previous)
+ * @param cb Listener, NULL to remove
+ */
+void wifi_connect_set_state_callback(wifi_connect_state_cb_t cb);
+
 /**
  * @brief Get current IP address
  * @param ip_str Buffer to store IP address string (at least 16 bytes)
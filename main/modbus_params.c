@@ -9,8 +9,14 @@
 #include "include/commands.h"
 #include "include/modbus_slave.h"
 #include "include/nvs_hp.h"
+#include "include/mqtt_pub.h"
+#include "include/project_config.h"
 #include "esp_log.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include <stddef.h>
 #include <string.h>
+#include <time.h>
 
 static const char *TAG = "MODBUS_PARAMS";
 
@@ -19,9 +25,61 @@ static const char *TAG = "MODBUS_PARAMS";
 // by the Modbus client. We use int16_t for values that can be negative (temperatures, etc.)
 int16_t mb_input_registers[MB_REG_INPUT_COUNT] = {0};
 int16_t mb_holding_registers[MB_REG_HOLDING_COUNT] = {0};
+int16_t mb_input_registers_back[MB_REG_INPUT_COUNT] = {0};
+
+// Seqlock counter for mb_input_registers: odd while a commit is in progress
+static uint32_t mb_input_seq = 0;
+
+// Warm-start snapshot of the input registers, saved after every decoded main
+// frame. The RTC memory copy survives resets but not a power loss; the same
+// layout is checkpointed to NVS every CONFIG_WARM_CACHE_NVS_INTERVAL_SEC.
+#define MB_WARM_CACHE_MAGIC     0x4D524157  // "WARM"
+#define MB_WARM_CACHE_AGE_MAX   32767
+#define MB_WARM_CACHE_AGE_STEP_US   1000000
+
+typedef struct {
+    uint32_t magic;
+    uint32_t hash;                          // FNV-1a of saved_at and regs
+    int64_t saved_at;                       // time() when saved; the RTC clock runs across resets
+    int16_t regs[MB_REG_INPUT_COUNT];
+} mb_warm_cache_t;
+
+static RTC_NOINIT_ATTR mb_warm_cache_t mb_warm_cache;
+static mb_warm_cache_t mb_warm_checkpoint;  // Main task copy for the NVS write
+static uint32_t mb_warm_saves = 0;          // Snapshots saved this boot (protocol task)
+static uint32_t mb_warm_checkpointed = 0;   // mb_warm_saves at the last NVS write
+static int64_t mb_warm_next_checkpoint_us = CONFIG_WARM_CACHE_NVS_INTERVAL_SEC * 1000000LL;
+static int64_t mb_warm_next_age_us = 0;
+static int64_t mb_warm_restored_age = -1;   // Snapshot age at boot in s, -1 unknown
+static bool mb_inputs_stale = false;        // Guarded by the slave lock
 
 #define HOLDING_INDEX(reg)  ((reg) - MB_REG_HOLDING_START)
 
+// Default remap window: the former fixed copy block at 0x0170-0x018E
+#define MB_REMAP_DEFAULT_SOURCES { \
+    MB_INPUT_MAIN_INLET_TEMP, MB_INPUT_MAIN_OUTLET_TEMP, MB_INPUT_MAIN_TARGET_TEMP, \
+    MB_INPUT_DHW_TARGET_TEMP, MB_INPUT_OUTSIDE_TEMP, MB_INPUT_INSIDE_PIPE_TEMP, \
+    MB_INPUT_OUTSIDE_PIPE_TEMP, MB_INPUT_HEAT_POWER_CONSUMPTION, MB_INPUT_COOL_POWER_CONSUMPTION, \
+    MB_INPUT_DHW_POWER_CONSUMPTION, MB_INPUT_COMPRESSOR_FREQ, MB_INPUT_PUMP_FLOW, \
+    MB_INPUT_OPERATIONS_HOURS, MB_INPUT_OPERATIONS_COUNTER, MB_INPUT_PUMP_SPEED, \
+    MB_INPUT_COMPRESSOR_CURRENT, MB_INPUT_PUMP_DUTY, MB_INPUT_HEATPUMP_STATE, \
+    MB_INPUT_FORCE_DHW_STATE, MB_INPUT_OPERATING_MODE_STATE, MB_INPUT_THREE_WAY_VALVE_STATE, \
+    MB_INPUT_DEFROSTING_STATE, MB_INPUT_HEATING_MODE, MB_INPUT_COOLING_MODE, \
+    MB_INPUT_WATER_PRESSURE, MB_INPUT_EXTERNAL_CONTROL, MB_INPUT_EXTERNAL_ERROR_SIGNAL, \
+    MB_INPUT_TWO_WAY_VALVE_STATE, MB_INPUT_THREE_WAY_VALVE_STATE2, MB_INPUT_ERROR_TYPE, \
+    MB_INPUT_ERROR_NUMBER, MB_REMAP_UNUSED \
+}
+
+static const uint16_t mb_remap_default[MB_INPUT_REMAP_COUNT] = MB_REMAP_DEFAULT_SOURCES;
+
+// Source input register of every window slot. Changed by the Modbus task
+// under the slave lock, read by the protocol and sensor tasks.
+static uint16_t mb_remap_sources[MB_INPUT_REMAP_COUNT] = MB_REMAP_DEFAULT_SOURCES;
+
+_Static_assert(MB_INPUT_REMAP_START + MB_INPUT_REMAP_COUNT <= MB_INPUT_ADC_AIN, "remap window overlaps the ADC registers");
+_Static_assert(MB_HOLDING_REMAP_SRC_START + MB_HOLDING_REMAP_SRC_REGS <= MB_REG_HOLDING_START + MB_REG_HOLDING_COUNT,
+               "remap sources outside the holding area");
+
 static bool modbus_is_supported_baud(uint32_t baud);
 static bool modbus_decode_parity(uint16_t code, uart_parity_t *parity);
 static int16_t modbus_encode_parity(uart_parity_t parity);
@@ -32,6 +90,7 @@ static int16_t modbus_encode_data_bits(uart_word_length_t data_bits);
 static bool modbus_is_valid_slave_id(uint32_t value);
 void modbus_params_sync_serial_registers(void);
 static esp_err_t modbus_build_serial_config_from_registers(modbus_serial_config_t *cfg);
+static esp_err_t modbus_apply_remap_registers(int16_t mode);
 
 static bool modbus_is_supported_baud(uint32_t baud) {
     return (baud >= 1200U && baud <= 57600U);
@@ -125,6 +184,326 @@ void modbus_params_sync_serial_registers(void) {
     mb_holding_registers[HOLDING_INDEX(MB_HOLDING_SET_MODBUS_SLAVE_ID)] = (int16_t)cfg.slave_addr;
 }
 
+/**
+ * @brief Refresh the remap window slots of a register array from their sources
+ * Caller holds the slave lock
+ */
+static void modbus_remap_gather(int16_t *regs) {
+    for (size_t i = 0; i < MB_INPUT_REMAP_COUNT; i++) {
+        uint16_t src = mb_remap_sources[i];
+        regs[MB_INPUT_REMAP_START + i] = (src == MB_REMAP_UNUSED) ? 0 : regs[src];
+    }
+}
+
+/**
+ * @brief Publish the back buffer to mb_input_registers
+ */
+void modbus_params_commit_inputs(void) {
+    // Modbus reads take the same lock, HTTP/MQTT readers follow the sequence
+    modbus_slave_lock();
+    modbus_remap_gather(mb_input_registers_back);
+    __atomic_store_n(&mb_input_seq, mb_input_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(mb_input_registers, mb_input_registers_back, sizeof(mb_input_registers));
+    __atomic_store_n(&mb_input_seq, mb_input_seq + 1, __ATOMIC_RELEASE);
+    modbus_slave_unlock();
+}
+
+/**
+ * @brief Store an input register and the window slots mapped to it
+ * Caller holds the slave lock
+ */
+static void modbus_set_input_locked(uint16_t reg_addr, int16_t value) {
+    // The register and its window copies change together for seqlock readers
+    __atomic_store_n(&mb_input_seq, mb_input_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    mb_input_registers[reg_addr] = value;
+    for (size_t i = 0; i < MB_INPUT_REMAP_COUNT; i++) {
+        if (mb_remap_sources[i] == reg_addr) {
+            mb_input_registers_back[MB_INPUT_REMAP_START + i] = value;
+            mb_input_registers[MB_INPUT_REMAP_START + i] = value;
+        }
+    }
+    __atomic_store_n(&mb_input_seq, mb_input_seq + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Set a single input register outside of the decoder (sensors)
+ */
+void modbus_params_set_input(uint16_t reg_addr, int16_t value) {
+    if (reg_addr >= MB_REG_INPUT_COUNT) {
+        return;
+    }
+    // Back buffer first: a concurrent commit then copies either the new
+    // value or finishes before the live store below
+    mb_input_registers_back[reg_addr] = value;
+    modbus_slave_lock();
+    modbus_set_input_locked(reg_addr, value);
+    modbus_slave_unlock();
+}
+
+static uint32_t modbus_warm_cache_hash(const mb_warm_cache_t *cache) {
+    const uint8_t *p = (const uint8_t *)&cache->saved_at;
+    size_t len = offsetof(mb_warm_cache_t, regs) + sizeof(cache->regs) - offsetof(mb_warm_cache_t, saved_at);
+    uint32_t hash = 2166136261u;
+    while (len--) {
+        hash ^= *p++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool modbus_warm_cache_valid(const mb_warm_cache_t *cache) {
+    return cache->magic == MB_WARM_CACHE_MAGIC && cache->hash == modbus_warm_cache_hash(cache);
+}
+
+static int16_t modbus_warm_cache_age_reg(int64_t age) {
+    if (age < 0) {
+        return -1;
+    }
+    return (int16_t)(age > MB_WARM_CACHE_AGE_MAX ? MB_WARM_CACHE_AGE_MAX : age);
+}
+
+/**
+ * @brief Load the last snapshot into both register buffers, flagged stale
+ * Runs before the protocol and Modbus tasks start.
+ */
+static void modbus_restore_warm_cache(void) {
+    const char *source = "RTC memory";
+    int64_t age = -1;
+
+    if (modbus_warm_cache_valid(&mb_warm_cache)) {
+        int64_t now = (int64_t)time(NULL);
+        if (now >= mb_warm_cache.saved_at) {
+            age = now - mb_warm_cache.saved_at;
+        }
+    } else if (modbus_nvs_load_warm_cache(&mb_warm_cache, sizeof(mb_warm_cache)) == ESP_OK &&
+               modbus_warm_cache_valid(&mb_warm_cache)) {
+        // Power was lost and the clock restarted, so the age is unknown
+        source = "NVS";
+    } else {
+        mb_warm_cache.magic = 0;
+        ESP_LOGI(TAG, "No warm-start cache, input registers start at zero");
+        return;
+    }
+
+    memcpy(mb_input_registers_back, mb_warm_cache.regs, sizeof(mb_input_registers_back));
+    mb_input_registers_back[MB_INPUT_CACHE_STALE] = 1;
+    mb_input_registers_back[MB_INPUT_CACHE_AGE] = modbus_warm_cache_age_reg(age);
+    modbus_remap_gather(mb_input_registers_back);
+    memcpy(mb_input_registers, mb_input_registers_back, sizeof(mb_input_registers));
+    mb_warm_restored_age = age;
+    mb_inputs_stale = true;
+    modbus_params_sync_holding_from_input();
+
+    if (age >= 0) {
+        ESP_LOGI(TAG, "Restored input registers from %s, %lld s old", source, (long long)age);
+    } else {
+        ESP_LOGI(TAG, "Restored input registers from %s, age unknown", source);
+    }
+}
+
+/**
+ * @brief Clear the stale flag of a restored snapshot
+ */
+bool modbus_params_mark_inputs_fresh(void) {
+    if (!__atomic_load_n(&mb_inputs_stale, __ATOMIC_RELAXED)) {
+        return false;
+    }
+    // Under the lock so the main task can't age the snapshot after this
+    modbus_slave_lock();
+    mb_inputs_stale = false;
+    mb_input_registers_back[MB_INPUT_CACHE_STALE] = 0;
+    mb_input_registers_back[MB_INPUT_CACHE_AGE] = 0;
+    modbus_slave_unlock();
+    return true;
+}
+
+/**
+ * @brief Save the published input registers to the RTC memory snapshot
+ */
+void modbus_params_save_warm_cache(void) {
+    // A reset during the update leaves a hash mismatch, and the NVS copy is used
+    mb_warm_cache.magic = MB_WARM_CACHE_MAGIC;
+    mb_warm_cache.saved_at = (int64_t)time(NULL);
+    memcpy(mb_warm_cache.regs, mb_input_registers_back, sizeof(mb_warm_cache.regs));
+    mb_warm_cache.hash = modbus_warm_cache_hash(&mb_warm_cache);
+    __atomic_store_n(&mb_warm_saves, mb_warm_saves + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Age the restored snapshot and write the periodic NVS checkpoint
+ */
+void modbus_params_warm_cache_poll(void) {
+    int64_t now = esp_timer_get_time();
+
+    if (now >= mb_warm_next_age_us) {
+        mb_warm_next_age_us = now + MB_WARM_CACHE_AGE_STEP_US;
+        if (mb_warm_restored_age >= 0) {
+            int16_t age = modbus_warm_cache_age_reg(mb_warm_restored_age + now / 1000000);
+            modbus_slave_lock();
+            if (mb_inputs_stale) {
+                mb_input_registers_back[MB_INPUT_CACHE_AGE] = age;
+                modbus_set_input_locked(MB_INPUT_CACHE_AGE, age);
+            }
+            modbus_slave_unlock();
+        }
+    }
+
+    if (now < mb_warm_next_checkpoint_us) {
+        return;
+    }
+    uint32_t saves = __atomic_load_n(&mb_warm_saves, __ATOMIC_ACQUIRE);
+    if (saves == mb_warm_checkpointed) {
+        // Nothing decoded since the last checkpoint
+        mb_warm_next_checkpoint_us = now + CONFIG_WARM_CACHE_NVS_INTERVAL_SEC * 1000000LL;
+        return;
+    }
+    // The protocol task may be saving right now; a torn copy is retried on the next poll
+    memcpy(&mb_warm_checkpoint, &mb_warm_cache, sizeof(mb_warm_checkpoint));
+    if (!modbus_warm_cache_valid(&mb_warm_checkpoint)) {
+        return;
+    }
+    if (modbus_nvs_save_warm_cache(&mb_warm_checkpoint, sizeof(mb_warm_checkpoint)) == ESP_OK) {
+        ESP_LOGI(TAG, "Input registers checkpointed to NVS");
+    }
+    mb_warm_checkpointed = saves;
+    mb_warm_next_checkpoint_us = now + CONFIG_WARM_CACHE_NVS_INTERVAL_SEC * 1000000LL;
+}
+
+/**
+ * @brief Copy a coherent range of input registers
+ */
+esp_err_t modbus_params_read_inputs(int16_t *dst, uint16_t first, uint16_t count) {
+    if (dst == NULL || (uint32_t)first + count > MB_REG_INPUT_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint32_t seq_begin = __atomic_load_n(&mb_input_seq, __ATOMIC_ACQUIRE);
+    if ((seq_begin & 1U) == 0) {
+        memcpy(dst, &mb_input_registers[first], count * sizeof(int16_t));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&mb_input_seq, __ATOMIC_RELAXED) == seq_begin) {
+            return ESP_OK;
+        }
+    }
+
+    // A commit is in progress: wait for it on the lock instead of spinning,
+    // which would starve a writer of the same or lower priority
+    modbus_slave_lock();
+    memcpy(dst, &mb_input_registers[first], count * sizeof(int16_t));
+    modbus_slave_unlock();
+    return ESP_OK;
+}
+
+/**
+ * @brief Install a remap window map
+ */
+esp_err_t modbus_params_set_remap(const uint16_t *sources, size_t count) {
+    if ((sources == NULL && count > 0) || count > MB_INPUT_REMAP_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    uint16_t map[MB_INPUT_REMAP_COUNT];
+    for (size_t i = 0; i < MB_INPUT_REMAP_COUNT; i++) {
+        map[i] = (i < count) ? sources[i] : MB_REMAP_UNUSED;
+        if (map[i] == MB_REMAP_UNUSED) {
+            continue;
+        }
+        if (map[i] >= MB_REG_INPUT_COUNT ||
+            (map[i] >= MB_INPUT_REMAP_START && map[i] < MB_INPUT_REMAP_START + MB_INPUT_REMAP_COUNT)) {
+            ESP_LOGW(TAG, "Invalid remap source for slot %u: 0x%04X", (unsigned)i, map[i]);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    modbus_slave_lock();
+    memcpy(mb_remap_sources, map, sizeof(mb_remap_sources));
+    for (size_t i = 0; i < MB_INPUT_REMAP_COUNT; i++) {
+        mb_holding_registers[HOLDING_INDEX(MB_HOLDING_REMAP_SRC_START) + i] = (int16_t)map[i];
+    }
+    modbus_remap_gather(mb_input_registers_back);
+    __atomic_store_n(&mb_input_seq, mb_input_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    modbus_remap_gather(mb_input_registers);
+    __atomic_store_n(&mb_input_seq, mb_input_seq + 1, __ATOMIC_RELEASE);
+    modbus_slave_unlock();
+    return ESP_OK;
+}
+
+/**
+ * @brief Copy the active remap window map
+ */
+void modbus_params_get_remap(uint16_t *sources) {
+    if (sources == NULL) {
+        return;
+    }
+    modbus_slave_lock();
+    memcpy(sources, mb_remap_sources, sizeof(mb_remap_sources));
+    modbus_slave_unlock();
+}
+
+/**
+ * @brief Default remap window map (the former fixed copy block)
+ */
+void modbus_params_get_default_remap(uint16_t *sources) {
+    if (sources != NULL) {
+        memcpy(sources, mb_remap_default, sizeof(mb_remap_default));
+    }
+}
+
+/**
+ * @brief Apply the map staged in the MB_HOLDING_REMAP_SRC_* registers
+ * @param mode MB_REMAP_APPLY_SAVE or MB_REMAP_APPLY_DEFAULTS
+ */
+static esp_err_t modbus_apply_remap_registers(int16_t mode) {
+    uint16_t map[MB_INPUT_REMAP_COUNT];
+    if (mode == MB_REMAP_APPLY_DEFAULTS) {
+        memcpy(map, mb_remap_default, sizeof(map));
+    } else if (mode == MB_REMAP_APPLY_SAVE) {
+        for (size_t i = 0; i < MB_INPUT_REMAP_COUNT; i++) {
+            map[i] = (uint16_t)mb_holding_registers[HOLDING_INDEX(MB_HOLDING_REMAP_SRC_START) + i];
+        }
+    } else {
+        ESP_LOGW(TAG, "Invalid REMAP_APPLY value: %d (must be 1 or 2)", mode);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = modbus_params_set_remap(map, MB_INPUT_REMAP_COUNT);
+    if (ret != ESP_OK) {
+        // Show the active map again so the master can see it was rejected
+        modbus_params_get_remap(map);
+        (void)modbus_params_set_remap(map, MB_INPUT_REMAP_COUNT);
+        return ret;
+    }
+
+    ESP_LOGI(TAG, "Remap window updated");
+    esp_err_t save_ret = modbus_nvs_save_remap(map, MB_INPUT_REMAP_COUNT);
+    if (save_ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save remap window to NVS: %s", esp_err_to_name(save_ret));
+    }
+    return save_ret;
+}
+
+void modbus_params_load_poll_limits(void) {
+    uint16_t min_sec = CONFIG_PROTOCOL_POLL_MIN_SEC;
+    uint16_t max_sec = CONFIG_PROTOCOL_POLL_MAX_SEC;
+    esp_err_t ret = modbus_nvs_load_poll_limits(&min_sec, &max_sec);
+    if (ret == ESP_OK) {
+        ESP_LOGI(TAG, "Loaded poll interval limits from NVS: %u-%u s", min_sec, max_sec);
+    } else if (ret != ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "Failed to load poll interval limits from NVS: %s", esp_err_to_name(ret));
+    }
+    if (ret != ESP_OK ||
+        min_sec < 1 || min_sec > MB_POLL_LIMIT_MAX_SEC ||
+        max_sec < 1 || max_sec > MB_POLL_LIMIT_MAX_SEC) {
+        min_sec = CONFIG_PROTOCOL_POLL_MIN_SEC;
+        max_sec = CONFIG_PROTOCOL_POLL_MAX_SEC;
+    }
+    mb_holding_registers[HOLDING_INDEX(MB_HOLDING_POLL_MIN_SEC)] = (int16_t)min_sec;
+    mb_holding_registers[HOLDING_INDEX(MB_HOLDING_POLL_MAX_SEC)] = (int16_t)max_sec;
+}
+
 /**
  * @brief Sync holding registers with current decoded heat pump data
  * This allows reading current values (temperatures, deltas, etc.) from holding registers
@@ -191,9 +570,9 @@ static esp_err_t modbus_build_serial_config_from_registers(modbus_serial_config_
     }
 
     uint32_t baud = (uint16_t)mb_holding_registers[HOLDING_INDEX(MB_HOLDING_SET_MODBUS_BAUD)];
-    uart_parity_t parity;
-    uart_stop_bits_t stop_bits;
-    uart_word_length_t data_bits;
+    uart_parity_t parity = UART_PARITY_DISABLE;
+    uart_stop_bits_t stop_bits = UART_STOP_BITS_1;
+    uart_word_length_t data_bits = UART_DATA_8_BITS;
     uint8_t slave_id = (uint8_t)mb_holding_registers[HOLDING_INDEX(MB_HOLDING_SET_MODBUS_SLAVE_ID)];
 
     // Значения уже проверены при записи в holding-регистры,
@@ -220,6 +599,10 @@ esp_err_t modbus_params_init(void) {
     // memset(mb_holding_registers, 0, sizeof(mb_holding_registers));
 
     modbus_params_sync_serial_registers();
+    for (size_t i = 0; i < MB_INPUT_REMAP_COUNT; i++) {
+        mb_holding_registers[HOLDING_INDEX(MB_HOLDING_REMAP_SRC_START) + i] = (int16_t)mb_remap_sources[i];
+    }
+    modbus_restore_warm_cache();
     
     ESP_LOGI(TAG, "Modbus parameters initialized: %d input, %d holding registers",
              MB_REG_INPUT_COUNT, MB_REG_HOLDING_COUNT);
@@ -635,7 +1018,53 @@ esp_err_t modbus_params_process_holding_write(uint16_t reg_addr) {
             break;
         }
 
+        case MB_HOLDING_MQTT_PAYLOAD_MODE: {
+            // 0 = per-topic values, 1 = single JSON state document
+            if (value != MQTT_PAYLOAD_TOPICS && value != MQTT_PAYLOAD_JSON) {
+                ESP_LOGW(TAG, "Invalid MQTT_PAYLOAD_MODE value: %d (must be 0 or 1)", value);
+                ret = ESP_ERR_INVALID_ARG;
+            } else {
+                ESP_LOGI(TAG, "MQTT_PAYLOAD_MODE set to %d", value);
+                esp_err_t save_ret = modbus_nvs_save_mqtt_payload_mode((uint8_t)value);
+                if (save_ret != ESP_OK) {
+                    ESP_LOGE(TAG, "Failed to save MQTT payload mode to NVS: %s", esp_err_to_name(save_ret));
+                    ret = save_ret;
+                }
+            }
+            break;
+        }
+
+        case MB_HOLDING_REMAP_APPLY:
+            ret = modbus_apply_remap_registers(value);
+            break;
+
+        case MB_HOLDING_POLL_MIN_SEC:
+        case MB_HOLDING_POLL_MAX_SEC: {
+            // The protocol task reads both registers at every poll
+            if (value < 1 || value > MB_POLL_LIMIT_MAX_SEC) {
+                ESP_LOGW(TAG, "Invalid poll interval limit: %d (must be 1-%d s)", value, MB_POLL_LIMIT_MAX_SEC);
+                // Put the stored limits back so the rejected value is never used
+                modbus_params_load_poll_limits();
+                ret = ESP_ERR_INVALID_ARG;
+            } else {
+                uint16_t min_sec = (uint16_t)mb_holding_registers[HOLDING_INDEX(MB_HOLDING_POLL_MIN_SEC)];
+                uint16_t max_sec = (uint16_t)mb_holding_registers[HOLDING_INDEX(MB_HOLDING_POLL_MAX_SEC)];
+                ESP_LOGI(TAG, "Poll interval limits set to %u-%u s", min_sec, max_sec);
+                esp_err_t save_ret = modbus_nvs_save_poll_limits(min_sec, max_sec);
+                if (save_ret != ESP_OK) {
+                    ESP_LOGE(TAG, "Failed to save poll limits to NVS: %s", esp_err_to_name(save_ret));
+                    ret = save_ret;
+                }
+            }
+            break;
+        }
+
         default:
+            // Remap sources are staged until MB_HOLDING_REMAP_APPLY
+            if (reg_addr >= MB_HOLDING_REMAP_SRC_START &&
+                reg_addr < MB_HOLDING_REMAP_SRC_START + MB_HOLDING_REMAP_SRC_REGS) {
+                break;
+            }
             ESP_LOGW(TAG, "Write to unhandled register: 0x%04X", reg_addr);
             ret = ESP_ERR_NOT_SUPPORTED;
             break;
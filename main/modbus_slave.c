@@ -1,6 +1,6 @@
 /**
  * @file modbus_slave.c
- * @brief Modbus RTU slave implementation using ESP-IDF esp-modbus v2.x
+ * @brief Modbus RTU and TCP slave implementation using ESP-IDF esp-modbus v2.x
  * @version 1.0.0
  * @date 2025
  */
@@ -11,15 +11,19 @@
 #include "esp_log.h"
 #include "driver/uart.h"
 #include "freertos/task.h"
+#include "esp_netif.h"
 #include <string.h>
 #include "include/nvs_hp.h"
+#include "include/mqtt_pub.h"
+#include "include/project_config.h"
 
 static const char *TAG = "MODBUS_SLAVE";
 
-// Modbus slave handle
+// Modbus slave handles
 static void *mbc_slave_handle = NULL;
+static void *mbc_slave_tcp_handle = NULL;
 
-// Task handle
+// Dispatch task handle
 static TaskHandle_t mb_task_handle = NULL;
 
 modbus_serial_config_t base_serial_cfg = {
@@ -32,15 +36,57 @@ modbus_serial_config_t base_serial_cfg = {
 
 static bool modbus_slave_running = false;
 
-// Shadow copy of holding registers to detect actual changes
-static int16_t mb_holding_registers_shadow[MB_REG_HOLDING_COUNT];
-static bool shadow_initialized = false;
+// Holding registers written by the master and not yet dispatched, with the
+// values captured when the write notification was received
+#define MB_HOLDING_DIRTY_WORDS ((MB_REG_HOLDING_COUNT + 31) / 32)
+static uint32_t mb_holding_dirty[MB_HOLDING_DIRTY_WORDS];
+static int16_t mb_holding_written[MB_REG_HOLDING_COUNT];
+
+// Statistics; each port's counters are written by its listener task only,
+// writes_dispatched by the dispatch task
+static modbus_slave_stats_t mb_stats = {0};
+
+// Wait for parameter notifications in slices so the task stays responsive
+#define MB_PARAM_INFO_WAIT_MS 1000
 
 // Forward declarations
 static esp_err_t modbus_slave_setup_controller(void);
+static esp_err_t modbus_slave_set_areas(void *handle);
 static bool modbus_slave_validate_serial_config(const modbus_serial_config_t *cfg);
 static void modbus_log_serial_config(const char *prefix, const modbus_serial_config_t *cfg);
 
+/**
+ * @brief Register the shared input and holding areas with a controller
+ * Both slave instances serve the same arrays
+ */
+static esp_err_t modbus_slave_set_areas(void *handle) {
+    mb_register_area_descriptor_t reg_area = {
+        .type = MB_PARAM_INPUT,
+        .start_offset = MB_REG_INPUT_START,
+        .address = (void *)mb_input_registers,
+        .size = MB_REG_INPUT_COUNT * sizeof(uint16_t),
+        .access = MB_ACCESS_RO
+    };
+
+    esp_err_t ret = mbc_slave_set_descriptor(handle, reg_area);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set input registers descriptor: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    reg_area.type = MB_PARAM_HOLDING;
+    reg_area.start_offset = MB_REG_HOLDING_START;
+    reg_area.address = (void *)mb_holding_registers;
+    reg_area.size = MB_REG_HOLDING_COUNT * sizeof(uint16_t);
+    reg_area.access = MB_ACCESS_RW;
+
+    ret = mbc_slave_set_descriptor(handle, reg_area);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set holding registers descriptor: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
 /**
  * @brief Setup Modbus controller with current serial configuration
  */
@@ -69,31 +115,8 @@ static esp_err_t modbus_slave_setup_controller(void) {
         return ret;
     }
 
-    // Configure input registers
-    mb_register_area_descriptor_t reg_area = {
-        .type = MB_PARAM_INPUT,
-        .start_offset = MB_REG_INPUT_START,
-        .address = (void *)mb_input_registers,
-        .size = MB_REG_INPUT_COUNT * sizeof(uint16_t),
-        .access = MB_ACCESS_RO
-    };
-
-    ret = mbc_slave_set_descriptor(mbc_slave_handle, reg_area);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set input registers descriptor: %s", esp_err_to_name(ret));
-        goto cleanup;
-    }
-
-    // Configure holding registers
-    reg_area.type = MB_PARAM_HOLDING;
-    reg_area.start_offset = MB_REG_HOLDING_START;
-    reg_area.address = (void *)mb_holding_registers;
-    reg_area.size = MB_REG_HOLDING_COUNT * sizeof(uint16_t);
-    reg_area.access = MB_ACCESS_RW;
-
-    ret = mbc_slave_set_descriptor(mbc_slave_handle, reg_area);
+    ret = modbus_slave_set_areas(mbc_slave_handle);
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set holding registers descriptor: %s", esp_err_to_name(ret));
         goto cleanup;
     }
 
@@ -189,67 +212,113 @@ static void modbus_log_serial_config(const char *prefix, const modbus_serial_con
 }
 
 /**
- * @brief Process holding register write event by comparing with shadow copy
- * This approach is more reliable than using mbc_slave_get_param_info() which
- * often returns incorrect size/address information
+ * @brief Mark holding registers from a write notification as dirty
+ * @param info Parameter info from mbc_slave_get_param_info()
  */
-static void modbus_process_holding_write_event(void) {
-    // Shadow copy must be initialized before first write event (in modbus_slave_start)
-    if (!shadow_initialized) {
-        ESP_LOGW(TAG, "Shadow copy not initialized! This should not happen.");
-        memcpy(mb_holding_registers_shadow, mb_holding_registers, sizeof(mb_holding_registers_shadow));
-        shadow_initialized = true;
-        // Don't process on emergency initialization - wait for next write
+static void modbus_mark_holding_dirty(const mb_param_info_t *info) {
+    if (info->mb_offset < MB_REG_HOLDING_START) {
         return;
     }
+    uint32_t first = info->mb_offset - MB_REG_HOLDING_START;
+    uint32_t last = first + info->size;
+    if (last > MB_REG_HOLDING_COUNT) {
+        ESP_LOGW(TAG, "Write notification out of range: 0x%04X+%u", info->mb_offset, (unsigned)info->size);
+        last = MB_REG_HOLDING_COUNT;
+    }
+
+    // Capture the written values now, before the protocol task can
+    // overwrite them with the next sync from input registers
+    modbus_slave_lock();
+    for (uint32_t i = first; i < last; i++) {
+        mb_holding_written[i] = mb_holding_registers[i];
+        mb_holding_dirty[i / 32] |= (1UL << (i % 32));
+    }
+    modbus_slave_unlock();
+}
 
-    // Compare current values with shadow to detect actual changes
-    uint16_t changed_count = 0;
-    for (uint16_t i = 0; i < MB_REG_HOLDING_COUNT; i++) {
-        if (mb_holding_registers[i] != mb_holding_registers_shadow[i]) {
+/**
+ * @brief Dispatch dirty holding registers in address order
+ * Writes from both slave instances end up here, in the dispatch task
+ */
+static void modbus_dispatch_dirty_holding(void) {
+    uint32_t dirty[MB_HOLDING_DIRTY_WORDS];
+    uint16_t dispatched = 0;
+
+    modbus_slave_lock();
+    memcpy(dirty, mb_holding_dirty, sizeof(dirty));
+    memset(mb_holding_dirty, 0, sizeof(mb_holding_dirty));
+    modbus_slave_unlock();
+
+    for (uint32_t word = 0; word < MB_HOLDING_DIRTY_WORDS; word++) {
+        while (dirty[word] != 0) {
+            uint32_t bit = __builtin_ctz(dirty[word]);
+            dirty[word] &= ~(1UL << bit);
+            uint32_t i = word * 32 + bit;
             uint16_t reg_addr = MB_REG_HOLDING_START + i;
-            int16_t old_val = mb_holding_registers_shadow[i];
-            int16_t new_val = mb_holding_registers[i];
-            
-            ESP_LOGI(TAG, "Register 0x%04X changed: %d -> %d", reg_addr, old_val, new_val);
-            
-            // Update shadow BEFORE processing (so if processing fails, we don't retry)
-            mb_holding_registers_shadow[i] = new_val;
-            
-            // Process the change
+
+            // Restore the written value in case a sync replaced it meanwhile
+            modbus_slave_lock();
+            int16_t value = mb_holding_written[i];
+            mb_holding_registers[i] = value;
+            modbus_slave_unlock();
+
+            ESP_LOGI(TAG, "Register 0x%04X written: %d", reg_addr, value);
             modbus_params_process_holding_write(reg_addr);
-            changed_count++;
+            mb_stats.writes_dispatched++;
+            dispatched++;
         }
     }
+    if (dispatched > 0) {
+        ESP_LOGI(TAG, "Processed %u holding register write(s)", dispatched);
+    }
+}
 
-    if (changed_count == 0) {
-        ESP_LOGD(TAG, "Holding write event but no changes detected");
-    } else {
-        ESP_LOGI(TAG, "Processed %u holding register change(s)", changed_count);
+/**
+ * @brief Listener task - blocks on parameter notifications from one slave
+ * @param pvParameters Controller handle
+ */
+static void modbus_listen_task(void *pvParameters) {
+    void *handle = pvParameters;
+    modbus_slave_port_stats_t *stats = &mb_stats.port[handle == mbc_slave_handle ? MODBUS_SLAVE_RTU : MODBUS_SLAVE_TCP];
+
+    while (1) {
+        mb_param_info_t info;
+        if (mbc_slave_get_param_info(handle, &info, MB_PARAM_INFO_WAIT_MS) != ESP_OK) {
+            continue;
+        }
+
+        // Collect everything already queued (one request may write several
+        // areas), then dispatch so related commands are queued together
+        bool written = false;
+        do {
+            if (info.type & MB_EVENT_HOLDING_REG_WR) {
+                modbus_mark_holding_dirty(&info);
+                stats->holding_writes++;
+                written = true;
+            }
+            if (info.type & MB_EVENT_HOLDING_REG_RD) {
+                stats->holding_reads++;
+            }
+            if (info.type & MB_EVENT_INPUT_REG_RD) {
+                stats->input_reads++;
+            }
+        } while (mbc_slave_get_param_info(handle, &info, 0) == ESP_OK);
+
+        if (written) {
+            xTaskNotifyGive(mb_task_handle);
+        }
     }
 }
 
 /**
- * @brief Modbus task - periodically check events
+ * @brief Modbus task - dispatches holding register writes from all slaves
  */
 static void modbus_task(void *pvParameters) {
     ESP_LOGI(TAG, "Modbus task started");
-    
+
     while (1) {
-        // Check for Modbus events only if controller is valid
-        if (mbc_slave_handle != NULL) {
-            mb_event_group_t event = mbc_slave_check_event(mbc_slave_handle, 
-                                                           MB_EVENT_HOLDING_REG_WR | 
-                                                           MB_EVENT_INPUT_REG_RD | 
-                                                           MB_EVENT_HOLDING_REG_RD);
-            
-            if (event & MB_EVENT_HOLDING_REG_WR) {
-                modbus_process_holding_write_event();
-            }
-        }
-        
-        // Update every 100ms
-        vTaskDelay(pdMS_TO_TICKS(100));
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        modbus_dispatch_dirty_holding();
     }
 }
 
@@ -318,6 +387,35 @@ esp_err_t modbus_slave_init(void) {
     if (mqtt_index >= 0 && mqtt_index < MB_REG_HOLDING_COUNT) {
         mb_holding_registers[mqtt_index] = (int16_t)(mqtt_publish_flag ? 1 : 0);
     }
+
+    // Restore MQTT payload mode from NVS (default per-topic)
+    uint8_t mqtt_mode = MQTT_PAYLOAD_TOPICS;
+    esp_err_t mode_load_ret = modbus_nvs_load_mqtt_payload_mode(&mqtt_mode);
+    if (mode_load_ret == ESP_OK) {
+        ESP_LOGI(TAG, "Loaded MQTT payload mode from NVS: %u", mqtt_mode);
+    } else if (mode_load_ret != ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "Failed to load MQTT payload mode from NVS: %s", esp_err_to_name(mode_load_ret));
+    }
+    if (mqtt_mode != MQTT_PAYLOAD_TOPICS && mqtt_mode != MQTT_PAYLOAD_JSON) {
+        mqtt_mode = MQTT_PAYLOAD_TOPICS;
+    }
+    mb_holding_registers[MB_HOLDING_MQTT_PAYLOAD_MODE - MB_REG_HOLDING_START] = (int16_t)mqtt_mode;
+
+    // Restore the adaptive poll interval limits from NVS
+    modbus_params_load_poll_limits();
+
+    // Restore the remap window map from NVS (default: former copy block)
+    uint16_t remap[MB_INPUT_REMAP_COUNT];
+    esp_err_t remap_load_ret = modbus_nvs_load_remap(remap, MB_INPUT_REMAP_COUNT);
+    if (remap_load_ret == ESP_OK) {
+        if (modbus_params_set_remap(remap, MB_INPUT_REMAP_COUNT) == ESP_OK) {
+            ESP_LOGI(TAG, "Loaded remap window from NVS");
+        } else {
+            ESP_LOGW(TAG, "Stored remap window invalid, using default map");
+        }
+    } else if (remap_load_ret != ESP_ERR_NOT_FOUND) {
+        ESP_LOGW(TAG, "Failed to load remap window from NVS: %s", esp_err_to_name(remap_load_ret));
+    }
     
     // Setup Modbus controller
     ret = modbus_slave_setup_controller();
@@ -352,15 +450,13 @@ esp_err_t modbus_slave_start(void) {
     }
     modbus_slave_running = true;
     
-    // Initialize shadow copy of holding registers BEFORE first write event
-    // This ensures we can detect changes on the very first write
-    memcpy(mb_holding_registers_shadow, mb_holding_registers, sizeof(mb_holding_registers_shadow));
-    shadow_initialized = true;
-    ESP_LOGI(TAG, "Holding registers shadow initialized");
-    
-    // Create task to process events
+    // Create the dispatch task first so listeners always have a target
     BaseType_t task_ret = xTaskCreate(modbus_task, "modbus_task", 4096, 
                                       NULL, 5, &mb_task_handle);
+    if (task_ret == pdPASS) {
+        task_ret = xTaskCreate(modbus_listen_task, "modbus_rtu", 3072,
+                               mbc_slave_handle, 5, NULL);
+    }
     if (task_ret != pdPASS) {
         ESP_LOGE(TAG, "Failed to create Modbus task");
         (void)mbc_slave_stop(mbc_slave_handle);
@@ -374,6 +470,72 @@ esp_err_t modbus_slave_start(void) {
 }
 
 
+/**
+ * @brief Start the Modbus TCP slave on the WiFi station interface
+ * @return ESP_OK on success
+ */
+esp_err_t modbus_slave_start_tcp(void) {
+#if CONFIG_MODBUS_TCP_ENABLED
+    if (!modbus_slave_running || mb_task_handle == NULL) {
+        ESP_LOGE(TAG, "Modbus RTU slave not started");
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (mbc_slave_tcp_handle != NULL) {
+        return ESP_OK;
+    }
+
+    esp_netif_t *netif = esp_netif_get_handle_from_ifkey("WIFI_STA_DEF");
+    if (netif == NULL) {
+        ESP_LOGE(TAG, "WiFi station interface not found");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    mb_communication_info_t comm_config = {
+        .tcp_opts.port = CONFIG_MODBUS_TCP_PORT,
+        .tcp_opts.mode = MB_TCP,
+        .tcp_opts.addr_type = MB_IPV4,
+        .tcp_opts.ip_addr_table = NULL,
+        .tcp_opts.ip_netif_ptr = (void *)netif,
+        .tcp_opts.uid = base_serial_cfg.slave_addr
+    };
+
+    void *handle = NULL;
+    esp_err_t ret = mbc_slave_create_tcp(&comm_config, &handle);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Modbus TCP slave create failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    ret = modbus_slave_set_areas(handle);
+    if (ret == ESP_OK) {
+        ret = mbc_slave_start(handle);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Modbus TCP slave start failed: %s", esp_err_to_name(ret));
+        }
+    }
+    if (ret != ESP_OK) {
+        mbc_slave_delete(handle);
+        return ret;
+    }
+
+    // Publish under the RTU lock: modbus_slave_lock() holders see either no
+    // TCP handle or the one they locked until they unlock
+    mbc_slave_lock(mbc_slave_handle);
+    mbc_slave_tcp_handle = handle;
+    mbc_slave_unlock(mbc_slave_handle);
+
+    if (xTaskCreate(modbus_listen_task, "modbus_tcp", 3072, handle, 5, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create Modbus TCP task, TCP writes are ignored");
+        return ESP_ERR_NO_MEM;
+    }
+
+    ESP_LOGI(TAG, "Modbus TCP slave listening on port %d", CONFIG_MODBUS_TCP_PORT);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+
 /**
  * @brief Get current serial configuration
  * @param cfg_out Output buffer for configuration
@@ -387,10 +549,36 @@ esp_err_t modbus_slave_get_serial_config(modbus_serial_config_t *cfg_out) {
     return ESP_OK;
 }
 
-void modbus_slave_update_shadow_copy(void) {
-    if (shadow_initialized) {
-        memcpy(mb_holding_registers_shadow, mb_holding_registers, sizeof(mb_holding_registers_shadow));
-        ESP_LOGD(TAG, "Shadow copy updated after holding registers sync");
+/**
+ * @brief Lock the Modbus register areas against concurrent slave access
+ * Takes the RTU controller lock first, then the TCP one
+ */
+void modbus_slave_lock(void) {
+    if (mbc_slave_handle != NULL) {
+        mbc_slave_lock(mbc_slave_handle);
+        if (mbc_slave_tcp_handle != NULL) {
+            mbc_slave_lock(mbc_slave_tcp_handle);
+        }
+    }
+}
+
+/**
+ * @brief Unlock the Modbus register areas
+ */
+void modbus_slave_unlock(void) {
+    if (mbc_slave_handle != NULL) {
+        if (mbc_slave_tcp_handle != NULL) {
+            mbc_slave_unlock(mbc_slave_tcp_handle);
+        }
+        mbc_slave_unlock(mbc_slave_handle);
     }
 }
 
+/**
+ * @brief Get request statistics
+ */
+void modbus_slave_get_stats(modbus_slave_stats_t *stats) {
+    if (stats != NULL) {
+        *stats = mb_stats;
+    }
+}
@@ -17,9 +17,16 @@
 #include "esp_err.h"
 #include "esp_mac.h"
 #include "esp_random.h"
+#include "esp_timer.h"
 #include "wifi_connect.h"
+#include "cJSON.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 static const char *TAG = "MQTT_CLIENT";
 
@@ -29,6 +36,21 @@ static esp_mqtt_client_handle_t mqtt_client = NULL;
 // Connection status
 static bool mqtt_connected = false;
 
+// esp_mqtt_client_start() called and not stopped since
+static bool mqtt_started = false;
+
+// Force the next publish cycle to send every topic (set on connect)
+static volatile bool mqtt_resync_pending = true;
+
+// Time of the last full publish, microseconds since boot
+static int64_t mqtt_last_full_sync_us = 0;
+
+// Payload mode of the last published snapshot
+static int16_t mqtt_last_mode = MQTT_PAYLOAD_TOPICS;
+
+// Publisher task wake-up period while no snapshot arrives
+#define MQTT_PUBLISH_IDLE_CHECK_MS 1000
+
 // MQTT configuration (using values from project_config.h)
 #define MQTT_BROKER_URL CONFIG_MQTT_BROKER_URL_DEFAULT
 #define MQTT_TOPIC_BASE CONFIG_MQTT_TOPIC_BASE_DEFAULT
@@ -196,13 +218,44 @@ static const mqtt_name_t mqtt_names[] = {
     {MB_INPUT_DS18B20_TEMP8, "ds18b20_8", MQTT_SUB_TEMP}
 };
 
+#define MQTT_NAMES_COUNT (sizeof(mqtt_names) / sizeof(mqtt_name_t))
+#define MQTT_SUBTOPICS_COUNT (sizeof(mqtt_subtopics) / sizeof(mqtt_subtopics[0]))
+
+// Last successfully published value per mqtt_names[] entry
+static int16_t mqtt_last_values[MQTT_NAMES_COUNT];
+static bool mqtt_last_valid[MQTT_NAMES_COUNT];
+
+// Interned topics "<base>/<subtopic>/<name>" stored back to back in one
+// allocation, rebuilt only when the topic base changes
+static char *mqtt_topic_pool = NULL;
+static uint16_t mqtt_topic_offsets[MQTT_NAMES_COUNT];
+static uint16_t mqtt_state_topic_offset = 0;
+static bool mqtt_value_centi[MQTT_NAMES_COUNT];
+static char mqtt_topic_base[CONFIG_MQTT_TOPIC_BASE_MAX_LEN] = MQTT_TOPIC_BASE;
+static SemaphoreHandle_t mqtt_topic_mutex = NULL;
+
+// Immutable copy of the published registers handed to the publisher task
+typedef struct {
+    int16_t values[MQTT_NAMES_COUNT];
+    int16_t mode;
+} mqtt_snapshot_t;
+
+// Latest-wins snapshot queue (length 1, written with xQueueOverwrite)
+static QueueHandle_t mqtt_snapshot_queue = NULL;
+static TaskHandle_t mqtt_publish_task_handle = NULL;
+static mqtt_publish_stats_t mqtt_stats = {0};
+
+static void mqtt_publish_task(void *arg);
+
+// Longest formatted value: "-327.68"
+#define MQTT_VALUE_MAX_LEN 8
+
 
 
 
 // Remove unused define
 // #define MQTT_BROKER_PORT 1883
 
-// Task handle for publishing (removed - publishing now happens after decoding)
 
 /**
  * @brief Generate unique client ID from MAC address
@@ -228,6 +281,7 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
         case MQTT_EVENT_CONNECTED:
             ESP_LOGI(TAG, "MQTT Connected");
             mqtt_connected = true;
+            mqtt_resync_pending = true;
             // Subscribe to any topics if needed
             break;
 
@@ -277,7 +331,140 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base, int32_
     }
 }
 
-// Periodic publish task removed - publishing now happens after data decoding in protocol.c
+/**
+ * @brief Check if register holds a temperature scaled by 100
+ */
+static bool mqtt_is_centi_register(uint16_t reg_addr) {
+    switch (reg_addr) {
+        case MB_INPUT_MAIN_INLET_TEMP:
+        case MB_INPUT_MAIN_OUTLET_TEMP:
+        case MB_INPUT_ADC_NTC1:
+        case MB_INPUT_ADC_NTC2:
+        case MB_INPUT_DS18B20_TEMP:
+        case MB_INPUT_DS18B20_TEMP2:
+        case MB_INPUT_DS18B20_TEMP3:
+        case MB_INPUT_DS18B20_TEMP4:
+        case MB_INPUT_DS18B20_TEMP5:
+        case MB_INPUT_DS18B20_TEMP6:
+        case MB_INPUT_DS18B20_TEMP7:
+        case MB_INPUT_DS18B20_TEMP8:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Get deadband for a topic in raw register units
+ * @return 0 if any change must be published
+ */
+static int32_t mqtt_get_deadband(const mqtt_name_t *entry) {
+    switch (entry->subtopic) {
+        case MQTT_SUB_TEMP:
+            return mqtt_is_centi_register(entry->reg_addr) ?
+                   CONFIG_MQTT_DEADBAND_TEMP_CENTI : CONFIG_MQTT_DEADBAND_TEMP_CENTI / 100;
+        case MQTT_SUB_POWER:
+            return CONFIG_MQTT_DEADBAND_POWER_W;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Format register value as decimal text without printf
+ * @param raw Register value
+ * @param centi Value is scaled by 100 and gets two fraction digits
+ * @param buf Output buffer, at least MQTT_VALUE_MAX_LEN bytes
+ * @return Length of the text
+ */
+static size_t mqtt_format_value(int16_t raw, bool centi, char *buf) {
+    char digits[MQTT_VALUE_MAX_LEN];
+    size_t n = 0;
+    size_t len = 0;
+    uint32_t mag = (raw < 0) ? (uint32_t)(-(int32_t)raw) : (uint32_t)raw;
+
+    if (centi) {
+        digits[n++] = (char)('0' + mag % 10);
+        mag /= 10;
+        digits[n++] = (char)('0' + mag % 10);
+        mag /= 10;
+        digits[n++] = '.';
+    }
+    do {
+        digits[n++] = (char)('0' + mag % 10);
+        mag /= 10;
+    } while (mag != 0);
+
+    if (raw < 0) {
+        buf[len++] = '-';
+    }
+    while (n > 0) {
+        buf[len++] = digits[--n];
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+/**
+ * @brief Append "<a>/<b>[/<c>]" to the topic pool
+ */
+static size_t mqtt_pool_append(char *pool, size_t pos, const char *a, const char *b, const char *c) {
+    const char *parts[3] = {a, b, c};
+    for (size_t i = 0; i < 3 && parts[i] != NULL; i++) {
+        if (i > 0) {
+            pool[pos++] = '/';
+        }
+        size_t len = strlen(parts[i]);
+        memcpy(&pool[pos], parts[i], len);
+        pos += len;
+    }
+    pool[pos++] = '\0';
+    return pos;
+}
+
+/**
+ * @brief Build the interned topic table for the given base
+ */
+static esp_err_t mqtt_build_topic_table(const char *base) {
+    size_t base_len = strlen(base);
+    size_t total = base_len + 1 + strlen(CONFIG_MQTT_STATE_TOPIC) + 1;
+    for (size_t i = 0; i < MQTT_NAMES_COUNT; i++) {
+        total += base_len + 1 + strlen(mqtt_subtopics[mqtt_names[i].subtopic]) + 1 + strlen(mqtt_names[i].name) + 1;
+    }
+    if (total > UINT16_MAX) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    char *pool = malloc(total);
+    if (pool == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    uint16_t offsets[MQTT_NAMES_COUNT];
+    size_t pos = 0;
+    for (size_t i = 0; i < MQTT_NAMES_COUNT; i++) {
+        offsets[i] = (uint16_t)pos;
+        pos = mqtt_pool_append(pool, pos, base, mqtt_subtopics[mqtt_names[i].subtopic], mqtt_names[i].name);
+    }
+    uint16_t state_offset = (uint16_t)pos;
+    mqtt_pool_append(pool, pos, base, CONFIG_MQTT_STATE_TOPIC, NULL);
+
+    xSemaphoreTake(mqtt_topic_mutex, portMAX_DELAY);
+    char *old_pool = mqtt_topic_pool;
+    mqtt_topic_pool = pool;
+    memcpy(mqtt_topic_offsets, offsets, sizeof(offsets));
+    mqtt_state_topic_offset = state_offset;
+    for (size_t i = 0; i < MQTT_NAMES_COUNT; i++) {
+        mqtt_value_centi[i] = mqtt_is_centi_register(mqtt_names[i].reg_addr);
+    }
+    xSemaphoreGive(mqtt_topic_mutex);
+
+    free(old_pool);
+    ESP_LOGI(TAG, "Topic table built for base '%s' (%u bytes)", base, (unsigned)total);
+    return ESP_OK;
+}
+
+// Publishing runs in mqtt_publish_task, fed with snapshots taken after each decode
 
 /**
  * @brief Initialize MQTT client
@@ -288,6 +475,37 @@ esp_err_t mqtt_client_init(void) {
         return ESP_OK;
     }
 
+    if (mqtt_topic_mutex == NULL) {
+        mqtt_topic_mutex = xSemaphoreCreateMutex();
+        if (mqtt_topic_mutex == NULL) {
+            ESP_LOGE(TAG, "Failed to create topic table mutex");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    esp_err_t ret = mqtt_build_topic_table(mqtt_topic_base);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to build topic table: %s", esp_err_to_name(ret));
+        return ret;
+    }
+
+    if (mqtt_snapshot_queue == NULL) {
+        mqtt_snapshot_queue = xQueueCreate(1, sizeof(mqtt_snapshot_t));
+        if (mqtt_snapshot_queue == NULL) {
+            ESP_LOGE(TAG, "Failed to create snapshot queue");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    if (mqtt_publish_task_handle == NULL) {
+        BaseType_t task_ret = xTaskCreate(mqtt_publish_task, "mqtt_pub", CONFIG_MQTT_PUBLISH_TASK_STACK, NULL,
+                                          CONFIG_MQTT_PUBLISH_TASK_PRIORITY, &mqtt_publish_task_handle);
+        if (task_ret != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create MQTT publisher task");
+            return ESP_FAIL;
+        }
+    }
+
     // Generate unique client ID
     char client_id[MQTT_CLIENT_ID_MAX_LEN];
     mqtt_generate_client_id(client_id, sizeof(client_id));
@@ -322,13 +540,17 @@ esp_err_t mqtt_client_start(void) {
         return ESP_ERR_INVALID_STATE;
     }
 
+    if (mqtt_started) {
+        return ESP_OK;
+    }
     esp_err_t ret = esp_mqtt_client_start(mqtt_client);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to start MQTT client: %s", esp_err_to_name(ret));
         return ret;
     }
+    mqtt_started = true;
 
-    // Publish task removed - publishing now happens after data decoding in protocol.c
+    // Publisher task was created in mqtt_client_init() and idles until connected
     ESP_LOGI(TAG, "MQTT client started (publishing on decode events)");
     return ESP_OK;
 }
@@ -337,22 +559,56 @@ esp_err_t mqtt_client_start(void) {
  * @brief Stop MQTT client
  */
 esp_err_t mqtt_client_stop(void) {
-    if (mqtt_client == NULL) {
+    if (mqtt_client == NULL || !mqtt_started) {
         return ESP_OK;
     }
 
-    // Publish task removed - no need to delete it
+    // Publisher task keeps running and drops snapshots while disconnected
 
     esp_err_t ret = esp_mqtt_client_stop(mqtt_client);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to stop MQTT client: %s", esp_err_to_name(ret));
     }
 
+    mqtt_started = false;
     mqtt_connected = false;
     ESP_LOGI(TAG, "MQTT client stopped");
     return ret;
 }
 
+/**
+ * @brief Update MQTT client state based on WiFi connection
+ * Not for the MQTT event task: esp_mqtt_client_stop() can't run there
+ */
+esp_err_t mqtt_client_update_wifi_state(void) {
+    if (wifi_connect_is_connected()) {
+        return mqtt_client_start();
+    }
+    return mqtt_client_stop();
+}
+
+/**
+ * @brief Change the topic base and rebuild the topic table
+ */
+esp_err_t mqtt_client_set_topic_base(const char *base) {
+    if (base == NULL || base[0] == '\0' || strlen(base) >= sizeof(mqtt_topic_base)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (mqtt_topic_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t ret = mqtt_build_topic_table(base);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to rebuild topic table: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    strcpy(mqtt_topic_base, base);
+    // Subscribers of the new base have not seen any value yet
+    mqtt_resync_pending = true;
+    return ESP_OK;
+}
+
 /**
  * @brief Check if MQTT client is connected
  */
@@ -383,23 +639,226 @@ static esp_err_t mqtt_publish_value(const char *topic, const char *value) {
 }
 
 /**
- * @brief Publish heat pump data to MQTT
+ * @brief Check if a value moved beyond its deadband since the last publish
  */
-esp_err_t mqtt_client_publish_data(void) {
-    if (!mqtt_connected || mqtt_client == NULL || !wifi_connect_is_connected()) {
-        return ESP_ERR_INVALID_STATE;
+static bool mqtt_value_changed(size_t index, int16_t current) {
+    if (!mqtt_last_valid[index]) {
+        return true;
     }
+    int32_t diff = (int32_t)current - mqtt_last_values[index];
+    if (diff < 0) {
+        diff = -diff;
+    }
+    return diff != 0 && diff >= mqtt_get_deadband(&mqtt_names[index]);
+}
 
-    char topic[128];
-    char value[32];
+/**
+ * @brief Publish changed values, one topic per value
+ * @param full_sync Publish every topic regardless of the deadband
+ */
+static esp_err_t mqtt_publish_topics(const int16_t *values, bool full_sync) {
+    char value[MQTT_VALUE_MAX_LEN];
     esp_err_t ret = ESP_OK;
-    const char *template_topic = "%s/%s/%s";
-    
-    for(size_t i = 0; i < sizeof(mqtt_names) / sizeof(mqtt_name_t); i++) {
-        snprintf(topic, sizeof(topic), template_topic, MQTT_TOPIC_BASE, mqtt_subtopics[mqtt_names[i].subtopic], mqtt_names[i].name);
-        snprintf(value, sizeof(value), "%d", mb_input_registers[mqtt_names[i].reg_addr]);
-        ret = mqtt_publish_value(topic, value) || ret;
+    size_t published = 0;
+
+    for (size_t i = 0; i < MQTT_NAMES_COUNT; i++) {
+        int16_t current = values[i];
+        if (!full_sync && !mqtt_value_changed(i, current)) {
+            continue;
+        }
+
+        mqtt_format_value(current, mqtt_value_centi[i], value);
+        esp_err_t err = mqtt_publish_value(&mqtt_topic_pool[mqtt_topic_offsets[i]], value);
+        if (err != ESP_OK) {
+            // Keep the old cached value so the topic is retried next cycle
+            ret = err;
+            continue;
+        }
+        mqtt_last_values[i] = current;
+        mqtt_last_valid[i] = true;
+        published++;
     }
 
+    ESP_LOGD(TAG, "Published %u of %u topics%s", (unsigned)published, (unsigned)MQTT_NAMES_COUNT,
+             full_sync ? " (full sync)" : "");
     return ret;
 }
+
+/**
+ * @brief Publish all values as one JSON document grouped by subtopic
+ *
+ * The document is only sent when at least one value moved beyond its
+ * deadband, but it always carries the complete state:
+ * {"sys":{"status":1,...},"temp":{"main_inlet":35.25,...},...}
+ */
+static esp_err_t mqtt_publish_json(const int16_t *values, bool full_sync) {
+    bool changed = full_sync;
+
+    for (size_t i = 0; i < MQTT_NAMES_COUNT && !changed; i++) {
+        changed = mqtt_value_changed(i, values[i]);
+    }
+    if (!changed) {
+        return ESP_OK;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    cJSON *groups[MQTT_SUBTOPICS_COUNT] = {0};
+
+    for (size_t i = 0; i < MQTT_NAMES_COUNT; i++) {
+        mqtt_subtopic_t sub = mqtt_names[i].subtopic;
+        if (groups[sub] == NULL) {
+            groups[sub] = cJSON_AddObjectToObject(root, mqtt_subtopics[sub]);
+            if (groups[sub] == NULL) {
+                cJSON_Delete(root);
+                return ESP_ERR_NO_MEM;
+            }
+        }
+        // mqtt_names[] lists a few registers twice, keep keys unique
+        if (cJSON_GetObjectItem(groups[sub], mqtt_names[i].name) == NULL) {
+            char value[MQTT_VALUE_MAX_LEN];
+            mqtt_format_value(values[i], mqtt_value_centi[i], value);
+            cJSON_AddRawToObject(groups[sub], mqtt_names[i].name, value);
+        }
+    }
+
+    char *payload = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (payload == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    esp_err_t ret = mqtt_publish_value(&mqtt_topic_pool[mqtt_state_topic_offset], payload);
+    ESP_LOGD(TAG, "Published state document (%u bytes)%s", (unsigned)strlen(payload),
+             full_sync ? " (full sync)" : "");
+    cJSON_free(payload);
+
+    if (ret == ESP_OK) {
+        memcpy(mqtt_last_values, values, sizeof(mqtt_last_values));
+        for (size_t i = 0; i < MQTT_NAMES_COUNT; i++) {
+            mqtt_last_valid[i] = true;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Check whether the next publish must send every value
+ */
+static bool mqtt_full_sync_due(const mqtt_snapshot_t *snapshot) {
+    return mqtt_resync_pending || snapshot->mode != mqtt_last_mode ||
+           (esp_timer_get_time() - mqtt_last_full_sync_us) >= (int64_t)CONFIG_MQTT_FULL_RESYNC_INTERVAL_SEC * 1000000;
+}
+
+/**
+ * @brief Publish one snapshot (publisher task context)
+ *
+ * Only values that moved beyond the deadband since the last successful
+ * publish are sent. All values are sent after a (re)connect and every
+ * CONFIG_MQTT_FULL_RESYNC_INTERVAL_SEC seconds.
+ */
+static esp_err_t mqtt_publish_snapshot(const mqtt_snapshot_t *snapshot) {
+    int64_t now_us = esp_timer_get_time();
+    bool full_sync = mqtt_full_sync_due(snapshot);
+    mqtt_resync_pending = false;
+    mqtt_last_mode = snapshot->mode;
+
+    esp_err_t ret;
+    xSemaphoreTake(mqtt_topic_mutex, portMAX_DELAY);
+    if (snapshot->mode == MQTT_PAYLOAD_JSON) {
+        ret = mqtt_publish_json(snapshot->values, full_sync);
+    } else {
+        ret = mqtt_publish_topics(snapshot->values, full_sync);
+    }
+    xSemaphoreGive(mqtt_topic_mutex);
+
+    if (full_sync) {
+        if (ret == ESP_OK) {
+            mqtt_last_full_sync_us = now_us;
+        } else {
+            mqtt_resync_pending = true;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Publisher task: waits for snapshots and publishes the latest one
+ *
+ * Unchanged frames are not submitted, so while idle the task republishes
+ * the last snapshot when a full resync is due (reconnect, payload mode
+ * change or heartbeat interval).
+ */
+static void mqtt_publish_task(void *arg) {
+    static mqtt_snapshot_t snapshot;
+    bool have_snapshot = false;
+
+    while (1) {
+        if (xQueueReceive(mqtt_snapshot_queue, &snapshot, pdMS_TO_TICKS(MQTT_PUBLISH_IDLE_CHECK_MS)) != pdTRUE) {
+            if (!have_snapshot || !mqtt_connected || !wifi_connect_is_connected()) {
+                continue;
+            }
+            snapshot.mode = mb_holding_registers[MB_HOLDING_MQTT_PAYLOAD_MODE - MB_REG_HOLDING_START];
+            if (!mqtt_full_sync_due(&snapshot)) {
+                continue;
+            }
+        }
+        have_snapshot = true;
+        if (!mqtt_connected || !wifi_connect_is_connected()) {
+            __atomic_fetch_add(&mqtt_stats.dropped, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+        int64_t start_us = esp_timer_get_time();
+        esp_err_t ret = mqtt_publish_snapshot(&snapshot);
+        metrics_hist_observe(&mqtt_stats.batch_time, esp_timer_get_time() - start_us);
+        if (ret == ESP_OK) {
+            mqtt_stats.published++;
+        } else {
+            mqtt_stats.failed++;
+        }
+    }
+}
+
+/**
+ * @brief Queue a register snapshot for the publisher task
+ *
+ * Never blocks: the queue holds one snapshot and a newer one replaces
+ * a snapshot the publisher has not picked up yet.
+ */
+esp_err_t mqtt_client_publish_data(void) {
+    if (mqtt_client == NULL || mqtt_snapshot_queue == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!mqtt_connected) {
+        // Frames decoded during an outage are never published
+        __atomic_fetch_add(&mqtt_stats.dropped, 1, __ATOMIC_RELAXED);
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Large enough to keep off the caller's stack. Only the protocol task
+    // submits, right after modbus_params_commit_inputs(), and it is the only
+    // task that commits, so the copy below always sees a single frame.
+    static mqtt_snapshot_t snapshot;
+    for (size_t i = 0; i < MQTT_NAMES_COUNT; i++) {
+        snapshot.values[i] = mb_input_registers[mqtt_names[i].reg_addr];
+    }
+    snapshot.mode = mb_holding_registers[MB_HOLDING_MQTT_PAYLOAD_MODE - MB_REG_HOLDING_START];
+
+    if (uxQueueMessagesWaiting(mqtt_snapshot_queue) > 0) {
+        mqtt_stats.coalesced++;
+    }
+    xQueueOverwrite(mqtt_snapshot_queue, &snapshot);
+    mqtt_stats.submitted++;
+    return ESP_OK;
+}
+
+/**
+ * @brief Get publisher statistics
+ */
+void mqtt_client_get_stats(mqtt_publish_stats_t *stats) {
+    if (stats != NULL) {
+        *stats = mqtt_stats;
+    }
+}
@@ -15,6 +15,10 @@ static bool nvs_ready = false;
 #define MODBUS_NVS_KEY_SLAVE_ID    "slave"
 #define MODBUS_NVS_KEY_OPT_PCB     "opt_pcb"
 #define MODBUS_NVS_KEY_MQTT_PUBLISH "mqtt_pub"
+#define MODBUS_NVS_KEY_MQTT_MODE   "mqtt_mode"
+#define MODBUS_NVS_KEY_REMAP       "remap"
+#define MODBUS_NVS_KEY_WARM_CACHE  "warm"
+#define MODBUS_NVS_KEY_POLL_LIMITS "poll"
 
 esp_err_t modbus_nvs_init(void) {
     if (nvs_ready) {
@@ -234,3 +238,218 @@ esp_err_t modbus_nvs_save_mqtt_publish(uint8_t value) {
     return err;
 }
 
+esp_err_t modbus_nvs_load_mqtt_payload_mode(uint8_t *value) {
+    if (value == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = modbus_nvs_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_handle_t handle;
+    err = nvs_open(MODBUS_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return (err == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : err;
+    }
+
+    err = nvs_get_u8(handle, MODBUS_NVS_KEY_MQTT_MODE, value);
+    nvs_close(handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        err = ESP_ERR_NOT_FOUND;
+    }
+    return err;
+}
+
+esp_err_t modbus_nvs_save_mqtt_payload_mode(uint8_t value) {
+    esp_err_t err = modbus_nvs_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_handle_t handle;
+    err = nvs_open(MODBUS_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS namespace '%s': %s", MODBUS_NVS_NAMESPACE, esp_err_to_name(err));
+        return err;
+    }
+
+    err = nvs_set_u8(handle, MODBUS_NVS_KEY_MQTT_MODE, value);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to persist MQTT payload mode: %s", esp_err_to_name(err));
+    }
+    nvs_close(handle);
+    return err;
+}
+
+esp_err_t modbus_nvs_load_remap(uint16_t *sources, size_t count) {
+    if (sources == NULL || count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = modbus_nvs_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_handle_t handle;
+    err = nvs_open(MODBUS_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return (err == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : err;
+    }
+
+    size_t size = count * sizeof(uint16_t);
+    err = nvs_get_blob(handle, MODBUS_NVS_KEY_REMAP, sources, &size);
+    nvs_close(handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        err = ESP_ERR_NOT_FOUND;
+    } else if (err == ESP_OK && size != count * sizeof(uint16_t)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    return err;
+}
+
+esp_err_t modbus_nvs_save_remap(const uint16_t *sources, size_t count) {
+    if (sources == NULL || count == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = modbus_nvs_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_handle_t handle;
+    err = nvs_open(MODBUS_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS namespace '%s': %s", MODBUS_NVS_NAMESPACE, esp_err_to_name(err));
+        return err;
+    }
+
+    err = nvs_set_blob(handle, MODBUS_NVS_KEY_REMAP, sources, count * sizeof(uint16_t));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to persist remap window: %s", esp_err_to_name(err));
+    }
+    nvs_close(handle);
+    return err;
+}
+
+esp_err_t modbus_nvs_load_warm_cache(void *cache, size_t size) {
+    if (cache == NULL || size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = modbus_nvs_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_handle_t handle;
+    err = nvs_open(MODBUS_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return (err == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : err;
+    }
+
+    // A blob of another size was written by a firmware with another register map
+    size_t stored = size;
+    err = nvs_get_blob(handle, MODBUS_NVS_KEY_WARM_CACHE, cache, &stored);
+    nvs_close(handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        err = ESP_ERR_NOT_FOUND;
+    } else if (err == ESP_ERR_NVS_INVALID_LENGTH || (err == ESP_OK && stored != size)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    return err;
+}
+
+esp_err_t modbus_nvs_save_warm_cache(const void *cache, size_t size) {
+    if (cache == NULL || size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = modbus_nvs_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_handle_t handle;
+    err = nvs_open(MODBUS_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS namespace '%s': %s", MODBUS_NVS_NAMESPACE, esp_err_to_name(err));
+        return err;
+    }
+
+    err = nvs_set_blob(handle, MODBUS_NVS_KEY_WARM_CACHE, cache, size);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to persist warm-start cache: %s", esp_err_to_name(err));
+    }
+    nvs_close(handle);
+    return err;
+}
+
+esp_err_t modbus_nvs_load_poll_limits(uint16_t *min_sec, uint16_t *max_sec) {
+    if (min_sec == NULL || max_sec == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = modbus_nvs_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_handle_t handle;
+    err = nvs_open(MODBUS_NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return (err == ESP_ERR_NVS_NOT_FOUND) ? ESP_ERR_NOT_FOUND : err;
+    }
+
+    uint16_t limits[2];
+    size_t size = sizeof(limits);
+    err = nvs_get_blob(handle, MODBUS_NVS_KEY_POLL_LIMITS, limits, &size);
+    nvs_close(handle);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        err = ESP_ERR_NOT_FOUND;
+    } else if (err == ESP_OK && size != sizeof(limits)) {
+        err = ESP_ERR_INVALID_SIZE;
+    }
+    if (err == ESP_OK) {
+        *min_sec = limits[0];
+        *max_sec = limits[1];
+    }
+    return err;
+}
+
+esp_err_t modbus_nvs_save_poll_limits(uint16_t min_sec, uint16_t max_sec) {
+    esp_err_t err = modbus_nvs_init();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    nvs_handle_t handle;
+    err = nvs_open(MODBUS_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS namespace '%s': %s", MODBUS_NVS_NAMESPACE, esp_err_to_name(err));
+        return err;
+    }
+
+    uint16_t limits[2] = { min_sec, max_sec };
+    err = nvs_set_blob(handle, MODBUS_NVS_KEY_POLL_LIMITS, limits, sizeof(limits));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to persist poll limits: %s", esp_err_to_name(err));
+    }
+    nvs_close(handle);
+    return err;
+}
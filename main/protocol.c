@@ -7,14 +7,18 @@
 
 #include "protocol.h"
 #include "decoder.h"
+#include "frame_capture.h"
 #include "modbus_params.h"
 #include "modbus_slave.h"
+#include "http_server.h"
 #include "include/mqtt_pub.h"
 #include "esp_log.h"
 #include "driver/uart.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 #include "include/hpc.h"
+#include "include/project_config.h"
+#include "esp_timer.h"
 #include "string.h"
 #include "stdlib.h"
 
@@ -26,6 +30,51 @@ protocol_rx_t g_protocol_rx = {0};
 // Global protocol context
 protocol_context_t g_protocol_ctx = {0};
 
+// Statistics, written by the protocol task only
+static protocol_stats_t protocol_stats = {0};
+
+// Last valid frame of one block type, used to find the bytes that changed
+typedef struct {
+    uint8_t data[PROTOCOL_MAX_DATA_SIZE];
+    size_t len;
+} protocol_frame_cache_t;
+
+static protocol_frame_cache_t protocol_prev_main = {0};
+static protocol_frame_cache_t protocol_prev_extra = {0};
+static protocol_frame_cache_t protocol_prev_opt = {0};
+
+// Set after a write is sent: re-sync holding registers from the next main frame
+// even if it is unchanged, so a rejected write does not stay in the holding area
+static bool protocol_holding_sync_pending = false;
+static bool protocol_mqtt_was_enabled = false;
+
+// Adaptive poll schedule of one block. The interval adapts to the decoded
+// frames; the limits are read from the holding registers at every use so a
+// change applies to the next poll.
+typedef struct {
+    TickType_t last_due;        // Scheduled time of the last query
+    uint32_t interval_ms;
+    bool started;
+} protocol_poll_slot_t;
+
+static protocol_poll_slot_t protocol_poll[PROTOCOL_BLOCK_COUNT] = {
+    [PROTOCOL_BLOCK_MAIN] = { .interval_ms = PROTOCOL_QUERY_INTERVAL_MS },
+    [PROTOCOL_BLOCK_EXTRA] = { .interval_ms = PROTOCOL_QUERY_INTERVAL_MS },
+    [PROTOCOL_BLOCK_OPT] = { .interval_ms = PROTOCOL_QUERY_INTERVAL_MS },
+};
+
+// Main frame state that marks a transition worth polling fast
+typedef struct {
+    bool valid;
+    bool compressor_on;
+    int16_t three_way_valve;
+    int16_t heatpump_state;
+    int16_t operating_mode;
+} protocol_poll_state_t;
+
+static protocol_poll_state_t protocol_poll_prev = {0};
+static uint32_t protocol_poll_fast_left = 0;
+
 // Protocol command templates
 static const uint8_t initial_query[] = {0x31, 0x05, 0x10, 0x01, 0x00, 0x00, 0x00};
 
@@ -85,20 +134,20 @@ bool protocol_validate_checksum(const uint8_t *data, size_t size) {
  * @return ESP_OK on success
  */
 static esp_err_t protocol_uart_send(const uint8_t *data, size_t size) {
-    // Calculate checksum
-    uint8_t checksum = protocol_calculate_checksum(data, size);
-    
-    // Send data first
-    int bytes_written = uart_write_bytes(PROTOCOL_UART_NUM, data, size);
-    if (bytes_written != size) {
-        ESP_LOGE(TAG, "Failed to write data bytes: %d/%d", bytes_written, size);
-        return ESP_FAIL;
+    uint8_t frame[PROTOCOL_WRITE_SIZE + 1];
+    if (size > PROTOCOL_WRITE_SIZE) {
+        ESP_LOGE(TAG, "Command too long: %d bytes", size);
+        return ESP_ERR_INVALID_SIZE;
     }
-    
-    // Send checksum separately
-    int checksum_written = uart_write_bytes(PROTOCOL_UART_NUM, &checksum, 1);
-    if (checksum_written != 1) {
-        ESP_LOGE(TAG, "Failed to write checksum: %d/1", checksum_written);
+
+    // Frame with checksum in one write, recorded exactly as sent
+    memcpy(frame, data, size);
+    frame[size] = protocol_calculate_checksum(data, size);
+    frame_capture_add(FRAME_CAPTURE_TX, 0, frame, size + 1);
+
+    int bytes_written = uart_write_bytes(PROTOCOL_UART_NUM, frame, size + 1);
+    if (bytes_written != size + 1) {
+        ESP_LOGE(TAG, "Failed to write data bytes: %d/%d", bytes_written, size + 1);
         return ESP_FAIL;
     }
     
@@ -106,14 +155,113 @@ static esp_err_t protocol_uart_send(const uint8_t *data, size_t size) {
 }
 
 /**
- * @brief Receive data via UART
- * @param data Buffer to store received data
- * @param max_size Maximum buffer size
- * @param timeout_ms Timeout in milliseconds
- * @return Number of bytes received
+ * @brief Drop stale RX bytes and UART events before a new request
+ */
+static void protocol_uart_discard_input(void) {
+    uart_flush_input(PROTOCOL_UART_NUM);
+    xQueueReset(g_protocol_ctx.uart_event_queue);
+}
+
+/**
+ * @brief Check if byte can start a response frame
+ */
+static bool protocol_is_frame_header(uint8_t byte) {
+    return byte == PROTOCOL_PKT_READ || byte == PROTOCOL_PKT_INIT;
+}
+
+/**
+ * @brief Feed received bytes into the frame assembler
+ * @param rx Frame being assembled
+ * @param data Received bytes
+ * @param size Number of received bytes
+ * @return true when rx holds a complete frame (data[1] + 3 bytes)
+ */
+static bool protocol_frame_feed(protocol_rx_t *rx, const uint8_t *data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        // Resync: a frame can only start with a response header
+        if (rx->len == 0 && !protocol_is_frame_header(data[i])) {
+            continue;
+        }
+        rx->data[rx->len++] = data[i];
+
+        if (rx->len >= 2) {
+            size_t expected = (size_t)rx->data[1] + PROTOCOL_FRAME_OVERHEAD;
+            if (expected > sizeof(rx->data)) {
+                ESP_LOGW(TAG, "Frame length %u exceeds buffer, resyncing", (unsigned)expected);
+                rx->len = 0;
+                continue;
+            }
+            if (rx->len == expected) {
+                // Anything after the frame belongs to no request and is dropped
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Receive one response frame, driven by UART events
+ *
+ * Completes as soon as the last byte announced by the length byte arrives
+ * instead of waiting for the full read timeout.
+ * @param rx Output frame
+ * @return ESP_OK on complete frame, ESP_ERR_TIMEOUT if nothing arrived,
+ *         ESP_ERR_INVALID_SIZE on incomplete frame, ESP_FAIL on RX overflow
  */
-static int protocol_uart_receive(uint8_t *data, size_t max_size) {
-    return uart_read_bytes(PROTOCOL_UART_NUM, data, max_size, pdMS_TO_TICKS(PROTOCOL_READ_TIMEOUT_MS));
+static esp_err_t protocol_uart_receive_frame(protocol_rx_t *rx) {
+    const TickType_t deadline = xTaskGetTickCount() + pdMS_TO_TICKS(PROTOCOL_READ_TIMEOUT_MS);
+    uint8_t chunk[64];
+    uart_event_t event;
+
+    rx->len = 0;
+    while (1) {
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = ((int32_t)(deadline - now) > 0) ? (deadline - now) : 0;
+        if (xQueueReceive(g_protocol_ctx.uart_event_queue, &event, wait) != pdTRUE) {
+            break;
+        }
+
+        switch (event.type) {
+            case UART_DATA: {
+                size_t pending = event.size;
+                while (pending > 0) {
+                    size_t to_read = pending < sizeof(chunk) ? pending : sizeof(chunk);
+                    int got = uart_read_bytes(PROTOCOL_UART_NUM, chunk, to_read, 0);
+                    if (got <= 0) {
+                        break;
+                    }
+                    pending -= (size_t)got;
+                    if (protocol_frame_feed(rx, chunk, (size_t)got)) {
+                        return ESP_OK;
+                    }
+                }
+                break;
+            }
+
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                ESP_LOGW(TAG, "UART RX overflow (event %d), dropping frame", event.type);
+                protocol_uart_discard_input();
+                rx->len = 0;
+                return ESP_FAIL;
+
+            case UART_PARITY_ERR:
+            case UART_FRAME_ERR:
+                ESP_LOGW(TAG, "UART line error (event %d)", event.type);
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    if (rx->len == 0) {
+        return ESP_ERR_TIMEOUT;
+    }
+    ESP_LOGW(TAG, "Incomplete frame: received %u of %u bytes", (unsigned)rx->len,
+             (unsigned)(rx->len >= 2 ? rx->data[1] + PROTOCOL_FRAME_OVERHEAD : 0));
+    return ESP_ERR_INVALID_SIZE;
 }
 
 // Вспомогательная функция мини дампа массива uint8_t длиной 256 байт (16 строк по 16 байт)
@@ -135,65 +283,251 @@ static void mini_dump(const uint8_t *data) {
     }
 }
 
+/**
+ * @brief Compare a frame with the previous one of its type and remember it
+ * @param prev Previous frame of the same block type
+ * @param data New frame
+ * @param size New frame size
+ * @param changed Optional changed-byte bitmap output (all bits set if there is no previous frame)
+ * @return true if any byte changed
+ */
+static bool protocol_frame_diff(protocol_frame_cache_t *prev, const uint8_t *data, size_t size, uint32_t *changed) {
+    bool any = false;
+
+    if (prev->len != size) {
+        if (changed != NULL) {
+            memset(changed, 0xFF, PROTOCOL_FRAME_BITMAP_WORDS * sizeof(uint32_t));
+        }
+        any = true;
+    } else {
+        if (changed != NULL) {
+            memset(changed, 0, PROTOCOL_FRAME_BITMAP_WORDS * sizeof(uint32_t));
+        }
+        for (size_t i = 0; i < size; i++) {
+            if (prev->data[i] != data[i]) {
+                if (changed == NULL) {
+                    any = true;
+                    break;
+                }
+                changed[i >> 5] |= 1u << (i & 31);
+                any = true;
+            }
+        }
+    }
+
+    if (any) {
+        memcpy(prev->data, data, size);
+        prev->len = size;
+    } else {
+        protocol_stats.frames_unchanged++;
+    }
+    return any;
+}
+
+/**
+ * @brief Poll interval limits from the holding registers
+ */
+static void protocol_poll_limits(uint32_t *min_ms, uint32_t *max_ms) {
+    int32_t min_s = mb_holding_registers[MB_HOLDING_POLL_MIN_SEC - MB_REG_HOLDING_START];
+    int32_t max_s = mb_holding_registers[MB_HOLDING_POLL_MAX_SEC - MB_REG_HOLDING_START];
+    if (min_s < PROTOCOL_POLL_LIMIT_MIN_SEC || min_s > MB_POLL_LIMIT_MAX_SEC) {
+        min_s = CONFIG_PROTOCOL_POLL_MIN_SEC;
+    }
+    if (max_s < PROTOCOL_POLL_LIMIT_MIN_SEC || max_s > MB_POLL_LIMIT_MAX_SEC) {
+        max_s = CONFIG_PROTOCOL_POLL_MAX_SEC;
+    }
+    if (max_s < min_s) {
+        max_s = min_s;
+    }
+    *min_ms = (uint32_t)min_s * 1000;
+    *max_ms = (uint32_t)max_s * 1000;
+}
+
+static uint32_t protocol_poll_clamp(uint32_t interval_ms, uint32_t min_ms, uint32_t max_ms) {
+    if (interval_ms < min_ms) {
+        return min_ms;
+    }
+    return interval_ms > max_ms ? max_ms : interval_ms;
+}
+
+static void protocol_poll_set_interval(protocol_block_t block, uint32_t interval_ms) {
+    protocol_poll[block].interval_ms = interval_ms;
+    protocol_stats.poll_interval_ms[block] = interval_ms;
+}
+
+/**
+ * @brief Adapt the main poll interval to a decoded main frame
+ * Transitions (defrost, compressor start/stop, DHW valve, on/off, mode)
+ * poll at the minimum for PROTOCOL_POLL_FAST_POLLS frames. Otherwise busy
+ * frames halve the interval and quiet ones stretch it by half, up to
+ * PROTOCOL_QUERY_INTERVAL_MS while the compressor runs and up to the
+ * maximum in standby.
+ * @param updated Registers the frame changed
+ */
+static void protocol_poll_adapt_main(size_t updated) {
+    const int16_t *regs = mb_input_registers_back;
+    protocol_poll_state_t state = {
+        .valid = true,
+        .compressor_on = regs[MB_INPUT_COMPRESSOR_FREQ] > 0,
+        .three_way_valve = regs[MB_INPUT_THREE_WAY_VALVE_STATE],
+        .heatpump_state = regs[MB_INPUT_HEATPUMP_STATE],
+        .operating_mode = regs[MB_INPUT_OPERATING_MODE_STATE],
+    };
+    bool defrosting = regs[MB_INPUT_DEFROSTING_STATE] == 1;
+    bool first = !protocol_poll_prev.valid;
+    bool transition = !first &&
+        (state.compressor_on != protocol_poll_prev.compressor_on ||
+         state.three_way_valve != protocol_poll_prev.three_way_valve ||
+         state.heatpump_state != protocol_poll_prev.heatpump_state ||
+         state.operating_mode != protocol_poll_prev.operating_mode);
+    protocol_poll_prev = state;
+    if (first && !defrosting) {
+        // Every register changes with the first frame; nothing to learn from it
+        return;
+    }
+
+    if (transition) {
+        protocol_stats.poll_transitions++;
+    }
+    if (transition || defrosting) {
+        protocol_poll_fast_left = PROTOCOL_POLL_FAST_POLLS;
+    }
+
+    uint32_t min_ms, max_ms;
+    protocol_poll_limits(&min_ms, &max_ms);
+    uint32_t interval = protocol_poll[PROTOCOL_BLOCK_MAIN].interval_ms;
+    if (protocol_poll_fast_left > 0) {
+        protocol_poll_fast_left--;
+        interval = min_ms;
+    } else if (updated > PROTOCOL_POLL_BUSY_REGS) {
+        interval /= 2;
+    } else if (updated <= PROTOCOL_POLL_QUIET_REGS) {
+        uint32_t ceiling = state.compressor_on ? protocol_poll_clamp(PROTOCOL_QUERY_INTERVAL_MS, min_ms, max_ms) : max_ms;
+        uint32_t stretched = interval < 1000 ? 1000 : interval + interval / 2;
+        interval = stretched < ceiling ? stretched : ceiling;
+    }
+    protocol_poll_set_interval(PROTOCOL_BLOCK_MAIN, protocol_poll_clamp(interval, min_ms, max_ms));
+}
+
+/**
+ * @brief Adapt the extra/opt poll interval to a decoded frame
+ * A changed frame brings the block back to PROTOCOL_QUERY_INTERVAL_MS, an
+ * unchanged one doubles the interval up to the maximum.
+ */
+static void protocol_poll_adapt_block(protocol_block_t block, bool frame_changed) {
+    uint32_t min_ms, max_ms;
+    protocol_poll_limits(&min_ms, &max_ms);
+    uint32_t interval = protocol_poll[block].interval_ms;
+    if (frame_changed) {
+        interval = PROTOCOL_QUERY_INTERVAL_MS;
+    } else {
+        interval = interval < 1000 ? 1000 : interval * 2;
+    }
+    protocol_poll_set_interval(block, protocol_poll_clamp(interval, min_ms, max_ms));
+}
+
+/**
+ * @brief Publish the decoded registers and queue the dashboard delta push
+ */
+static void protocol_commit_inputs(void) {
+    modbus_params_commit_inputs();
+    http_server_notify_inputs();
+}
+
 /**
  * @brief Process received data
+ * Validates, decodes and publishes one received frame
  * @param data Received data
  * @param size Data size
  * @return ESP_OK on success
  */
-static esp_err_t protocol_process_received_data(const uint8_t *data, size_t size) {
+esp_err_t protocol_process_received_data(const uint8_t *data, size_t size) {
 
     // mini_dump(data);
     // Validate data size
     if (size < 3) {
         ESP_LOGW(TAG, "Received data too short: %d bytes", size);
+        protocol_stats.rx_bad_size++;
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (size > PROTOCOL_MAX_DATA_SIZE) {
+        ESP_LOGW(TAG, "Received data too long: %d bytes", size);
+        protocol_stats.rx_bad_size++;
         return ESP_ERR_INVALID_SIZE;
     }
 
     // Validate data size
     if(data[1] + 3 != size) {
         ESP_LOGW(TAG, "Received data size mismatch: received %d bytes, expected: %d bytes", size, data[1] + 3);
+        protocol_stats.rx_bad_size++;
         return ESP_ERR_INVALID_SIZE;
     }
 
     // Validate header
     if (data[0] != PROTOCOL_PKT_READ && data[0] != PROTOCOL_PKT_INIT) {
         ESP_LOGW(TAG, "Invalid header: 0x%02X", data[0]);
+        protocol_stats.rx_bad_header++;
         return ESP_ERR_INVALID_ARG;
     }
 
     // Validate checksum
     if (!protocol_validate_checksum(data, size)) {
         ESP_LOGW(TAG, "Checksum validation failed");
+        protocol_stats.rx_bad_checksum++;
         return ESP_ERR_INVALID_CRC;
     }
 
     ESP_LOGI(TAG, "Received valid data: %d bytes, header: 0x%02X", size, data[0]);
 
+    // The decoder reads the global RX buffer
+    if (data != g_protocol_rx.data) {
+        memcpy(g_protocol_rx.data, data, size);
+        g_protocol_rx.len = size;
+    }
+
+    int64_t decode_start_us = esp_timer_get_time();
+    int block = -1;
+
     // Process based on data type
     if (size == PROTOCOL_MAIN_DATA_SIZE && data[3] == PROTOCOL_DATA_MAIN) {
         ESP_LOGI(TAG, "Received main data block");
+        block = PROTOCOL_BLOCK_MAIN;
         
         //do we have valid header and byte 0xc7 is more or equal 3 then assume K&L and more series
         if (!g_protocol_ctx.extra_data_block_available) {
             if ((data[0] == PROTOCOL_PKT_READ) && (data[0xC7] >= 3)) g_protocol_ctx.extra_data_block_available = true;
         }
       
+        uint32_t changed[PROTOCOL_FRAME_BITMAP_WORDS];
+        bool frame_changed = protocol_frame_diff(&protocol_prev_main, data, size, changed);
+      
         // Reset extended data flag when main data is received
-        mb_input_registers[MB_INPUT_EXTENDED_DATA] = 0;
+        bool flag_changed = mb_input_registers_back[MB_INPUT_EXTENDED_DATA] != 0;
+        mb_input_registers_back[MB_INPUT_EXTENDED_DATA] = 0;
       
-        // Decode main data
-        esp_err_t decode_ret = decode_main_data();
+        // Decode only the fields whose bytes changed
+        size_t updated = 0;
+        esp_err_t decode_ret = frame_changed ? decode_main_data_changed(changed, &updated) : ESP_OK;
         if (decode_ret == ESP_OK) {
-            ESP_LOGI(TAG, "Main data decoded successfully");
+            ESP_LOGI(TAG, "Main data decoded successfully, %d registers changed", (int)updated);
+            hpc_boot_mark(HPC_BOOT_FIRST_FRAME);
+            // The first frame replaces the snapshot restored at boot
+            bool was_stale = modbus_params_mark_inputs_fresh();
+            if (updated > 0 || flag_changed || was_stale) {
+                // Publish the decoded frame to Modbus/HTTP/MQTT readers in one step
+                protocol_commit_inputs();
+                modbus_params_save_warm_cache();
+            }
+            protocol_poll_adapt_main(updated);
             // Sync holding registers with current decoded values
-            modbus_params_sync_holding_from_input();
-            // Update shadow copy to prevent false change detection
-            modbus_slave_update_shadow_copy();
+            if (updated > 0 || protocol_holding_sync_pending) {
+                modbus_params_sync_holding_from_input();
+                protocol_holding_sync_pending = false;
+            }
             // Log main data
             // log_main_data();
             
-            // Publish to MQTT if enabled and connected
+            // Hand a snapshot to the MQTT publisher task if enabled and connected
             if (mqtt_client_is_connected()) {
                 // Check if MQTT publishing is enabled via Modbus register
                 int32_t mqtt_index = MB_HOLDING_SET_MQTT_PUBLISH - MB_REG_HOLDING_START;
@@ -201,9 +535,13 @@ static esp_err_t protocol_process_received_data(const uint8_t *data, size_t size
                 if (mqtt_index >= 0 && mqtt_index < MB_REG_HOLDING_COUNT) {
                     publish_enabled = (mb_holding_registers[mqtt_index] != 0);
                 }
-                if (publish_enabled) {
+                // Unchanged registers are republished by the publisher task's resync
+                if (publish_enabled && (updated > 0 || !protocol_mqtt_was_enabled)) {
                     mqtt_client_publish_data();
                 }
+                protocol_mqtt_was_enabled = publish_enabled;
+            } else {
+                protocol_mqtt_was_enabled = false;
             }
         } else {
             ESP_LOGE(TAG, "Failed to decode main data: %s", esp_err_to_name(decode_ret));
@@ -211,14 +549,21 @@ static esp_err_t protocol_process_received_data(const uint8_t *data, size_t size
         
     } else if (size == PROTOCOL_EXTRA_DATA_SIZE && data[3] == PROTOCOL_DATA_EXTRA) {
         ESP_LOGI(TAG, "Received extra data block");
+        block = PROTOCOL_BLOCK_EXTRA;
         
         // Set extended data flag when extra data is received
-        mb_input_registers[MB_INPUT_EXTENDED_DATA] = 1;
+        bool flag_changed = mb_input_registers_back[MB_INPUT_EXTENDED_DATA] != 1;
+        mb_input_registers_back[MB_INPUT_EXTENDED_DATA] = 1;
         
         // Decode extra data
-        esp_err_t decode_ret = decode_extra_data();
+        bool frame_changed = protocol_frame_diff(&protocol_prev_extra, data, size, NULL);
+        esp_err_t decode_ret = frame_changed ? decode_extra_data() : ESP_OK;
         if (decode_ret == ESP_OK) {
             ESP_LOGI(TAG, "Extra data decoded successfully");
+            protocol_poll_adapt_block(PROTOCOL_BLOCK_EXTRA, frame_changed);
+            if (frame_changed || flag_changed) {
+                protocol_commit_inputs();
+            }
             // Log extra data
             // log_extra_data();
         } else {
@@ -227,11 +572,17 @@ static esp_err_t protocol_process_received_data(const uint8_t *data, size_t size
         
     } else if (size == PROTOCOL_OPT_DATA_SIZE && data[3] == PROTOCOL_DATA_OPT) {
         ESP_LOGI(TAG, "Received optional data block");
+        block = PROTOCOL_BLOCK_OPT;
         
         // Decode optional data
-        esp_err_t decode_ret = decode_opt_data();
+        bool frame_changed = protocol_frame_diff(&protocol_prev_opt, data, size, NULL);
+        esp_err_t decode_ret = frame_changed ? decode_opt_data() : ESP_OK;
         if (decode_ret == ESP_OK) {
             ESP_LOGI(TAG, "Optional data decoded successfully");
+            protocol_poll_adapt_block(PROTOCOL_BLOCK_OPT, frame_changed);
+            if (frame_changed) {
+                protocol_commit_inputs();
+            }
             // Log optional data
             // log_opt_data();
         } else {
@@ -240,72 +591,281 @@ static esp_err_t protocol_process_received_data(const uint8_t *data, size_t size
         
     } else if (size == PROTOCOL_HANDSHAKE_DATA_SIZE && data[3] == PROTOCOL_PKT_HANDSHAKE) {
         ESP_LOGI(TAG, "Received handshake data block: size=%d, type=0x%02X", size, data[3]);
+        block = PROTOCOL_BLOCK_INIT;
         
     } else {
         ESP_LOGW(TAG, "Unknown data block: size=%d, type=0x%02X", size, data[3]);
     }
 
+    if (block >= 0) {
+        metrics_hist_observe(&protocol_stats.decode_time[block], esp_timer_get_time() - decode_start_us);
+    }
     return ESP_OK;
 }
 
+/**
+ * @brief Block a request asks for
+ */
+static protocol_block_t protocol_block_of(const protocol_cmd_t *cmd) {
+    if (cmd->data[0] == PROTOCOL_PKT_INIT) {
+        return PROTOCOL_BLOCK_INIT;
+    }
+    switch (cmd->data[3]) {
+        case PROTOCOL_DATA_EXTRA:
+            return PROTOCOL_BLOCK_EXTRA;
+        case PROTOCOL_DATA_OPT:
+            return PROTOCOL_BLOCK_OPT;
+        default:
+            return PROTOCOL_BLOCK_MAIN;
+    }
+}
+
+/**
+ * @brief Send one queued command and process its response
+ * @param cmd Command to send
+ * @param is_write Command came from the write queue (counted in latency stats)
+ */
+static void protocol_execute_command(const protocol_cmd_t *cmd, bool is_write) {
+    // Log command being sent
+    ESP_LOGI(TAG, "Sending command: type=0x%02X, size=%d", cmd->data[0], cmd->len);
+
+    // Send command
+    protocol_uart_discard_input();
+    int64_t send_time_us = esp_timer_get_time();
+    esp_err_t ret = protocol_uart_send(cmd->data, cmd->len);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to send command type: 0x%02X", cmd->data[0]);
+        return;
+    }
+
+    if (is_write) {
+        protocol_holding_sync_pending = true;
+        int64_t latency_us = send_time_us - cmd->queued_at_us;
+        protocol_stats.write_count++;
+        protocol_stats.write_latency_last_us = latency_us;
+        protocol_stats.write_latency_total_us += latency_us;
+        if (latency_us > protocol_stats.write_latency_max_us) {
+            protocol_stats.write_latency_max_us = latency_us;
+        }
+        metrics_hist_observe(&protocol_stats.write_wait, latency_us);
+        ESP_LOGI(TAG, "Write command latency: %lld ms", (long long)(latency_us / 1000));
+    } else {
+        protocol_stats.poll_count++;
+    }
+    ESP_LOGI(TAG, "Command sent successfully, waiting for response...");
+
+    // Wait for response
+    ret = protocol_uart_receive_frame(&g_protocol_rx);
+    if (g_protocol_rx.len > 0) {
+        frame_capture_add(FRAME_CAPTURE_RX, ret == ESP_OK ? 0 : FRAME_CAPTURE_FLAG_INCOMPLETE,
+                          g_protocol_rx.data, g_protocol_rx.len);
+    }
+    if (ret == ESP_OK) {
+        metrics_hist_observe(&protocol_stats.response_time[protocol_block_of(cmd)], esp_timer_get_time() - send_time_us);
+        ESP_LOGI(TAG, "Received %d bytes response", g_protocol_rx.len);
+        if (protocol_process_received_data(g_protocol_rx.data, g_protocol_rx.len) != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to process received data");
+        }
+    } else if (ret == ESP_ERR_TIMEOUT) {
+        protocol_stats.rx_timeouts++;
+        ESP_LOGW(TAG, "No response received for command type: 0x%02X (timeout after %d ms)", cmd->data[0], PROTOCOL_READ_TIMEOUT_MS);
+    } else {
+        protocol_stats.rx_incomplete++;
+        ESP_LOGW(TAG, "Bad response for command type: 0x%02X: %s", cmd->data[0], esp_err_to_name(ret));
+    }
+}
+
+/**
+ * @brief Merge a queued write into another write frame
+ *
+ * Main block writes only carry non-zero bytes for the settings they change,
+ * so two frames merge when their non-zero bytes don't overlap. Optional PCB
+ * writes are full state frames built from optional_pcb_query; opt_mask
+ * marks the bits each command sets, and two frames merge when their masks
+ * don't overlap, so a later command for the same field is sent on its own.
+ * @param dst Frame to merge into
+ * @param src Frame to merge
+ * @return true if merged, false if src must be sent on its own
+ */
+static bool protocol_merge_write(protocol_cmd_t *dst, const protocol_cmd_t *src) {
+    if (dst->len != src->len || dst->data[0] != PROTOCOL_PKT_WRITE || src->data[0] != PROTOCOL_PKT_WRITE ||
+        dst->data[3] != src->data[3]) {
+        return false;
+    }
+
+    if (src->data[3] == PROTOCOL_DATA_MAIN && src->len == PROTOCOL_WRITE_SIZE) {
+        for (size_t i = PROTOCOL_WRITE_DATA_START; i < src->len; i++) {
+            if (dst->data[i] != 0 && src->data[i] != 0) {
+                return false;
+            }
+        }
+        for (size_t i = PROTOCOL_WRITE_DATA_START; i < src->len; i++) {
+            dst->data[i] |= src->data[i];
+        }
+        return true;
+    }
+
+    if (src->data[3] == PROTOCOL_DATA_OPT && src->len == PROTOCOL_OPT_WRITE_SIZE) {
+        uint8_t dst_bits = 0;
+        uint8_t src_bits = 0;
+        for (size_t i = PROTOCOL_WRITE_DATA_START; i < src->len; i++) {
+            if (dst->opt_mask[i] & src->opt_mask[i]) {
+                return false;
+            }
+            dst_bits |= dst->opt_mask[i];
+            src_bits |= src->opt_mask[i];
+        }
+        // Frames without a mask don't say what they set
+        if (dst_bits == 0 || src_bits == 0) {
+            return false;
+        }
+        for (size_t i = PROTOCOL_WRITE_DATA_START; i < src->len; i++) {
+            uint8_t mask = src->opt_mask[i];
+            dst->data[i] = (dst->data[i] & ~mask) | (src->data[i] & mask);
+            dst->opt_mask[i] |= mask;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Take the next write command, merged with compatible queued writes
+ * @param cmd Output command
+ * @param timeout Time to wait for the first command
+ * @return true if a command was received
+ */
+static bool protocol_receive_write(protocol_cmd_t *cmd, TickType_t timeout) {
+    if (xQueueReceive(g_protocol_ctx.command_queue, cmd, timeout) != pdTRUE) {
+        return false;
+    }
+    uint32_t depth = (uint32_t)uxQueueMessagesWaiting(g_protocol_ctx.command_queue) + 1;
+    if (depth > protocol_stats.write_queue_max) {
+        protocol_stats.write_queue_max = depth;
+    }
+
+    // The protocol task is the only consumer, so peek + receive is safe.
+    // A short gather window lets the Modbus task finish queueing the
+    // commands of a multi-register write.
+    protocol_cmd_t next;
+    while (xQueuePeek(g_protocol_ctx.command_queue, &next, pdMS_TO_TICKS(PROTOCOL_WRITE_GATHER_MS)) == pdTRUE) {
+        if (!protocol_merge_write(cmd, &next)) {
+            break;
+        }
+        xQueueReceive(g_protocol_ctx.command_queue, &next, 0);
+        protocol_stats.write_merged++;
+        ESP_LOGI(TAG, "Merged queued write into frame type 0x%02X", cmd->data[3]);
+    }
+    return true;
+}
+
+/**
+ * @brief Whether a block is polled at all
+ */
+static bool protocol_poll_enabled(protocol_block_t block) {
+    switch (block) {
+        case PROTOCOL_BLOCK_MAIN:
+            return true;
+        case PROTOCOL_BLOCK_EXTRA:
+            return g_protocol_ctx.extra_data_block_available;
+        case PROTOCOL_BLOCK_OPT:
+            // Check OPT_PCB_AVAILABLE from holding register
+            return mb_holding_registers[MB_HOLDING_OPT_PCB_AVAILABLE - MB_REG_HOLDING_START] != 0;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Queue the periodic data queries (main, extra, opt) that are due
+ * @param now Current tick count
+ * @return Ticks until the next query is due
+ */
+static TickType_t protocol_queue_due_queries(TickType_t now) {
+    // Let the queued round drain first, or a block due every pass starves the others
+    if (uxQueueMessagesWaiting(g_protocol_ctx.poll_queue) > 0) {
+        return 0;
+    }
+
+    uint32_t min_ms, max_ms;
+    protocol_poll_limits(&min_ms, &max_ms);
+
+    TickType_t wait = portMAX_DELAY;
+    for (int block = PROTOCOL_BLOCK_MAIN; block < PROTOCOL_BLOCK_COUNT; block++) {
+        if (!protocol_poll_enabled(block)) {
+            continue;
+        }
+        protocol_poll_slot_t *slot = &protocol_poll[block];
+        TickType_t interval = pdMS_TO_TICKS(protocol_poll_clamp(slot->interval_ms, min_ms, max_ms));
+        if (!slot->started || (int32_t)(now - (slot->last_due + interval)) >= 0) {
+            switch (block) {
+                case PROTOCOL_BLOCK_MAIN: protocol_request_main_data(); break;
+                case PROTOCOL_BLOCK_EXTRA: protocol_request_extra_data(); break;
+                default: protocol_request_opt_data(); break;
+            }
+            // Don't try to catch up on missed periods after a long stall
+            if (!slot->started || (int32_t)(now - (slot->last_due + interval)) >= (int32_t)interval) {
+                slot->last_due = now;
+            } else {
+                slot->last_due += interval;
+            }
+            slot->started = true;
+        }
+        TickType_t left = slot->last_due + interval - now;
+        if ((int32_t)left < 0) {
+            left = 0;
+        }
+        if (left < wait) {
+            wait = left;
+        }
+    }
+    return wait;
+}
+
 /**
  * @brief Protocol communication task
+ *
+ * Sleeps on the command queue until either a command arrives or the next
+ * periodic query is due, so there are no idle wakeups. Write commands are
+ * always served before pending periodic queries. Each block is polled on
+ * its own adaptive schedule (protocol_poll_adapt_*()).
  * @param pvParameters Task parameters
  */
 void protocol_task(void *pvParameters) {
-    TickType_t last_query_time = 0;
-    const TickType_t query_interval = pdMS_TO_TICKS(PROTOCOL_QUERY_INTERVAL_MS);
-
     ESP_LOGI(TAG, "Protocol task started");
     
     // Send initial query
     protocol_send_initial_query();
     ESP_LOGI(TAG, "Initial query sent");
 
+    // First polls right after the initial query has been answered
+    uint32_t min_ms, max_ms;
+    protocol_poll_limits(&min_ms, &max_ms);
+    for (int block = PROTOCOL_BLOCK_MAIN; block < PROTOCOL_BLOCK_COUNT; block++) {
+        protocol_poll_set_interval(block, protocol_poll_clamp(PROTOCOL_QUERY_INTERVAL_MS, min_ms, max_ms));
+    }
+
     while (1) {
-        // Process commands from queue
+        // Periodic data queries
+        TickType_t wait = protocol_queue_due_queries(xTaskGetTickCount());
+
         protocol_cmd_t cmd;
-        if (xQueueReceive(g_protocol_ctx.command_queue, &cmd, 0) == pdTRUE) {
-            
-            // Log command being sent
-            ESP_LOGI(TAG, "Sending command: type=0x%02X, size=%d", cmd.data[0], cmd.len);
-            
-            // Send command
-            esp_err_t ret = protocol_uart_send(cmd.data, cmd.len);
-            if (ret == ESP_OK) {
-                ESP_LOGI(TAG, "Command sent successfully, waiting for response...");
-                
-                // Wait for response
-                int bytes_received = protocol_uart_receive(g_protocol_rx.data, sizeof(g_protocol_rx.data));
-                if (bytes_received > 0) {
-                    ESP_LOGI(TAG, "Received %d bytes response", bytes_received);
-                    g_protocol_rx.len = (size_t)bytes_received;
-                    if(protocol_process_received_data(g_protocol_rx.data, bytes_received) != ESP_OK) {
-                        ESP_LOGE(TAG, "Failed to process received data");
-                    }
-                } else {
-                        ESP_LOGW(TAG, "No response received for command type: 0x%02X (timeout after %d ms)", cmd.data[0], PROTOCOL_READ_TIMEOUT_MS);
-                }
-            } else {
-                ESP_LOGE(TAG, "Failed to send command type: 0x%02X", cmd.data[0]);
-            }
-        }
 
-        // Periodic data queries
-        TickType_t current_time = xTaskGetTickCount();
-        if (current_time - last_query_time >= query_interval) {
-            last_query_time = current_time;
-            
-            // Send periodic queries
-            protocol_request_main_data();
-            if(g_protocol_ctx.extra_data_block_available) protocol_request_extra_data();
-            // Check OPT_PCB_AVAILABLE from holding register
-            if(mb_holding_registers[MB_HOLDING_OPT_PCB_AVAILABLE - MB_REG_HOLDING_START] != 0) {
-                protocol_request_opt_data();
-            }
+        // Writes first, then one pending poll, then re-check writes
+        if (protocol_receive_write(&cmd, 0)) {
+            protocol_execute_command(&cmd, true);
+            continue;
+        }
+        if (xQueueReceive(g_protocol_ctx.poll_queue, &cmd, 0) == pdTRUE) {
+            protocol_execute_command(&cmd, false);
+            continue;
         }
 
-        vTaskDelay(pdMS_TO_TICKS(10)); // Small delay to prevent busy waiting
+        // Idle: block until a write arrives or the next query is due
+        if (protocol_receive_write(&cmd, wait)) {
+            protocol_execute_command(&cmd, true);
+        }
     }
 
     ESP_LOGE(TAG, "Protocol task stopped");
@@ -331,9 +891,9 @@ esp_err_t protocol_init(void) {
         .source_clk = UART_SCLK_DEFAULT
     };
 
-    // Install UART driver
-    ret = uart_driver_install(PROTOCOL_UART_NUM, PROTOCOL_MAX_DATA_SIZE, 
-        PROTOCOL_MAX_DATA_SIZE, 0, NULL, 0); 
+    // Install UART driver with an event queue for the frame assembler
+    ret = uart_driver_install(PROTOCOL_UART_NUM, PROTOCOL_UART_RX_BUF_SIZE,
+        PROTOCOL_MAX_DATA_SIZE, PROTOCOL_UART_EVENT_QUEUE_SIZE, &g_protocol_ctx.uart_event_queue, 0);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to install UART driver: %s", esp_err_to_name(ret));
         return ret;
@@ -368,6 +928,12 @@ esp_err_t protocol_init(void) {
         return ESP_ERR_NO_MEM;
     }
 
+    g_protocol_ctx.poll_queue = xQueueCreate(PROTOCOL_POLL_QUEUE_SIZE, sizeof(protocol_cmd_t));
+    if (g_protocol_ctx.poll_queue == NULL) {
+        ESP_LOGE(TAG, "Failed to create poll queue");
+        return ESP_ERR_NO_MEM;
+    }
+
     ESP_LOGI(TAG, "Heat pump protocol initialized successfully");
     return ESP_OK;
 }
@@ -400,8 +966,13 @@ esp_err_t protocol_send_command(const protocol_cmd_t *cmd) {
     if (cmd == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
+
+    protocol_cmd_t queued = *cmd;
+    if (queued.queued_at_us == 0) {
+        queued.queued_at_us = esp_timer_get_time();
+    }
     
-    if (xQueueSend(g_protocol_ctx.command_queue, cmd, pdMS_TO_TICKS(100)) != pdTRUE) {
+    if (xQueueSend(g_protocol_ctx.command_queue, &queued, pdMS_TO_TICKS(100)) != pdTRUE) {
         ESP_LOGW(TAG, "Failed to send command to queue");
         return ESP_ERR_TIMEOUT;
     }
@@ -409,6 +980,29 @@ esp_err_t protocol_send_command(const protocol_cmd_t *cmd) {
     return ESP_OK;
 }
 
+/**
+ * @brief Queue a periodic query behind pending write commands
+ * @param cmd Query to send
+ * @return ESP_OK on success
+ */
+static esp_err_t protocol_send_poll(const protocol_cmd_t *cmd) {
+    // Called from the protocol task itself, so never block here
+    if (xQueueSend(g_protocol_ctx.poll_queue, cmd, 0) != pdTRUE) {
+        ESP_LOGW(TAG, "Poll queue full, query skipped");
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Get protocol statistics
+ */
+void protocol_get_stats(protocol_stats_t *stats) {
+    if (stats != NULL) {
+        *stats = protocol_stats;
+    }
+}
+
 /**
  * @brief Send initial query to heat pump
  * @return ESP_OK on success
@@ -421,7 +1015,7 @@ esp_err_t protocol_send_initial_query(void) {
     memcpy(cmd.data, initial_query, sizeof(initial_query));
     
     ESP_LOGD(TAG, "Sending initial query");
-    return protocol_send_command(&cmd);
+    return protocol_send_poll(&cmd);
 }
 
 /**
@@ -436,7 +1030,7 @@ esp_err_t protocol_request_main_data(void) {
     memcpy(cmd.data, panasonic_query, sizeof(panasonic_query));
     
     ESP_LOGD(TAG, "Requesting main data");
-    return protocol_send_command(&cmd);
+    return protocol_send_poll(&cmd);
 }
 
 /**
@@ -453,7 +1047,7 @@ esp_err_t protocol_request_extra_data(void)
     cmd.data[3] = PROTOCOL_DATA_EXTRA; // Set data type to extra
     
     ESP_LOGD(TAG, "Requesting extra data");
-    return protocol_send_command(&cmd);
+    return protocol_send_poll(&cmd);
 }
 
 /**
@@ -469,5 +1063,5 @@ esp_err_t protocol_request_opt_data(void)
     memcpy(cmd.data, optional_pcb_query, sizeof(optional_pcb_query));
     
     ESP_LOGD(TAG, "Requesting optional data");
-    return protocol_send_command(&cmd);
+    return protocol_send_poll(&cmd);
 }
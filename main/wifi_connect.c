@@ -13,51 +13,126 @@
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_netif.h"
+#include "esp_timer.h"
+#include "esp_random.h"
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/event_groups.h"
 #include <string.h>
 #include <stdio.h>
 #include "project_config.h"
 
 static const char *TAG = "WIFI_CONNECT";
 
-// WiFi event group bits
-#define WIFI_CONNECTED_BIT BIT0
-#define WIFI_FAIL_BIT      BIT1
-
 // WiFi credentials
 static wifi_credentials_t wifi_credentials = {0};
 static bool wifi_initialized = false;
 static bool wifi_connected = false;
-static EventGroupHandle_t s_wifi_event_group = NULL;
 static esp_netif_t *sta_netif = NULL;
 
+// Connection state machine, driven from the event loop and the retry timer
+static volatile wifi_connect_state_t wifi_state = WIFI_CONNECT_STATE_IDLE;
+static wifi_connect_state_cb_t wifi_state_cb = NULL;
+static esp_timer_handle_t wifi_retry_timer = NULL;
+static uint32_t wifi_retry_attempts = 0;    // Failed attempts since the last IP
+
 // NVS keys
 #define WIFI_NVS_NAMESPACE "wifi"
 #define WIFI_NVS_KEY_SSID "ssid"
 #define WIFI_NVS_KEY_PASSWORD "password"
 
+/**
+ * @brief Enter a state and tell the registered listener
+ */
+static void wifi_set_state(wifi_connect_state_t state) {
+    wifi_state = state;
+    wifi_connect_state_cb_t cb = wifi_state_cb;
+    if (cb != NULL) {
+        cb(state);
+    }
+}
+
+/**
+ * @brief Delay before the next connection attempt
+ * Doubles with each failed attempt up to CONFIG_WIFI_RETRY_MAX_MS, with up
+ * to 25% random jitter so gateways behind the same AP don't retry in step
+ */
+static uint32_t wifi_retry_delay_ms(uint32_t attempts) {
+    uint32_t delay = CONFIG_WIFI_RETRY_MAX_MS;
+    if (attempts < 16 && ((uint32_t)CONFIG_WIFI_RETRY_MIN_MS << attempts) < CONFIG_WIFI_RETRY_MAX_MS) {
+        delay = (uint32_t)CONFIG_WIFI_RETRY_MIN_MS << attempts;
+    }
+    return delay + esp_random() % (delay / 4 + 1);
+}
+
+/**
+ * @brief Enter BACKOFF and arm the retry timer for the next attempt
+ */
+static void wifi_schedule_retry(void) {
+    uint32_t delay_ms = wifi_retry_delay_ms(wifi_retry_attempts);
+    wifi_retry_attempts++;
+    ESP_LOGI(TAG, "Retrying in %u ms", (unsigned)delay_ms);
+    wifi_set_state(WIFI_CONNECT_STATE_BACKOFF);
+    esp_timer_stop(wifi_retry_timer);
+    esp_timer_start_once(wifi_retry_timer, (uint64_t)delay_ms * 1000);
+}
+
+/**
+ * @brief Start a connection attempt
+ * No DISCONNECTED event follows a rejected attempt, so back off here
+ */
+static void wifi_try_connect(void) {
+    wifi_set_state(WIFI_CONNECT_STATE_CONNECTING);
+    esp_err_t ret = esp_wifi_connect();
+    if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "esp_wifi_connect failed: %s", esp_err_to_name(ret));
+        wifi_schedule_retry();
+    }
+}
+
+/**
+ * @brief Retry timer callback - next connection attempt after a backoff
+ */
+static void wifi_retry_timer_cb(void *arg) {
+    if (wifi_state != WIFI_CONNECT_STATE_BACKOFF) {
+        return;
+    }
+    ESP_LOGI(TAG, "Reconnecting (attempt %u)", (unsigned)(wifi_retry_attempts + 1));
+    wifi_try_connect();
+}
+
 /**
  * @brief WiFi event handler
+ *
+ * IDLE -> CONNECTING on station start, CONNECTING -> CONNECTED on IP,
+ * any -> BACKOFF on disconnect, BACKOFF -> CONNECTING when the retry
+ * timer fires.
  */
 static void wifi_event_handler(void* arg, esp_event_base_t event_base,
                                 int32_t event_id, void* event_data) {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
-        esp_wifi_connect();
+        wifi_retry_attempts = 0;
         ESP_LOGI(TAG, "WiFi station started, connecting...");
+        wifi_try_connect();
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        esp_wifi_connect();
         wifi_connected = false;
-        ESP_LOGI(TAG, "WiFi disconnected, retrying...");
-        xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+        if (wifi_state == WIFI_CONNECT_STATE_IDLE) {
+            return; // Stopped on purpose
+        }
+        ESP_LOGI(TAG, "WiFi disconnected");
+        wifi_schedule_retry();
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
         ESP_LOGI(TAG, "Got IP:" IPSTR, IP2STR(&event->ip_info.ip));
         wifi_connected = true;
-        xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+        wifi_retry_attempts = 0;
+        wifi_set_state(WIFI_CONNECT_STATE_CONNECTED);
+    } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_LOST_IP) {
+        // Still associated, DHCP will assign an address again
+        ESP_LOGW(TAG, "Lost IP address");
+        wifi_connected = false;
+        wifi_set_state(WIFI_CONNECT_STATE_CONNECTING);
     }
 }
 
@@ -99,13 +174,6 @@ esp_err_t wifi_connect_init(void) {
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
 
-    // Create event group
-    s_wifi_event_group = xEventGroupCreate();
-    if (s_wifi_event_group == NULL) {
-        ESP_LOGE(TAG, "Failed to create event group");
-        return ESP_FAIL;
-    }
-
     // Register event handlers
     ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT,
                                                         ESP_EVENT_ANY_ID,
@@ -117,6 +185,18 @@ esp_err_t wifi_connect_init(void) {
                                                         &wifi_event_handler,
                                                         NULL,
                                                         NULL));
+    ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT,
+                                                        IP_EVENT_STA_LOST_IP,
+                                                        &wifi_event_handler,
+                                                        NULL,
+                                                        NULL));
+
+    // One-shot timer for reconnect attempts after a backoff
+    const esp_timer_create_args_t retry_timer_args = {
+        .callback = wifi_retry_timer_cb,
+        .name = "wifi_retry",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&retry_timer_args, &wifi_retry_timer));
 
     // Set WiFi mode to station
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
@@ -165,22 +245,9 @@ esp_err_t wifi_connect_start(void) {
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_cfg));
     ESP_ERROR_CHECK(esp_wifi_start());
 
-    // Wait for connection (timeout 30 seconds)
-    EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group,
-                                            WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
-                                            pdFALSE,
-                                            pdFALSE,
-                                            pdMS_TO_TICKS(CONFIG_WIFI_RECONNECT));
-
-    if (bits & WIFI_CONNECTED_BIT) {
-        ESP_LOGI(TAG, "WiFi connected successfully");
-        wifi_connected = true;
-        return ESP_OK;
-    } else {
-        ESP_LOGE(TAG, "WiFi connection failed (timeout)");
-        wifi_connected = false;
-        return ESP_ERR_TIMEOUT;
-    }
+    // Association and DHCP continue in the background; IP_EVENT_STA_GOT_IP
+    // announces the connection
+    return ESP_OK;
 }
 
 /**
@@ -191,6 +258,9 @@ esp_err_t wifi_connect_stop(void) {
         return ESP_OK;
     }
 
+    // IDLE first, so the disconnect event of the stop schedules no retry
+    wifi_set_state(WIFI_CONNECT_STATE_IDLE);
+    esp_timer_stop(wifi_retry_timer);
     esp_err_t ret = esp_wifi_stop();
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to stop WiFi: %s", esp_err_to_name(ret));
@@ -208,6 +278,20 @@ bool wifi_connect_is_connected(void) {
     return wifi_connected;
 }
 
+/**
+ * @brief Get the connection state
+ */
+wifi_connect_state_t wifi_connect_get_state(void) {
+    return wifi_state;
+}
+
+/**
+ * @brief Register the connection state listener
+ */
+void wifi_connect_set_state_callback(wifi_connect_state_cb_t cb) {
+    wifi_state_cb = cb;
+}
+
 /**
  * @brief Get current IP address
  */